@@ -0,0 +1,120 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include "BanList.h"
+
+namespace
+{
+	BanAddress maskAddress(const BanAddress& address, uint8_t length)
+	{
+		BanAddress result = address;
+		if (length < 64)
+		{
+			result.high = length == 0 ? 0 : result.high & (~uint64_t(0) << (64 - length));
+			result.low = 0;
+		}
+		else if (length < 128)
+		{
+			result.low = length == 64 ? 0 : result.low & (~uint64_t(0) << (128 - length));
+		}
+		return result;
+	}
+
+	uint8_t sharedPrefixLength(const BanAddress& a, const BanAddress& b)
+	{
+		if (const uint64_t diff = a.high ^ b.high)
+		{
+			return static_cast<uint8_t>(std::countl_zero(diff));
+		}
+		const uint64_t diff = a.low ^ b.low;
+		return static_cast<uint8_t>(diff ? 64 + std::countl_zero(diff) : 128);
+	}
+} // namespace
+
+// Build a trie of ruleCount random rules and time lookups against a linear longest-prefix scan
+std::string benchmarkBanList(size_t ruleCount)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Mostly IPv4 ranges from /16 to single hosts, some IPv6 /32 to /64, every tenth rule an allow exception
+	std::mt19937_64 random(42);
+	std::vector<BanRule> rules(ruleCount);
+	for (size_t i = 0; i < ruleCount; i++)
+	{
+		BanRule& rule = rules[i];
+		if (i % 5 == 4)
+		{
+			rule.network.high = random();
+			rule.prefixLength = static_cast<uint8_t>(32 + random() % 33);
+		}
+		else
+		{
+			rule.network.low = (uint64_t(0xFFFF) << 32) | static_cast<uint32_t>(random());
+			rule.prefixLength = static_cast<uint8_t>(96 + 16 + random() % 17);
+		}
+		rule.network = maskAddress(rule.network, rule.prefixLength);
+		rule.allow = i % 10 == 9;
+	}
+
+	auto start = Clock::now();
+	BanTrie trie;
+	trie.build(rules);
+	const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	// Half the probes land inside a rule, the rest are random IPv4 addresses
+	const size_t probeCount = 1000000;
+	std::vector<BanAddress> probes(probeCount);
+	for (size_t i = 0; i < probeCount; i++)
+	{
+		if (i % 2 == 0 && ruleCount > 0)
+		{
+			const BanRule& rule = rules[random() % ruleCount];
+			probes[i] = rule.network;
+			probes[i].low |= rule.prefixLength < 128 ? random() & (~uint64_t(0) >> (rule.prefixLength < 64 ? 0 : rule.prefixLength - 64)) : 0;
+		}
+		else
+		{
+			probes[i].low = (uint64_t(0xFFFF) << 32) | static_cast<uint32_t>(random());
+		}
+	}
+
+	start = Clock::now();
+	size_t banned = 0;
+	for (const auto& probe: probes)
+	{
+		banned += trie.match(probe) == BanTrie::Action::Ban ? 1 : 0;
+	}
+	const double trieNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probeCount;
+
+	// Linear longest-prefix scan over the rule list for a sample of the same probes
+	const size_t scanCount = (std::min)(probeCount, size_t(2000));
+	size_t scanMismatches = 0;
+	start = Clock::now();
+	for (size_t i = 0; i < scanCount; i++)
+	{
+		int bestLength = -1;
+		bool bestAllow = false;
+		for (const auto& rule: rules)
+		{
+			if (rule.prefixLength > bestLength && sharedPrefixLength(probes[i], rule.network) >= rule.prefixLength)
+			{
+				bestLength = rule.prefixLength;
+				bestAllow = rule.allow;
+			}
+		}
+		const bool scanBanned = bestLength >= 0 && !bestAllow;
+		scanMismatches += scanBanned != (trie.match(probes[i]) == BanTrie::Action::Ban) ? 1 : 0;
+	}
+	const double scanNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / scanCount;
+
+	std::ostringstream result;
+	result.setf(std::ios::fixed);
+	result.precision(1);
+	result << ruleCount << " rules: trie build " << buildMs << " ms (" << trie.getNodeCount() << " nodes), lookup " << trieNs << " ns, linear scan " << scanNs / 1000.0 << " us; " << banned << " of " << probeCount
+	       << " probes banned, " << scanMismatches << " mismatches against the scan";
+	return result.str();
+}
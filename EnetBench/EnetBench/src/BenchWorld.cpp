@@ -0,0 +1,18 @@
+#include "BenchWorld.h"
+
+#include <cmath>
+
+void populateBenchmarkWorld(size_t playerCount, std::unordered_map<uint32_t, Player>& world, SpatialGrid& grid)
+{
+	const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(playerCount))));
+	for (size_t i = 0; i < playerCount; ++i)
+	{
+		Player player{};
+		player.id = static_cast<uint32_t>(1000 + i);
+		player.name = "Player" + std::to_string(i);
+		player.position = Position{ (i % columns) * 6.0f - 100.0f, 0.0f, (i / columns) * 6.0f - 100.0f };
+		player.isAuthenticated = true;
+		grid.addEntity(player.id, player.position);
+		world.emplace(player.id, std::move(player));
+	}
+}
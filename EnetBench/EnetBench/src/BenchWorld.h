@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "SpatialGrid.h"
+#include "Structs.h"
+
+// Authenticated players on a square lattice 6 units apart, for the tick benchmarks
+void populateBenchmarkWorld(size_t playerCount, std::unordered_map<uint32_t, Player>& world, SpatialGrid& grid);
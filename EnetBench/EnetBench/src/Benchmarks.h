@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Each benchmark runs on synthetic data and returns its report, one line per result
+std::string benchmarkWorldStateEncoding(size_t playerCount, size_t iterations);
+std::string benchmarkClockSync(size_t exchanges);
+std::string benchmarkEncryption(size_t playerCount);
+std::string benchmarkPlayerSnapshots(size_t playerCount, size_t frames);
+std::string benchmarkPlayersPanel(size_t playerCount, size_t frames);
+std::string benchmarkOutboundQueue(size_t messageCount);
+std::string benchmarkBanList(size_t ruleCount);
+std::string benchmarkListeners(size_t maxListeners, uint32_t durationMs);
+std::string benchmarkPooledAllocator(size_t playerCount);
+std::string benchmarkTickAllocations(size_t playerCount);
+std::string benchmarkParallelFor(size_t playerCount);
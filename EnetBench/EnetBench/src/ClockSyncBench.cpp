@@ -0,0 +1,54 @@
+#include "Benchmarks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "ClockSync.h"
+
+// Drive the client clock sync estimator over a simulated loopback link with a known offset and jittery, asymmetric delays
+std::string benchmarkClockSync(size_t exchanges)
+{
+	const int64_t trueOffsetUs = 1234567; // Server clock ahead of the client
+	const double baseDelayUs = 20000.0;
+
+	std::mt19937 rng(1234);
+	std::exponential_distribution<double> queueDelay(1.0 / 5000.0); // 5ms mean queueing per direction
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<uint64_t> processing(50, 300);
+
+	GameProtocol::ClockSyncEstimator estimator;
+	uint64_t clientTime = 10000000;
+	size_t convergedAt = 0;
+	double trueRttSum = 0;
+
+	for (size_t i = 1; i <= exchanges; ++i)
+	{
+		// One direction occasionally sees a large spike
+		double forwardUs = baseDelayUs + queueDelay(rng) + (unit(rng) < 0.1 ? 80000.0 : 0.0);
+		double backwardUs = baseDelayUs + queueDelay(rng);
+
+		const uint64_t t0 = clientTime;
+		const uint64_t t1 = static_cast<uint64_t>(static_cast<int64_t>(t0) + trueOffsetUs + static_cast<int64_t>(forwardUs));
+		const uint64_t t2 = t1 + processing(rng);
+		const uint64_t t3 = static_cast<uint64_t>(static_cast<int64_t>(t2) - trueOffsetUs + static_cast<int64_t>(backwardUs));
+		estimator.addSample(t0, t1, t2, t3);
+		trueRttSum += forwardUs + backwardUs;
+
+		// Converged once the error stays under 2ms from here on
+		const int64_t errorUs = std::llabs(estimator.getOffsetUs() - trueOffsetUs);
+		if (errorUs >= 2000)
+			convergedAt = 0;
+		else if (convergedAt == 0)
+			convergedAt = i;
+
+		clientTime = t3 + 500000;
+	}
+
+	char line[160];
+	std::string report = std::to_string(exchanges) + " exchanges, 20ms +/- jitter, 10% spikes\n";
+	snprintf(line, sizeof(line), "Offset error: %lld us, converged (<2ms) after %zu exchanges\n", static_cast<long long>(estimator.getOffsetUs() - trueOffsetUs), convergedAt);
+	report += line;
+	snprintf(line, sizeof(line), "RTT: %.2f ms estimated, %.2f ms mean actual, jitter %.2f ms", estimator.getRttUs() / 1000.0, trueRttSum / exchanges / 1000.0, estimator.getJitterUs() / 1000.0);
+	report += line;
+	return report;
+}
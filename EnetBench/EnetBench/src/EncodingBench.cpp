@@ -0,0 +1,63 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <cstdio>
+#include "PacketTypes.h"
+
+// Compare legacy and bit-packed WorldState encodings on a synthetic snapshot
+std::string benchmarkWorldStateEncoding(size_t playerCount, size_t iterations)
+{
+	GameProtocol::WorldStatePacket packet;
+	packet.players.reserve(playerCount);
+	for (size_t i = 0; i < playerCount; ++i)
+	{
+		GameProtocol::WorldStatePacket::PlayerInfo info;
+		info.id = static_cast<uint32_t>(1000 + i * 3);
+		info.name = "Player" + std::to_string(i);
+		info.position = Position{ (i % 20) * 9.5f - 95.0f, 0.0f, (i / 20) * 12.25f - 60.0f };
+		packet.players.push_back(info);
+	}
+
+	std::string report;
+	auto measure = [&](bool compact, size_t& bytes, double& encodeUs, double& decodeUs)
+	{
+		packet.compact = compact;
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<uint8_t> data;
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			data = packet.serialize();
+		}
+		auto mid = std::chrono::steady_clock::now();
+		size_t decodedPlayers = 0;
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			auto decoded = GameProtocol::deserializePacket(data);
+			decodedPlayers += static_cast<GameProtocol::WorldStatePacket*>(decoded.get())->players.size();
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		bytes = data.size();
+		encodeUs = std::chrono::duration<double, std::micro>(mid - start).count() / iterations;
+		decodeUs = std::chrono::duration<double, std::micro>(end - mid).count() / iterations;
+
+		if (decodedPlayers != playerCount * iterations)
+		{
+			report += "Warning: WorldState decode mismatch, " + std::to_string(decodedPlayers) + " players decoded\n";
+		}
+	};
+
+	size_t legacyBytes = 0, compactBytes = 0;
+	double legacyEncode = 0, legacyDecode = 0, compactEncode = 0, compactDecode = 0;
+	measure(false, legacyBytes, legacyEncode, legacyDecode);
+	measure(true, compactBytes, compactEncode, compactDecode);
+
+	char line[160];
+	report += std::to_string(playerCount) + " players, " + std::to_string(iterations) + " runs\n";
+	snprintf(line, sizeof(line), "Legacy:  %zu bytes, encode %.2f us, decode %.2f us\n", legacyBytes, legacyEncode, legacyDecode);
+	report += line;
+	snprintf(line, sizeof(line), "Compact: %zu bytes, encode %.2f us, decode %.2f us (%.1f%% of legacy size)", compactBytes, compactEncode, compactDecode, 100.0 * compactBytes / legacyBytes);
+	report += line;
+	return report;
+}
@@ -0,0 +1,101 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "Constants.h"
+#include "PacketTypes.h"
+#include "SecureChannel.h"
+
+// Estimate the CPU cost of encrypting a full server: every player receives world state for 100 visible players
+// each broadcast tick and sends 20 position updates per second, using the default server config
+std::string benchmarkEncryption(size_t playerCount)
+{
+	if (!GameProtocol::SecureChannel::isAvailable())
+	{
+		return "Secure channels are not available on this platform";
+	}
+
+	GameProtocol::SecureChannel client(GameProtocol::SecureChannel::Role::Client);
+	GameProtocol::SecureChannel server(GameProtocol::SecureChannel::Role::Server);
+
+	auto handshakeStart = std::chrono::steady_clock::now();
+	if (!client.generateKeyPair() || !server.generateKeyPair() || !server.establish(client.getPublicKey()) || !client.establish(server.getPublicKey()))
+	{
+		return "Secure channel handshake failed";
+	}
+	auto handshakeEnd = std::chrono::steady_clock::now();
+
+	// One tick of world state for a single player
+	std::vector<GameProtocol::WorldStatePacket::PlayerInfo> visible;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		GameProtocol::WorldStatePacket::PlayerInfo info;
+		info.id = static_cast<uint32_t>(1000 + i * 3);
+		info.name = "Player" + std::to_string(i);
+		info.position = Position{ (i % 20) * 9.5f - 95.0f, 0.0f, (i / 20) * 12.25f - 60.0f };
+		visible.push_back(info);
+	}
+	std::vector<std::vector<uint8_t>> worldState;
+	size_t worldStateBytes = 0;
+	for (auto& chunk: GameProtocol::WorldStatePacket::splitIntoChunks(visible, WORLD_STATE_CHUNK_BYTES, COMPACT_WORLD_STATE, 1))
+	{
+		worldState.push_back(chunk.serialize());
+		worldStateBytes += worldState.back().size();
+	}
+
+	const size_t ticks = 200;
+	std::vector<uint8_t> sealed;
+	std::vector<uint8_t> opened;
+
+	auto sealStart = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < ticks; ++i)
+	{
+		for (const auto& data: worldState)
+		{
+			server.seal(data, sealed, GameProtocol::Channel::Realtime, false);
+		}
+	}
+	auto sealEnd = std::chrono::steady_clock::now();
+
+	// Each sealed position update can only be opened once, so seal them all up front
+	const size_t updates = 5000;
+	const auto position = GameProtocol::DeltaPositionUpdatePacket(Position{ 12.5f, 0.0f, -40.25f }).serialize();
+	std::vector<std::vector<uint8_t>> incoming(updates);
+	for (auto& packet: incoming)
+	{
+		client.seal(position, packet, GameProtocol::Channel::Realtime, false);
+	}
+
+	auto openStart = std::chrono::steady_clock::now();
+	size_t openFailures = 0;
+	for (const auto& packet: incoming)
+	{
+		if (!server.open(packet, opened))
+			openFailures++;
+	}
+	auto openEnd = std::chrono::steady_clock::now();
+
+	const double tickSealUs = std::chrono::duration<double, std::micro>(sealEnd - sealStart).count() / ticks;
+	const double openUs = std::chrono::duration<double, std::micro>(openEnd - openStart).count() / updates;
+	const double ticksPerSecond = 1000.0 / (std::max)(BROADCAST_RATE_MS, 1);
+	const double outboundUsPerSecond = tickSealUs * ticksPerSecond * playerCount;
+	const double inboundUsPerSecond = openUs * 20.0 * playerCount;
+
+	char line[192];
+	std::string report = std::to_string(playerCount) + " players, 100 visible each\n";
+	snprintf(line, sizeof(line), "Handshake: %.1f us (both sides)\n", std::chrono::duration<double, std::micro>(handshakeEnd - handshakeStart).count());
+	report += line;
+	snprintf(line, sizeof(line), "World state: %zu chunks, %zu bytes, seal %.2f us per player per tick (+%zu bytes)\n", worldState.size(), worldStateBytes, tickSealUs,
+	        worldState.size() * (sizeof(GameProtocol::PacketHeader) + GameProtocol::SECURE_TAG_BYTES));
+	report += line;
+	snprintf(line, sizeof(line), "Position update: open %.2f us\n", openUs);
+	report += line;
+	snprintf(line, sizeof(line), "Projected load: %.1f%% of one core (%.1f%% sealing, %.1f%% opening)", (outboundUsPerSecond + inboundUsPerSecond) / 10000.0, outboundUsPerSecond / 10000.0, inboundUsPerSecond / 10000.0);
+	report += line;
+	if (openFailures > 0)
+	{
+		report += "\nWarning: " + std::to_string(openFailures) + " packets failed to open";
+	}
+	return report;
+}
@@ -0,0 +1,86 @@
+#include "HeapCounter.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#	include <malloc.h>
+#endif
+
+namespace
+{
+	// Plain integer so operator new can touch it before any thread_local constructors run
+	thread_local uint64_t heapAllocations = 0;
+
+	void* allocateCounted(size_t size, size_t alignment)
+	{
+		heapAllocations++;
+		if (size == 0)
+			size = 1;
+
+		while (true)
+		{
+#ifdef _WIN32
+			void* memory = alignment > alignof(std::max_align_t) ? _aligned_malloc(size, alignment) : std::malloc(size);
+#else
+			void* memory = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : std::malloc(size);
+#endif
+			if (memory)
+				return memory;
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void freeCounted(void* memory, size_t alignment)
+	{
+#ifdef _WIN32
+		if (alignment > alignof(std::max_align_t))
+		{
+			_aligned_free(memory);
+			return;
+		}
+#endif
+		std::free(memory);
+	}
+} // namespace
+
+// Counting replacements for the global allocation functions; the array and nothrow forms forward to these
+void* operator new(size_t size)
+{
+	return allocateCounted(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return allocateCounted(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+	freeCounted(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	freeCounted(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+	freeCounted(memory, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept
+{
+	freeCounted(memory, static_cast<size_t>(alignment));
+}
+
+uint64_t heapAllocationsOnThisThread()
+{
+	return heapAllocations;
+}
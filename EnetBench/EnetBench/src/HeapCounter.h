@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Operator new calls made by the calling thread so far; HeapCounter.cpp replaces the global
+// operator new/delete of EnetBench with versions that count them
+uint64_t heapAllocationsOnThisThread();
@@ -0,0 +1,190 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "ListenerSocket.h"
+#include "PacketManager.h"
+
+// Loopback ingest: clients flood 1, 2, 4... listeners up to maxListeners for durationMs each
+std::string benchmarkListeners(size_t maxListeners, uint32_t durationMs)
+{
+	using Clock = std::chrono::steady_clock;
+
+	if (enet_initialize() != 0)
+	{
+		return "Failed to initialize ENet";
+	}
+
+	// Enough client sockets that the port hash spreads them over every listener
+	const size_t clientCount = 32;
+	const size_t senderThreads = 4;
+	const size_t burst = 32;
+	const std::vector<uint8_t> payload = GameProtocol::DeltaPositionUpdatePacket(Position{ 1.0f, 2.0f, 3.0f }).serialize();
+
+	std::ostringstream result;
+	result << "Loopback ingest, " << clientCount << " clients, " << payload.size() << "-byte position updates:";
+	if (!ListenerSocket::canShare())
+	{
+		result << " (SO_REUSEPORT unavailable, single listener only)";
+		maxListeners = 1;
+	}
+
+	for (size_t listenerCount = 1; listenerCount <= (std::max)(maxListeners, size_t(1)); listenerCount *= 2)
+	{
+		ENetAddress address;
+		enet_address_set_host(&address, "127.0.0.1");
+		address.port = 0;
+
+		// The first listener picks a free port, the rest join it
+		std::vector<ENetHost*> listeners;
+		for (size_t i = 0; i < listenerCount; i++)
+		{
+			ENetHost* host = ListenerSocket::createHost(address, clientCount, 1, listenerCount > 1);
+			if (host == nullptr)
+			{
+				break;
+			}
+			address.port = host->address.port;
+			listeners.push_back(host);
+		}
+
+		std::vector<ENetHost*> clients;
+		std::vector<ENetPeer*> peers;
+		for (size_t i = 0; i < clientCount && listeners.size() == listenerCount; i++)
+		{
+			ENetHost* client = enet_host_create(nullptr, 1, 1, 0, 0);
+			if (client == nullptr)
+			{
+				break;
+			}
+			clients.push_back(client);
+			peers.push_back(enet_host_connect(client, &address, 1, 0));
+		}
+
+		if (listeners.size() != listenerCount || clients.size() != clientCount)
+		{
+			result << "\n  " << listenerCount << " listeners: could not open sockets";
+			for (auto* host: clients)
+				enet_host_destroy(host);
+			for (auto* host: listeners)
+				enet_host_destroy(host);
+			break;
+		}
+
+		// Each listener thread receives and decodes, as the network thread does
+		std::atomic<bool> stop{ false };
+		std::atomic<bool> measuring{ false };
+		std::atomic<size_t> connected{ 0 };
+		std::unique_ptr<std::atomic<uint64_t>[]> received(new std::atomic<uint64_t>[listenerCount]);
+		std::vector<std::thread> listenerThreads;
+		for (size_t i = 0; i < listenerCount; i++)
+		{
+			received[i] = 0;
+			listenerThreads.emplace_back(
+			        [&, i]()
+			        {
+				        PacketManager decoder;
+				        ENetEvent event;
+				        while (!stop)
+				        {
+					        while (enet_host_service(listeners[i], &event, 1) > 0)
+					        {
+						        if (event.type == ENET_EVENT_TYPE_CONNECT)
+						        {
+							        connected++;
+						        }
+						        else if (event.type == ENET_EVENT_TYPE_RECEIVE)
+						        {
+							        if (measuring && decoder.receivePacket(event.packet))
+							        {
+								        received[i]++;
+							        }
+							        enet_packet_destroy(event.packet);
+						        }
+					        }
+				        }
+			        });
+		}
+
+		// Finish the handshakes before timing anything
+		const auto connectDeadline = Clock::now() + std::chrono::seconds(2);
+		while (connected < clientCount && Clock::now() < connectDeadline)
+		{
+			ENetEvent event;
+			for (auto* client: clients)
+			{
+				enet_host_service(client, &event, 0);
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		std::atomic<uint64_t> sent{ 0 };
+		std::vector<std::thread> senders;
+		measuring = true;
+		const auto start = Clock::now();
+		const auto deadline = start + std::chrono::milliseconds(durationMs);
+		for (size_t s = 0; s < senderThreads; s++)
+		{
+			senders.emplace_back(
+			        [&, s]()
+			        {
+				        ENetEvent event;
+				        uint64_t queued = 0;
+				        while (Clock::now() < deadline)
+				        {
+					        for (size_t c = s; c < clientCount; c += senderThreads)
+					        {
+						        for (size_t b = 0; b < burst; b++)
+						        {
+							        enet_peer_send(peers[c], 0, enet_packet_create(payload.data(), payload.size(), 0));
+						        }
+						        queued += burst;
+						        enet_host_service(clients[c], &event, 0);
+					        }
+				        }
+				        sent += queued;
+			        });
+		}
+
+		for (auto& sender: senders)
+		{
+			sender.join();
+		}
+
+		// Let the last datagrams land, then stop counting
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		measuring = false;
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		stop = true;
+		for (auto& thread: listenerThreads)
+		{
+			thread.join();
+		}
+
+		uint64_t total = 0;
+		uint64_t busiest = 0;
+		for (size_t i = 0; i < listenerCount; i++)
+		{
+			total += received[i];
+			busiest = (std::max)(busiest, received[i].load());
+		}
+
+		result << "\n  " << listenerCount << (listenerCount == 1 ? " listener: " : " listeners: ") << static_cast<uint64_t>(total / seconds) << " packets/s received (" << total << " of " << sent << " sent, busiest listener "
+		       << (total ? busiest * 100 / total : 0) << "%, " << connected << "/" << clientCount << " connected)";
+
+		for (auto* peer: peers)
+			enet_peer_disconnect_now(peer, 0);
+		for (auto* host: clients)
+			enet_host_destroy(host);
+		for (auto* host: listeners)
+			enet_host_destroy(host);
+	}
+
+	enet_deinitialize();
+	return result.str();
+}
@@ -0,0 +1,96 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include "OutboundQueue.h"
+
+// Queue and drain messageCount mixed packets the way a reconnect does, against the old priority_queue of strings
+std::string benchmarkOutboundQueue(size_t messageCount)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Mix seen while moving and chatting through an outage: mostly position updates, some chat and commands
+	std::vector<std::shared_ptr<GameProtocol::Packet>> packets;
+	std::vector<uint8_t> priorities;
+	for (size_t i = 0; i < messageCount; i++)
+	{
+		if (i % 10 == 0)
+		{
+			packets.push_back(std::make_shared<GameProtocol::ChatMessagePacket>("Player", "Queued chat message " + std::to_string(i)));
+			priorities.push_back(64);
+		}
+		else if (i % 25 == 1)
+		{
+			packets.push_back(std::make_shared<GameProtocol::CommandPacket>("emote", std::vector<std::string>{ "wave" }));
+			priorities.push_back(64);
+		}
+		else
+		{
+			packets.push_back(std::make_shared<GameProtocol::DeltaPositionUpdatePacket>(Position{ static_cast<float>(i), 0.0f, 1.0f }));
+			priorities.push_back(128);
+		}
+	}
+
+	// Old path: serialize, copy into a string and push into a priority_queue, then pop by value
+	struct LegacyPacket
+	{
+		std::string message;
+		bool reliable;
+		uint64_t timestamp;
+		uint8_t priority;
+
+		bool operator<(const LegacyPacket& other) const
+		{
+			return priority != other.priority ? priority > other.priority : timestamp > other.timestamp;
+		}
+	};
+
+	size_t checksum = 0;
+	auto start = Clock::now();
+	std::priority_queue<LegacyPacket> legacy;
+	for (size_t i = 0; i < packets.size(); i++)
+	{
+		std::vector<uint8_t> data = packets[i]->serialize();
+		legacy.push({ std::string(reinterpret_cast<const char*>(data.data()), data.size()), true, i, priorities[i] });
+	}
+	const double legacyQueueUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+	start = Clock::now();
+	size_t legacySent = 0;
+	while (!legacy.empty())
+	{
+		LegacyPacket packet = legacy.top();
+		legacy.pop();
+		checksum += packet.message.size();
+		legacySent++;
+	}
+	const double legacyDrainUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+	// New path: move the serialized bytes into a lane, coalescing position updates
+	OutboundQueue queue(messageCount);
+	start = Clock::now();
+	for (size_t i = 0; i < packets.size(); i++)
+	{
+		queue.push(priorities[i], packets[i]->getType(), packets[i]->serialize(), true, i);
+	}
+	const double queueUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+	start = Clock::now();
+	size_t sent = 0;
+	OutboundQueue::Entry entry;
+	while (queue.pop(entry))
+	{
+		checksum += entry.data.size();
+		sent++;
+	}
+	const double drainUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+	std::ostringstream result;
+	result.setf(std::ios::fixed);
+	result.precision(1);
+	result << messageCount << " queued packets: priority_queue " << legacyQueueUs << " us queue + " << legacyDrainUs << " us drain (" << legacySent << " sent), lanes " << queueUs << " us queue + " << drainUs
+	       << " us drain (" << sent << " sent, " << queue.getCoalescedCount() << " position updates coalesced, checksum " << checksum << ")";
+	return result.str();
+}
@@ -0,0 +1,114 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "BenchWorld.h"
+#include "Constants.h"
+#include "FrameArena.h"
+#include "PacketTypes.h"
+#include "SpatialGrid.h"
+#include "ThreadManager.h"
+#include "VisiblePlayers.h"
+
+// World state tick time over a synthetic crowd with 1, 2, 4, 8 and 16 threads (up to the core count),
+// each run on its own pool
+std::string benchmarkParallelFor(size_t playerCount)
+{
+	std::unordered_map<uint32_t, Player> world;
+	SpatialGrid grid;
+	populateBenchmarkWorld(playerCount, world, grid);
+
+	std::vector<const Player*> recipients;
+	recipients.reserve(world.size());
+	for (const auto& pair: world)
+	{
+		recipients.push_back(&pair.second);
+	}
+
+	const float radius = INTEREST_RADIUS > 0 ? INTEREST_RADIUS : 100.0f;
+	const size_t grain = WORLD_STATE_GRAIN > 0 ? WORLD_STATE_GRAIN : 16; // 0 builds the server tick on one thread, which leaves nothing to scale
+	const size_t ticks = 20;
+
+	// Encoded bytes for recipients [first, last), built like broadcastWorldState does
+	auto encodeRange = [&](size_t first, size_t last)
+	{
+		FrameArena& arena = FrameArena::forThisThread();
+		size_t bytes = 0;
+		for (size_t index = first; index < last; ++index)
+		{
+			FrameArena::Scope scope(arena);
+			std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView> entries(&arena);
+			collectVisiblePlayers(*recipients[index], world, grid, radius, entries);
+
+			auto out = GameProtocol::WorldStatePacket::encodeChunks(std::span<const GameProtocol::WorldStatePacket::PlayerView>(entries), WORLD_STATE_CHUNK_BYTES, COMPACT_WORLD_STATE, 1,
+			        static_cast<uint8_t>(GameProtocol::WorldStatePacket::POSITION_RANGE.bits), &arena);
+			for (const auto& chunk: out)
+			{
+				bytes += chunk.size();
+			}
+		}
+		return bytes;
+	};
+
+	// A pool of threads - 1 workers plus the calling thread; one thread runs the plain loop
+	auto measure = [&](size_t threads, size_t& bytes)
+	{
+		std::unique_ptr<ThreadManager> workers;
+		if (threads > 1)
+			workers = std::make_unique<ThreadManager>(threads - 1);
+
+		auto tick = [&]()
+		{
+			if (!workers)
+				return encodeRange(0, recipients.size());
+			return workers->parallelReduce(0, recipients.size(), grain, size_t(0), encodeRange, std::plus<size_t>());
+		};
+
+		// One untimed tick so every thread's arena has grown to its working size
+		tick();
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < ticks; ++i)
+		{
+			bytes = tick();
+		}
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / ticks;
+	};
+
+	const size_t cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+	char line[192];
+	std::string report = std::to_string(playerCount) + " players, grain " + std::to_string(grain) + ", " + std::to_string(cores) + " cores\n";
+
+	size_t serialBytes = 0;
+	const double serialMs = measure(1, serialBytes);
+	snprintf(line, sizeof(line), " 1 thread:  %.2f ms per tick", serialMs);
+	report += line;
+
+	for (size_t threads = 2; threads <= (std::min)(cores, size_t(16)); threads *= 2)
+	{
+		size_t bytes = 0;
+		const double tickMs = measure(threads, bytes);
+		snprintf(line, sizeof(line), "\n%2zu threads: %.2f ms per tick, %.2fx speedup, %.0f%% efficiency", threads, tickMs, serialMs / tickMs, 100.0 * serialMs / tickMs / threads);
+		report += line;
+
+		if (bytes != serialBytes)
+		{
+			report += "\nWarning: world state size mismatch, " + std::to_string(serialBytes) + " vs " + std::to_string(bytes) + " bytes per tick";
+		}
+	}
+
+	if (cores < 2)
+	{
+		report += "\nOnly one core available, nothing to scale across";
+	}
+	return report;
+}
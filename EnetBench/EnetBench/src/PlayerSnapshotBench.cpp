@@ -0,0 +1,87 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include "PlayerManager.h"
+
+// Time per-frame player reads with the old locked map copy against PlayerManager snapshots
+std::string benchmarkPlayerSnapshots(size_t playerCount, size_t frames)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Full world states the way the server sends them, in chunks of up to 500 players
+	PlayerManager manager;
+	std::vector<GameProtocol::WorldStatePacket> chunks((playerCount + 499) / 500);
+	for (uint32_t id = 1; id <= playerCount; id++)
+	{
+		auto& info = chunks[(id - 1) / 500].players.emplace_back();
+		info.id = id;
+		info.name = "Player_" + std::to_string(id);
+		info.position = Position{ static_cast<float>(id % 200) - 100.0f, 0.0f, static_cast<float>(id / 200) - 100.0f };
+	}
+
+	// One network update per frame: apply a snapshot, then publish it for the UI
+	double applyUs = 0;
+	double publishUs = 0;
+	for (size_t frame = 0; frame < frames; frame++)
+	{
+		const auto start = Clock::now();
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			chunks[i].snapshotId = static_cast<uint32_t>(frame + 1);
+			chunks[i].chunkIndex = static_cast<uint16_t>(i);
+			chunks[i].chunkCount = static_cast<uint16_t>(chunks.size());
+			manager.handleWorldState(chunks[i]);
+		}
+		const auto applied = Clock::now();
+		manager.publishSnapshot();
+
+		applyUs += std::chrono::duration<double, std::micro>(applied - start).count();
+		publishUs += std::chrono::duration<double, std::micro>(Clock::now() - applied).count();
+	}
+	applyUs /= frames;
+	publishUs /= frames;
+
+	// Stand-in for the per-frame work the players panel does with each entry
+	float checksum = 0.0f;
+	auto touch = [&checksum](const PlayerInfo& player) { checksum += player.position.x + static_cast<float>(player.name.size()); };
+
+	// Old path: copy the whole player map and hold the lock while drawing, every frame
+	std::unordered_map<uint32_t, PlayerInfo> playerMap;
+	std::mutex playersMutex;
+	for (const auto& player: manager.acquireSnapshot().players)
+	{
+		playerMap[player.id] = player;
+	}
+	auto start = Clock::now();
+	for (size_t frame = 0; frame < frames; frame++)
+	{
+		const auto copy = playerMap;
+		std::lock_guard<std::mutex> lock(playersMutex);
+		for (const auto& pair: copy)
+		{
+			touch(pair.second);
+		}
+	}
+	const double copyUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+
+	// New path: a lock-free read of the latest snapshot
+	start = Clock::now();
+	for (size_t frame = 0; frame < frames; frame++)
+	{
+		for (const auto& player: manager.acquireSnapshot().players)
+		{
+			touch(player);
+		}
+	}
+	const double readUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+
+	std::ostringstream result;
+	result.setf(std::ios::fixed);
+	result.precision(1);
+	result << playerCount << " players, " << frames << " frames: world state apply " << applyUs << " us, map copy " << copyUs << " us/frame, snapshot read " << readUs
+	       << " us/frame, publish " << publishUs << " us/update (checksum " << checksum << ")";
+	return result.str();
+}
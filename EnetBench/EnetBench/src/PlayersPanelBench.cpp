@@ -0,0 +1,78 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <imgui.h>
+#include "PlayerManager.h"
+#include "UIManager.h"
+
+// Build the client's players panel for synthetic players in a headless ImGui context and time each frame.
+// Nothing is rendered; this is the CPU cost of the list and map markers the UI thread pays per frame.
+std::string benchmarkPlayersPanel(size_t playerCount, size_t frames)
+{
+	// Spread the players over the map so markers overlap like a busy server
+	GameProtocol::WorldStatePacket worldState;
+	worldState.snapshotId = 1;
+	worldState.chunkIndex = 0;
+	worldState.chunkCount = 1;
+	for (uint32_t i = 0; i < playerCount; i++)
+	{
+		auto& info = worldState.players.emplace_back();
+		info.id = i + 1;
+		info.name = "Bench_" + std::to_string(i + 1);
+		info.position = Position{ static_cast<float>(i * 37 % 200) - 100.0f, 0.0f, static_cast<float>(i * 91 % 200) - 100.0f };
+	}
+
+	auto playerManager = std::make_shared<PlayerManager>();
+	playerManager->handleWorldState(worldState);
+	playerManager->publishSnapshot();
+
+	ImGuiContext* context = ImGui::CreateContext();
+	ImGuiIO& io = ImGui::GetIO();
+	io.DisplaySize = ImVec2(1024, 768);
+	io.IniFilename = nullptr;
+	io.Fonts->AddFontDefault();
+	unsigned char* pixels = nullptr;
+	int textureWidth = 0, textureHeight = 0;
+	io.Fonts->GetTexDataAsRGBA32(&pixels, &textureWidth, &textureHeight);
+
+	UIManager ui;
+	ui.setPlayerManager(playerManager);
+
+	// Panel size as drawConnectedUI lays it out in a 1024x768 window
+	const float width = 1024 * 0.3f;
+	const float height = 768 - 140;
+
+	double totalUs = 0.0;
+	double worstUs = 0.0;
+	for (size_t frame = 0; frame < frames + 1; frame++)
+	{
+		io.DeltaTime = 1.0f / 60.0f;
+		ImGui::NewFrame();
+		ImGui::SetNextWindowPos(ImVec2(0, 0));
+		ImGui::SetNextWindowSize(io.DisplaySize);
+		ImGui::Begin("Bench", nullptr, ImGuiWindowFlags_NoDecoration);
+
+		const auto start = std::chrono::steady_clock::now();
+		ui.drawPlayersPanel(width, height);
+		const double panelUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		ImGui::End();
+		ImGui::Render();
+
+		// The first frame creates the windows, so leave it out
+		if (frame > 0)
+		{
+			totalUs += panelUs;
+			worstUs = (std::max)(worstUs, panelUs);
+		}
+	}
+
+	ImGui::DestroyContext(context);
+
+	char result[160];
+	snprintf(result, sizeof(result), "Players panel with %zu players over %zu frames: avg %.1f us, worst %.1f us", playerCount, frames, totalUs / frames, worstUs);
+	return result;
+}
@@ -0,0 +1,116 @@
+#include "Benchmarks.h"
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "PooledAllocator.h"
+
+namespace
+{
+	void* systemAllocate(size_t size)
+	{
+		return std::malloc(size);
+	}
+
+	void systemRelease(void* memory)
+	{
+		std::free(memory);
+	}
+} // namespace
+
+// One world state tick for playerCount recipients: senders create packets, one thread frees them
+std::string benchmarkPooledAllocator(size_t playerCount)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Per recipient ENet allocates the packet, a copy of the data and an outgoing command
+	const size_t senderCount = 4;
+	const size_t ticks = 200;
+	const size_t packetSize = 48;
+	const size_t commandSize = 96;
+	const size_t dataSize = 600;
+	const std::vector<uint8_t> worldState(dataSize, 0x5A);
+
+	using AllocateFn = void* (*) (size_t);
+	using ReleaseFn = void (*)(void*);
+	const AllocateFn allocators[2] = { &systemAllocate, &PooledAllocator::allocate };
+	const ReleaseFn releasers[2] = { &systemRelease, &PooledAllocator::release };
+
+	std::vector<std::vector<void*>> created(senderCount);
+	std::atomic<int> mode{ 0 };
+	std::atomic<bool> done{ false };
+	std::barrier sync(static_cast<std::ptrdiff_t>(senderCount + 1));
+
+	// Senders build every recipient's packet, like the world state tasks on the pool
+	std::vector<std::thread> senders;
+	for (size_t s = 0; s < senderCount; s++)
+	{
+		senders.emplace_back(
+		        [&, s]()
+		        {
+			        while (true)
+			        {
+				        sync.arrive_and_wait();
+				        if (done)
+				        {
+					        return;
+				        }
+
+				        const AllocateFn allocate = allocators[mode];
+				        for (size_t player = s; player < playerCount; player += senderCount)
+				        {
+					        void* data = allocate(dataSize);
+					        std::memcpy(data, worldState.data(), dataSize);
+					        created[s].push_back(allocate(packetSize));
+					        created[s].push_back(data);
+					        created[s].push_back(allocate(commandSize));
+				        }
+				        sync.arrive_and_wait();
+			        }
+		        });
+	}
+
+	const PooledAllocator::Counters before = PooledAllocator::getCounters();
+	double tickUs[2] = {};
+	for (int current = 0; current < 2; current++)
+	{
+		mode = current;
+		const auto start = Clock::now();
+		for (size_t tick = 0; tick < ticks; tick++)
+		{
+			sync.arrive_and_wait();
+			sync.arrive_and_wait();
+
+			// The network thread frees everything once it has been sent
+			for (auto& blocks: created)
+			{
+				for (void* block: blocks)
+				{
+					releasers[current](block);
+				}
+				blocks.clear();
+			}
+		}
+		tickUs[current] = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / ticks;
+	}
+
+	done = true;
+	sync.arrive_and_wait();
+	for (auto& sender: senders)
+	{
+		sender.join();
+	}
+
+	const PooledAllocator::Counters after = PooledAllocator::getCounters();
+	std::ostringstream result;
+	result.setf(std::ios::fixed);
+	result.precision(1);
+	result << playerCount << " players, " << playerCount * 3 << " ENet allocations per tick across " << senderCount << " senders: malloc " << tickUs[0] << " us/tick, pooled " << tickUs[1] << " us/tick ("
+	       << (after.cacheMisses - before.cacheMisses) / ticks << " shared pool refills per tick, " << after.bytesReserved / 1024 << " KB reserved)";
+	return result.str();
+}
@@ -0,0 +1,111 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "BenchWorld.h"
+#include "Constants.h"
+#include "FrameArena.h"
+#include "HeapCounter.h"
+#include "PacketTypes.h"
+#include "SpatialGrid.h"
+#include "VisiblePlayers.h"
+
+// Heap allocations and time for one world state tick over a synthetic crowd, built the old way
+// (std::set, PlayerInfo copies, packet objects) and the current way (frame arena views)
+std::string benchmarkTickAllocations(size_t playerCount)
+{
+	std::unordered_map<uint32_t, Player> world;
+	SpatialGrid grid;
+	populateBenchmarkWorld(playerCount, world, grid);
+
+	const float radius = INTEREST_RADIUS > 0 ? INTEREST_RADIUS : 100.0f;
+	const size_t ticks = 20;
+
+	auto legacyTick = [&](size_t& bytes)
+	{
+		for (const auto& pair: world)
+		{
+			const Player& player = pair.second;
+			std::set<uint32_t> visibleEntities = grid.getNearbyEntities(player.position, radius);
+
+			std::vector<GameProtocol::WorldStatePacket::PlayerInfo> entries;
+			entries.reserve(visibleEntities.size());
+			for (uint32_t entityId: visibleEntities)
+			{
+				auto it = world.find(entityId);
+				if (entityId != player.id && it != world.end())
+				{
+					entries.push_back({ it->second.id, it->second.name, it->second.position });
+				}
+			}
+
+			std::vector<std::vector<uint8_t>> out;
+			for (const auto& chunk: GameProtocol::WorldStatePacket::splitIntoChunks(std::move(entries), WORLD_STATE_CHUNK_BYTES, COMPACT_WORLD_STATE, 1))
+			{
+				out.push_back(chunk.serialize());
+				bytes += out.back().size();
+			}
+		}
+	};
+
+	FrameArena arena;
+	auto arenaTick = [&](size_t& bytes)
+	{
+		for (const auto& pair: world)
+		{
+			FrameArena::Scope scope(arena);
+			std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView> entries(&arena);
+			collectVisiblePlayers(pair.second, world, grid, radius, entries);
+
+			auto out = GameProtocol::WorldStatePacket::encodeChunks(std::span<const GameProtocol::WorldStatePacket::PlayerView>(entries), WORLD_STATE_CHUNK_BYTES, COMPACT_WORLD_STATE, 1,
+			        static_cast<uint8_t>(GameProtocol::WorldStatePacket::POSITION_RANGE.bits), &arena);
+			for (const auto& chunk: out)
+			{
+				bytes += chunk.size();
+			}
+		}
+		arena.reset();
+	};
+
+	auto measure = [&](auto& tick, size_t& bytes, uint64_t& allocations, double& tickUs)
+	{
+		// One untimed tick so the arena has grown to its working size
+		size_t warmupBytes = 0;
+		tick(warmupBytes);
+
+		const uint64_t heapBefore = heapAllocationsOnThisThread();
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < ticks; ++i)
+		{
+			tick(bytes);
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		bytes /= ticks;
+		allocations = (heapAllocationsOnThisThread() - heapBefore) / ticks;
+		tickUs = std::chrono::duration<double, std::micro>(end - start).count() / ticks;
+	};
+
+	size_t legacyBytes = 0, arenaBytes = 0;
+	uint64_t legacyAllocations = 0, arenaAllocations = 0;
+	double legacyUs = 0, arenaUs = 0;
+	measure(legacyTick, legacyBytes, legacyAllocations, legacyUs);
+	measure(arenaTick, arenaBytes, arenaAllocations, arenaUs);
+
+	char line[192];
+	std::string report = std::to_string(playerCount) + " players, radius " + std::to_string(static_cast<int>(radius)) + "\n";
+	snprintf(line, sizeof(line), "Before: %llu heap allocations per tick, %.1f us per tick\n", static_cast<unsigned long long>(legacyAllocations), legacyUs);
+	report += line;
+	snprintf(line, sizeof(line), "After:  %llu heap allocations per tick (outgoing chunk buffers), %.1f us per tick, %zu arena bytes reserved", static_cast<unsigned long long>(arenaAllocations), arenaUs,
+	        arena.getBytesReserved());
+	report += line;
+	if (legacyBytes != arenaBytes)
+	{
+		report += "\nWarning: world state size mismatch, " + std::to_string(legacyBytes) + " vs " + std::to_string(arenaBytes) + " bytes per tick";
+	}
+	return report;
+}
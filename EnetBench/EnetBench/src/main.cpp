@@ -0,0 +1,86 @@
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "winmm.lib")
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmarks.h"
+
+namespace
+{
+	struct Benchmark
+	{
+		const char* name;
+		const char* description;
+		std::function<std::string()> run;
+	};
+
+	const std::vector<Benchmark>& benchmarks()
+	{
+		static const std::vector<Benchmark> all = {
+			{ "encoding", "Compare WorldState encodings for 100 visible players", []() { return benchmarkWorldStateEncoding(100, 1000); } },
+			{ "clocksync", "Measure clock sync estimator convergence over a simulated loopback link", []() { return benchmarkClockSync(64); } },
+			{ "encryption", "Measure secure channel CPU cost for 500 players", []() { return benchmarkEncryption(500); } },
+			{ "playersnapshots", "Compare the old per-frame player map copy with snapshot reads for 1000 players", []() { return benchmarkPlayerSnapshots(1000, 200); } },
+			{ "playerspanel", "Time the client players panel for 1000 players in a headless ImGui context", []() { return benchmarkPlayersPanel(1000, 300); } },
+			{ "outboundqueue", "Queue and drain 10000 packets through the outbound lanes against the old priority_queue", []() { return benchmarkOutboundQueue(10000); } },
+			{ "bans", "Measure ban lookups against 100k rules", []() { return benchmarkBanList(100000); } },
+			{ "listeners", "Measure loopback packets/sec against 1 to 8 SO_REUSEPORT listeners", []() { return benchmarkListeners((std::min)(std::thread::hardware_concurrency(), 8u), 500); } },
+			{ "alloc", "Compare malloc and the pooled ENet allocator for a 500-player tick", []() { return benchmarkPooledAllocator(500); } },
+			{ "tickalloc", "Count heap allocations of one world state tick for 500 players, before and after the frame arena", []() { return benchmarkTickAllocations(500); } },
+			{ "parallel", "Time one world state tick for 2000 players on 1 to 16 threads", []() { return benchmarkParallelFor(2000); } },
+		};
+		return all;
+	}
+
+	void printUsage()
+	{
+		std::cout << "Usage: EnetBench all|<benchmark>..." << std::endl;
+		for (const auto& benchmark: benchmarks())
+		{
+			std::cout << "  " << benchmark.name << " - " << benchmark.description << std::endl;
+		}
+	}
+} // namespace
+
+// Benchmarks for the server and client hot paths, kept out of the shipped executables
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	std::vector<const Benchmark*> selected;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string name = argv[i];
+		bool found = false;
+		for (const auto& benchmark: benchmarks())
+		{
+			if (name == "all" || name == benchmark.name)
+			{
+				selected.push_back(&benchmark);
+				found = true;
+			}
+		}
+
+		if (!found)
+		{
+			std::cerr << "Unknown benchmark: " << name << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	for (const auto* benchmark: selected)
+	{
+		std::cout << "===== " << benchmark->name << " =====" << std::endl;
+		std::cout << benchmark->run() << std::endl;
+	}
+	return 0;
+}
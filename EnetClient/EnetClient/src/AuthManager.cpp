@@ -75,7 +75,7 @@ bool AuthManager::authenticate(const std::string& username, const std::string& p
 	}
 
 	// Send the authentication packet with reliability
-	networkManager->GetPacketManager()->sendPacket(serverPeer, *authPacket, true);
+	networkManager->sendPacket(authPacket, true);
 
 	// Save credentials if requested
 	if (rememberCredentials)
@@ -130,22 +130,25 @@ void AuthManager::processAuthResponse(const void* packetData, size_t packetLengt
 		return;
 	}
 
-	// Cast to the specific packet type
-	auto* authResponse = dynamic_cast<GameProtocol::AuthResponsePacket*>(packet.get());
-	if (!authResponse)
+	processAuthResponse(static_cast<const GameProtocol::AuthResponsePacket&>(*packet), successCallback, failedCallback);
+}
+
+void AuthManager::processAuthResponse(const GameProtocol::AuthResponsePacket& response, const std::function<void(uint32_t)>& authSuccessCallback, const std::function<void(const std::string&)>& authFailedCallback)
+{
+	// Use the stored callbacks if not provided
+	auto successCallback = authSuccessCallback ? authSuccessCallback : this->authSuccessCallback;
+	auto failedCallback = authFailedCallback ? authFailedCallback : this->authFailedCallback;
+
+	if (!successCallback || !failedCallback)
 	{
-		logger.error("Failed to cast auth response packet");
-		if (failedCallback)
-		{
-			threadManager->scheduleTask([failedCallback]() { failedCallback("Received malformed authentication response"); });
-		}
+		logger.fatal("No callbacks provided for auth response processing, this will cause a crash!");
 		return;
 	}
 
 	// Process the authentication response
-	if (authResponse->success)
+	if (response.success)
 	{
-		playerId = authResponse->playerId;
+		playerId = response.playerId;
 		authenticated = true;
 
 		logger.info("Authentication successful! Player ID: " + std::to_string(playerId));
@@ -159,7 +162,7 @@ void AuthManager::processAuthResponse(const void* packetData, size_t packetLengt
 	else
 	{
 		authenticated = false;
-		std::string errorMessage = authResponse->message;
+		std::string errorMessage = response.message;
 		logger.error("Authentication failed: " + errorMessage);
 
 		if (failedCallback)
@@ -6,6 +6,7 @@
 
 #include "Constants.h"
 #include "Logger.h"
+#include "PacketTypes.h"
 #include "ThreadManager.h"
 
 // Forward declarations
@@ -50,6 +51,14 @@ public:
      */
 	void processAuthResponse(const void* packetData, size_t packetLength, const std::function<void(uint32_t)>& authSuccessCallback = nullptr, const std::function<void(const std::string&)>& authFailedCallback = nullptr);
 
+	/**
+     * Process an already decoded authentication response
+     * @param response Authentication response packet
+     * @param authSuccessCallback Callback for when authentication succeeds
+     * @param authFailedCallback Callback for when authentication fails, with error message
+     */
+	void processAuthResponse(const GameProtocol::AuthResponsePacket& response, const std::function<void(uint32_t)>& authSuccessCallback = nullptr, const std::function<void(const std::string&)>& authFailedCallback = nullptr);
+
 	/**
      * Save credentials to file
      * @param username Username to save
@@ -6,33 +6,76 @@
 #include "ConnectionManager.h"
 #include "PlayerManager.h"
 
-void ChatManager::addChatMessage(const std::string& sender, const std::string& content)
+ChatManager::ChatManager()
+      : capacity(MESSAGE_HISTORY_SIZE), slots(std::make_unique<std::atomic<std::shared_ptr<const ChatEntry>>[]>(capacity))
 {
-	std::lock_guard<std::mutex> guard(chatMutex);
+	// Apply a throttle level as if the server had requested it, to watch the shaper in the diagnostics report
+	registerLocalCommand("throttle",
+	        [this](const std::vector<std::string>& args)
+	        {
+		        if (!networkManager)
+		        {
+			        return;
+		        }
+		        const int level = args.empty() ? 0 : std::clamp(std::atoi(args[0].c_str()), 0, 9);
+		        networkManager->setServerRequestedThrottling(level);
+		        addChatMessage("System", "Outbound throttle level set to " + std::to_string(level));
+	        });
+}
 
-	ChatMessage msg;
-	msg.sender = sender;
-	msg.content = content;
-	msg.timestamp = time(0);
+void ChatManager::addChatMessage(const std::string& sender, const std::string& content)
+{
+	std::lock_guard<std::mutex> guard(writeMutex);
 
-	chatMessages.push_back(msg);
+	auto entry = std::make_shared<ChatEntry>();
+	entry->sequence = nextSequence.load(std::memory_order_relaxed);
+	entry->content = content;
+	entry->timestamp = static_cast<uint32_t>(time(0));
 
-	// Keep only the last N messages
-	while (chatMessages.size() > MESSAGE_HISTORY_SIZE)
+	// Intern the sender; the table is only a cache, so it is simply reset if many senders pile up
+	auto& name = senderNames[sender];
+	if (!name)
+	{
+		name = std::make_shared<const std::string>(sender);
+	}
+	entry->sender = name;
+	if (senderNames.size() > 1024)
 	{
-		chatMessages.pop_front();
+		senderNames.clear();
 	}
+
+	// The slot is published before the sequence, so a reader that sees the sequence finds the entry.
+	// Overwriting the slot evicts the oldest message.
+	const uint64_t sequence = entry->sequence;
+	slots[sequence % capacity].store(std::move(entry), std::memory_order_release);
+	nextSequence.store(sequence + 1, std::memory_order_release);
 }
 
 void ChatManager::clearChatMessages()
 {
-	std::lock_guard<std::mutex> guard(chatMutex);
-	chatMessages.clear();
+	std::lock_guard<std::mutex> guard(writeMutex);
+	clearedBefore.store(nextSequence.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+uint64_t ChatManager::readChatMessages(uint64_t sinceSequence, std::vector<std::shared_ptr<const ChatEntry>>& entries) const
+{
+	const uint64_t end = nextSequence.load(std::memory_order_acquire);
+	for (uint64_t sequence = (std::max)(sinceSequence, getOldestSequence()); sequence < end; sequence++)
+	{
+		// A writer that lapped us leaves a newer entry in the slot; that message is gone
+		auto entry = slots[sequence % capacity].load(std::memory_order_acquire);
+		if (entry && entry->sequence == sequence)
+		{
+			entries.push_back(std::move(entry));
+		}
+	}
+	return end;
 }
 
-const std::deque<ChatMessage>& ChatManager::getChatMessages() const
+uint64_t ChatManager::getOldestSequence() const
 {
-	return chatMessages;
+	const uint64_t end = nextSequence.load(std::memory_order_acquire);
+	return (std::max)(end > capacity ? end - capacity : 0, clearedBefore.load(std::memory_order_acquire));
 }
 
 // Send a chat message using the new packet system
@@ -45,7 +88,7 @@ void ChatManager::sendChatMessage(const std::string& message)
 	auto chatPacket = networkManager->GetPacketManager()->createChatMessage(playerManager->getMyPlayer().name, message);
 
 	// Send the packet
-	networkManager->GetPacketManager()->sendPacket(networkManager->getServer(), *chatPacket, true);
+	networkManager->sendPacket(chatPacket, true);
 
 	// Also add to local chat
 	addChatMessage("You", message);
@@ -93,7 +136,14 @@ void ChatManager::processChatCommand(const std::string& command)
 
 		// Add the command to the chat
 		addChatMessage("You - command", command);
-		
+
+		// Local diagnostics that never reach the server
+		if (auto it = localCommands.find(baseCmd); it != localCommands.end())
+		{
+			it->second(args);
+			return;
+		}
+
 		// Send all other commands to the server
 		if (networkManager->isConnectedToServer() && authManager->isAuthenticated())
 		{
@@ -101,7 +151,7 @@ void ChatManager::processChatCommand(const std::string& command)
 			auto commandPacket = networkManager->GetPacketManager()->createCommand(baseCmd, args);
 
 			// Send the packet
-			networkManager->GetPacketManager()->sendPacket(networkManager->getServer(), *commandPacket, true);
+			networkManager->sendPacket(commandPacket, true);
 
 			logger.debug("Sent command to server: " + baseCmd + " with " + std::to_string(args.size()) + " arguments");
 		}
@@ -117,6 +167,11 @@ void ChatManager::processChatCommand(const std::string& command)
 	}
 }
 
+void ChatManager::registerLocalCommand(const std::string& name, LocalCommandHandler handler)
+{
+	localCommands[name] = std::move(handler);
+}
+
 void ChatManager::setAuthManager(std::shared_ptr<AuthManager> authManager)
 {
 	this->authManager = authManager;
@@ -136,8 +191,3 @@ void ChatManager::setConnectionManager(std::shared_ptr<ConnectionManager> connec
 {
 	this->connectionManager = connectionManager;
 }
-
-std::mutex& ChatManager::getMutex()
-{
-	return chatMutex;
-}
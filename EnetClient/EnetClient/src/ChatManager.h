@@ -1,8 +1,12 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "PacketTypes.h"
 #include "Logger.h"
 
@@ -11,32 +15,58 @@ class PlayerManager;
 class NetworkManager;
 class ConnectionManager;
 
+// Immutable once published; readers keep it alive for as long as they hold it
+struct ChatEntry
+{
+	uint64_t sequence = 0;
+	std::shared_ptr<const std::string> sender; // Interned, shared by every message from the same sender
+	std::string content;
+	uint32_t timestamp = 0;
+};
+
 class ChatManager
 {
 public:
-	ChatManager() = default;
+	using LocalCommandHandler = std::function<void(const std::vector<std::string>& args)>;
+
+	ChatManager();
+	// Safe from any thread; writers only serialize among themselves
 	void addChatMessage(const std::string& sender, const std::string& content);
 	void clearChatMessages();
-	const std::deque<ChatMessage>& getChatMessages() const;
+
+	// Lock-free for readers: append entries with sequence >= sinceSequence that are still held, returns the next sequence to ask for
+	uint64_t readChatMessages(uint64_t sinceSequence, std::vector<std::shared_ptr<const ChatEntry>>& entries) const;
+
+	// Oldest sequence still held; readers drop anything older (evicted or cleared)
+	uint64_t getOldestSequence() const;
 	void sendChatMessage(const std::string& message);
 	void processChatCommand(const std::string& command);
 
+	// Handle a slash command on the client instead of sending it to the server
+	void registerLocalCommand(const std::string& name, LocalCommandHandler handler);
+
 	// Set managers
 	void setAuthManager(std::shared_ptr<AuthManager> authManager);
 	void setPlayerManager(std::shared_ptr<PlayerManager> playerManager);
 	void setNetworkManager(std::shared_ptr<NetworkManager> networkManager);
 	void setConnectionManager(std::shared_ptr<ConnectionManager> connectionManager);
 
-	std::mutex& getMutex();
-
 private:
 	std::shared_ptr<AuthManager> authManager;
 	std::shared_ptr<PlayerManager> playerManager;
 	std::shared_ptr<NetworkManager> networkManager;
 	std::shared_ptr<ConnectionManager> connectionManager;
 
-	std::deque<ChatMessage> chatMessages;
-	std::mutex chatMutex;
+	// Fixed ring of the last MESSAGE_HISTORY_SIZE messages; slot = sequence % capacity
+	const size_t capacity;
+	std::unique_ptr<std::atomic<std::shared_ptr<const ChatEntry>>[]> slots;
+	std::atomic<uint64_t> nextSequence{ 0 };
+	std::atomic<uint64_t> clearedBefore{ 0 };
+
+	std::mutex writeMutex;
+	std::unordered_map<std::string, std::shared_ptr<const std::string>> senderNames;
+
+	std::unordered_map<std::string, LocalCommandHandler> localCommands;
 
 	Logger& logger = Logger::getInstance();
 };
@@ -38,7 +38,7 @@ void ConnectionManager::startConnection(const std::string& username, const std::
 		if (serverPeer)
 		{
 			auto posRequest = networkManager->GetPacketManager()->createPositionUpdate(playerId, playerManager->getMyPosition());
-			networkManager->GetPacketManager()->sendPacket(serverPeer, *posRequest, true);
+			networkManager->sendPacket(posRequest, true);
 		}
 		else
 		{
@@ -112,82 +112,62 @@ void ConnectionManager::disconnect(bool tellServer)
 	GameClient::currentGameState = CurrentGameState::LoginScreen;
 }
 
-// Handle received packet with the new packet system
-void ConnectionManager::handlePacket(const ENetPacket* enetPacket)
+// Route a decoded packet to its handler
+void ConnectionManager::dispatchPacket(const GameProtocol::Packet& packet)
 {
-	// Process the packet using the PacketManager
-	auto packet = networkManager->GetPacketManager()->receivePacket(enetPacket);
-
-	// Check if we got a valid packet
-	if (!packet)
-	{
-		logger.error("Received invalid packet");
-		return;
-	}
-
 	// Handle packet based on type
-	GameProtocol::PacketType packetType = packet->getType();
+	GameProtocol::PacketType packetType = packet.getType();
 
 	switch (packetType)
 	{
 		case GameProtocol::PacketType::AuthResponse:
 		{
-			auto* authResponse = dynamic_cast<GameProtocol::AuthResponsePacket*>(packet.get());
-			if (authResponse)
-			{
-				handleAuthResponse(*authResponse);
-			}
+			const auto& authResponse = static_cast<const GameProtocol::AuthResponsePacket&>(packet);
+			handleAuthResponse(authResponse);
 			break;
 		}
 
 		case GameProtocol::PacketType::PositionUpdate:
 		{
-			auto* posUpdate = dynamic_cast<GameProtocol::PositionUpdatePacket*>(packet.get());
-			if (posUpdate)
-			{
-				// Not sure right now if this is other players also or just my own
-				playerManager->handlePositionUpdate(*posUpdate);
-			}
+			const auto& posUpdate = static_cast<const GameProtocol::PositionUpdatePacket&>(packet);
+			// Not sure right now if this is other players also or just my own
+			playerManager->handlePositionUpdate(posUpdate);
 			break;
 		}
 
 		case GameProtocol::PacketType::ChatMessage:
 		{
-			auto* chatMessage = dynamic_cast<GameProtocol::ChatMessagePacket*>(packet.get());
-			if (chatMessage)
-			{
-				handleChatMessage(*chatMessage);
-			}
+			const auto& chatMessage = static_cast<const GameProtocol::ChatMessagePacket&>(packet);
+			handleChatMessage(chatMessage);
 			break;
 		}
 
 		case GameProtocol::PacketType::SystemMessage:
 		{
-			auto* sysMessage = dynamic_cast<GameProtocol::SystemMessagePacket*>(packet.get());
-			if (sysMessage)
-			{
-				handleSystemMessage(*sysMessage);
-			}
+			const auto& sysMessage = static_cast<const GameProtocol::SystemMessagePacket&>(packet);
+			handleSystemMessage(sysMessage);
 			break;
 		}
 
 		case GameProtocol::PacketType::Teleport:
 		{
-			auto* teleport = dynamic_cast<GameProtocol::TeleportPacket*>(packet.get());
-			if (teleport)
-			{
-				handleTeleport(*teleport);
-			}
+			const auto& teleport = static_cast<const GameProtocol::TeleportPacket&>(packet);
+			handleTeleport(teleport);
 			break;
 		}
 
 		case GameProtocol::PacketType::WorldState:
+		case GameProtocol::PacketType::CompactWorldState:
+		{
+			const auto& worldState = static_cast<const GameProtocol::WorldStatePacket&>(packet);
+			playerManager->handleWorldState(worldState);
+			break;
+		}
+
+		case GameProtocol::PacketType::BulkData:
 		{
-			auto* worldState = dynamic_cast<GameProtocol::WorldStatePacket*>(packet.get());
-			if (worldState)
-			{
-				playerManager->handleWorldState(*worldState);
-			}
+			const auto& bulkData = static_cast<const GameProtocol::BulkDataPacket&>(packet);
+			handleBulkData(bulkData);
 			break;
 		}
 
@@ -238,7 +218,7 @@ void ConnectionManager::updateNetwork()
 					        if (serverPeer)
 					        {
 						        auto deltaPacket = networkManager->GetPacketManager()->createDeltaPositionUpdate(myPosition);
-						        networkManager->GetPacketManager()->sendPacket(serverPeer, *deltaPacket, false);
+						        networkManager->sendPacket(deltaPacket, false);
 					        }
 				        }
 			        }
@@ -249,7 +229,7 @@ void ConnectionManager::updateNetwork()
 				        if (serverPeer)
 				        {
 					        auto posPacket = networkManager->GetPacketManager()->createPositionUpdate(myPlayerId, myPosition);
-					        networkManager->GetPacketManager()->sendPacket(serverPeer, *posPacket, false);
+					        networkManager->sendPacket(posPacket, false);
 				        }
 			        }
 
@@ -257,11 +237,15 @@ void ConnectionManager::updateNetwork()
 			        lastPositionUpdateTime = currentTime;
 		        }
 	        },
-	        // Packet handler callback
-	        [this](const ENetPacket* packet) { handlePacket(packet); },
 	        // Disconnect callback
 	        [this]() { signOut(); });
 
+	// Apply everything received this frame, in arrival order, on this thread
+	networkManager->processIncomingPackets([this](const GameProtocol::Packet& packet) { dispatchPacket(packet); });
+
+	// Hand the UI one consistent view of everything applied above
+	playerManager->publishSnapshot();
+
 	// Connection health checks at regular intervals
 	if (currentTime - lastConnectionCheckTime >= 1000)
 	{
@@ -276,6 +260,9 @@ void ConnectionManager::signOut()
 	// Disconnect from the server
 	disconnect(true);
 
+	// Drop partially received streams
+	bulkAssembler.clear();
+
 	// Clear any sensitive session data
 	playerManager->clearPlayers();
 
@@ -305,6 +292,9 @@ void ConnectionManager::setUIManager(std::shared_ptr<UIManager> uiManager)
 void ConnectionManager::setPlayerManager(std::shared_ptr<PlayerManager> playerManager)
 {
 	this->playerManager = playerManager;
+
+	playerManager->setEntityCallbacks([this](const PlayerInfo& player) { logger.debug("Player " + std::to_string(player.id) + " entered view"); },
+	        [this](const PlayerInfo& player) { logger.debug("Player " + std::to_string(player.id) + " left view"); });
 }
 
 void ConnectionManager::setAuthManager(std::shared_ptr<AuthManager> authManager)
@@ -332,7 +322,7 @@ void ConnectionManager::handleAuthResponse(const GameProtocol::AuthResponsePacke
 
 		// Send a request to get player position
 		auto posRequest = networkManager->GetPacketManager()->createPositionUpdate(myPlayerId, playerManager->getPlayerPosition(myPlayerId));
-		networkManager->GetPacketManager()->sendPacket(networkManager->getServer(), *posRequest, true);
+		networkManager->sendPacket(posRequest, true);
 	}
 	else
 	{
@@ -343,6 +333,29 @@ void ConnectionManager::handleAuthResponse(const GameProtocol::AuthResponsePacke
 	}
 }
 
+void ConnectionManager::handleBulkData(const GameProtocol::BulkDataPacket& packet)
+{
+	std::vector<uint8_t> payload;
+	if (!bulkAssembler.addChunk(packet, payload))
+		return;
+
+	auto packets = GameProtocol::unpackBulkStream(payload);
+	logger.debug("Received bulk stream " + std::to_string(packet.streamId) + " with " + std::to_string(packets.size()) + " packets");
+
+	for (const auto& inner: packets)
+	{
+		// Backfilled chat includes our own earlier messages, so bypass the echo filter
+		auto* chatMessage = dynamic_cast<const GameProtocol::ChatMessagePacket*>(inner.get());
+		if (packet.kind == GameProtocol::BulkStreamKind::ChatBackfill && chatMessage)
+		{
+			chatManager->addChatMessage(chatMessage->sender, chatMessage->message);
+			continue;
+		}
+
+		dispatchPacket(*inner);
+	}
+}
+
 void ConnectionManager::handleChatMessage(const GameProtocol::ChatMessagePacket& packet)
 {
 	// Skip our own messages that are echoed back
@@ -4,6 +4,7 @@
 #include <string>
 #include <thread>
 
+#include "BulkStream.h"
 #include "Logger.h"
 #include "PacketTypes.h"
 #include "ThemeManager.h"
@@ -31,7 +32,6 @@ public:
 	ConnectionManager() = default;
 	void startConnection(const std::string& username, const std::string& password, bool rememberCredentials);
 	void disconnect(bool tellServer = true);
-	void handlePacket(const ENetPacket* enetPacket);
 	void updateNetwork();
 	void signOut();
 
@@ -45,6 +45,8 @@ public:
 	void setThreadManager(std::shared_ptr<ThreadManager> threadManager);
 
 private:
+	void dispatchPacket(const GameProtocol::Packet& packet);
+	void handleBulkData(const GameProtocol::BulkDataPacket& packet);
 	void handleAuthResponse(const GameProtocol::AuthResponsePacket& packet);
 	void handleChatMessage(const GameProtocol::ChatMessagePacket& packet);
 	void handleSystemMessage(const GameProtocol::SystemMessagePacket& packet);
@@ -57,6 +59,9 @@ private:
 	std::shared_ptr<ChatManager> chatManager;
 	std::shared_ptr<PlayerManager> playerManager;
 
+	// Reassembles chat backfill and world sync streams from the bulk channel
+	GameProtocol::BulkStreamAssembler bulkAssembler;
+
 	std::atomic<bool> connectionThreadRunning{ false };
 	std::thread connectionThread;
 
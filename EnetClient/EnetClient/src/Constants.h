@@ -10,3 +10,7 @@
 #define DEFAULT_PORT 7777
 #define DEFAULT_SERVER "127.0.0.1"
 #define SECURE_PASSWORD_STORAGE true // more used for the server
+#define ENABLE_ENCRYPTION true       // Ask the server for an encrypted channel on connect
+#define REQUIRE_ENCRYPTION false     // Refuse to play unencrypted if the server declines
+#define NETWORK_THREAD_ENABLED true  // Service ENet on a dedicated thread instead of the render loop
+#define NETWORK_THREAD_WAIT_MS 1     // Longest the network thread blocks waiting for a packet
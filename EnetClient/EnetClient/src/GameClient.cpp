@@ -50,6 +50,12 @@ GameClient::GameClient()
 	connectionManager->setUIManager(uiManager);
 	uiManager->setConnectionManager(connectionManager);
 
+	// Service ENet on its own thread so frame hitches don't delay receives and acks
+	if (NETWORK_THREAD_ENABLED)
+	{
+		networkManager->startNetworkThread([connection = connectionManager.get()]() { connection->signOut(); });
+	}
+
 	// Try to load stored credentials if none provided
 	if (myPlayerName.empty() || myPassword.empty())
 	{
@@ -81,6 +87,8 @@ GameClient::GameClient()
 // Destructor
 GameClient::~GameClient()
 {
+	// Stop the network thread first, its disconnect callback points at the connection manager
+	networkManager->stopNetworkThread();
 	connectionManager->disconnect(true);
 	currentGameState = CurrentGameState::LoginScreen;
 
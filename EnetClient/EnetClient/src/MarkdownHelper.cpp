@@ -1,50 +1,37 @@
 #include "MarkDownHelper.h"
 
 #include <cstring>
-#include <sstream>
 #include <windows.h>
 #include <shellapi.h>
 #include "IconsLucide.h"
 
-// Main function to render markdown content
-void MarkdownHelper::RenderMarkdown(const std::string& markdown, float wrapWidth, const UITheme& theme)
+// Parse markdown into blocks and styled runs
+void MarkdownHelper::ParseMarkdown(const std::string& markdown, MarkdownDocument& document)
 {
-	// Save original styles
-	ImVec4 originalTextColor = ImGui::GetStyle().Colors[ImGuiCol_Text];
-	float originalFontSize = ImGui::GetFontSize();
+	document.storage.clear();
+	document.blocks.clear();
+	document.runs.clear();
+	document.layoutHeight = -1.0f;
 
-	// Text wrapping setup
-	ImGui::PushTextWrapPos(wrapWidth);
-	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-
-	// Parse and render markdown
-	std::istringstream stream(markdown);
-	std::string line;
+	std::string_view remainingText(markdown);
 	bool inCodeBlock = false;
-	std::string codeBlockContent;
+	size_t codeBlockIndex = 0;
 
-	while (std::getline(stream, line))
+	while (!remainingText.empty())
 	{
-		// Skip empty lines
-		if (line.empty())
-		{
-			ImGui::Dummy(ImVec2(0, ImGui::GetTextLineHeight() * 0.5f));
-			continue;
-		}
+		// Split off the next line
+		const size_t lineEnd = remainingText.find('\n');
+		const std::string_view line = remainingText.substr(0, lineEnd);
+		remainingText.remove_prefix(lineEnd == std::string_view::npos ? remainingText.size() : lineEnd + 1);
 
 		// Check for code blocks (```code```)
-		if (line.find("```") == 0)
+		if (line.starts_with("```"))
 		{
-			if (inCodeBlock)
-			{
-				// End code block, render accumulated content
-				RenderCodeBlock(codeBlockContent, wrapWidth, theme);
-				codeBlockContent.clear();
-			}
-			else
+			if (!inCodeBlock)
 			{
-				// Start collecting code block content
-				codeBlockContent = "";
+				// Start collecting code block lines
+				codeBlockIndex = document.blocks.size();
+				document.blocks.push_back({ MarkdownDocument::BlockKind::CodeBlock, 0, static_cast<uint32_t>(document.runs.size()), 0 });
 			}
 			inCodeBlock = !inCodeBlock;
 			continue;
@@ -52,189 +39,259 @@ void MarkdownHelper::RenderMarkdown(const std::string& markdown, float wrapWidth
 
 		if (inCodeBlock)
 		{
-			// Accumulate code block content
-			codeBlockContent += line + "\n";
+			AddRun(document, MarkdownDocument::RunStyle::Plain, line);
+			document.blocks[codeBlockIndex].runCount++;
 			continue;
 		}
 
-		// Check for headers (# Header)
-		if (line[0] == '#')
+		// Empty lines become a small gap
+		if (line.empty())
 		{
-			size_t level = 0;
-			while (level < line.size() && line[level] == '#')
-				level++;
-
-			if (level > 0 && level <= 6 && level < line.size() && line[level] == ' ')
-			{
-				// Extract header text and render
-				std::string headerText = line.substr(level + 1); // Skip "# " prefix
-				RenderHeader(headerText, level, theme);
-				continue;
-			}
+			document.blocks.push_back({ MarkdownDocument::BlockKind::Blank, 0, 0, 0 });
+			continue;
 		}
 
+		MarkdownDocument::Block block{ MarkdownDocument::BlockKind::Paragraph, 0, static_cast<uint32_t>(document.runs.size()), 0 };
+
+		// Check for headers (# Header)
+		size_t level = 0;
+		while (level < line.size() && line[level] == '#')
+			level++;
+
+		if (level > 0 && level <= 6 && level < line.size() && line[level] == ' ')
+		{
+			block.kind = MarkdownDocument::BlockKind::Header;
+			block.level = static_cast<uint8_t>(level);
+			AddRun(document, MarkdownDocument::RunStyle::Plain, line.substr(level + 1)); // Skip "# " prefix
+		}
 		// Check for bullet lists
-		if (line.size() >= 2 && (line[0] == '-' || line[0] == '*' || line[0] == '+') && line[1] == ' ')
+		else if (line.size() >= 2 && (line[0] == '-' || line[0] == '*' || line[0] == '+') && line[1] == ' ')
 		{
-			std::string bulletText = line.substr(2); // Skip "- " prefix
-			RenderBulletItem(bulletText, theme);
-			continue;
+			block.kind = MarkdownDocument::BlockKind::Bullet;
+			ParseInline(line.substr(2), document); // Skip "- " prefix
 		}
-
 		// Regular paragraph - process inline formatting
-		RenderInlineMarkdown(line, theme);
+		else
+		{
+			ParseInline(line, document);
+		}
+
+		block.runCount = static_cast<uint32_t>(document.runs.size()) - block.firstRun;
+		document.blocks.push_back(block);
 	}
 
-	// If we're still in a code block at the end, close it
-	if (inCodeBlock && !codeBlockContent.empty())
+	// A code block left open at the end is only shown if it has content
+	if (inCodeBlock && document.blocks[codeBlockIndex].runCount == 0)
 	{
-		RenderCodeBlock(codeBlockContent, wrapWidth, theme);
+		document.blocks.erase(document.blocks.begin() + codeBlockIndex);
 	}
-
-	// Pop spacing
-	ImGui::PopStyleVar();
-
-	ImGui::Dummy(ImVec2(0, 4));
-
-	// Pop text wrap
-	ImGui::PopTextWrapPos();
 }
 
-// Process inline markdown elements (bold, italic, code, links)
-void MarkdownHelper::RenderInlineMarkdown(const std::string& text, const UITheme& theme)
+// Split a line into runs for inline markdown elements (bold, italic, code, links)
+void MarkdownHelper::ParseInline(std::string_view text, MarkdownDocument& document)
 {
-	const char* remaining = text.c_str();
-	const char* textEnd = remaining + text.size();
+	const size_t firstRun = document.runs.size();
+	size_t position = 0;
 
-	while (remaining < textEnd)
+	while (position < text.size())
 	{
-		const char* markdownStart = nullptr;
-		const char* markdownEnd = nullptr;
+		const std::string_view remaining = text.substr(position);
 
 		// Check for bold (**text**)
-		if (strncmp(remaining, "**", 2) == 0)
+		if (remaining.starts_with("**"))
 		{
-			markdownStart = remaining;
-			markdownEnd = strstr(markdownStart + 2, "**");
-
-			if (markdownEnd)
+			const size_t close = remaining.find("**", 2);
+			if (close != std::string_view::npos)
 			{
-				// Display text before the formatting
-				if (markdownStart > remaining)
-				{
-					ImGui::TextUnformatted(remaining, markdownStart);
-					ImGui::SameLine(0.0f, 0.0f);
-				}
-
-				// Display bold text
-				std::string boldText(markdownStart + 2, markdownEnd);
-				RenderBoldText(boldText, theme);
-
-				remaining = markdownEnd + 2;
-				ImGui::SameLine(0.0f, 0.0f);
+				AddRun(document, MarkdownDocument::RunStyle::Bold, remaining.substr(2, close - 2));
+				position += close + 2;
 				continue;
 			}
 		}
 
 		// Check for italic (*text*)
-		if (*remaining == '*' && (remaining + 1 < textEnd) && *(remaining + 1) != '*')
+		if (remaining[0] == '*' && remaining.size() > 1 && remaining[1] != '*')
 		{
-			markdownStart = remaining;
-			markdownEnd = strchr(markdownStart + 1, '*');
-
-			if (markdownEnd)
+			const size_t close = remaining.find('*', 1);
+			if (close != std::string_view::npos)
 			{
-				// Display text before the formatting
-				if (markdownStart > remaining)
-				{
-					ImGui::TextUnformatted(remaining, markdownStart);
-					ImGui::SameLine(0.0f, 0.0f);
-				}
-
-				// Display italic text
-				std::string italicText(markdownStart + 1, markdownEnd);
-				RenderItalicText(italicText, theme);
-
-				remaining = markdownEnd + 1;
-				ImGui::SameLine(0.0f, 0.0f);
+				AddRun(document, MarkdownDocument::RunStyle::Italic, remaining.substr(1, close - 1));
+				position += close + 1;
 				continue;
 			}
 		}
 
 		// Check for inline code (`code`)
-		if (*remaining == '`')
+		if (remaining[0] == '`')
 		{
-			markdownStart = remaining;
-			markdownEnd = strchr(markdownStart + 1, '`');
-
-			if (markdownEnd)
+			const size_t close = remaining.find('`', 1);
+			if (close != std::string_view::npos)
 			{
-				// Display text before the formatting
-				if (markdownStart > remaining)
-				{
-					ImGui::TextUnformatted(remaining, markdownStart);
-					ImGui::SameLine(0.0f, 0.0f);
-				}
-
-				// Display inline code
-				std::string codeText(markdownStart + 1, markdownEnd);
-				RenderInlineCode(codeText, theme);
-
-				remaining = markdownEnd + 1;
-				ImGui::SameLine(0.0f, 0.0f);
+				AddRun(document, MarkdownDocument::RunStyle::Code, remaining.substr(1, close - 1));
+				position += close + 1;
 				continue;
 			}
 		}
 
 		// Check for links ([text](url))
-		if (*remaining == '[')
+		if (remaining[0] == '[')
 		{
-			const char* linkTextStart = remaining + 1;
-			const char* linkTextEnd = strchr(linkTextStart, ']');
-
-			if (linkTextEnd && *(linkTextEnd + 1) == '(')
+			const size_t textEnd = remaining.find(']', 1);
+			if (textEnd != std::string_view::npos && textEnd + 1 < remaining.size() && remaining[textEnd + 1] == '(')
 			{
-				const char* urlStart = linkTextEnd + 2;
-				const char* urlEnd = strchr(urlStart, ')');
-
-				if (urlEnd)
+				const size_t urlEnd = remaining.find(')', textEnd + 2);
+				if (urlEnd != std::string_view::npos)
 				{
-					// Display text before the link
-					if (remaining > text.c_str())
-					{
-						ImGui::TextUnformatted(text.c_str(), remaining);
-						ImGui::SameLine(0.0f, 0.0f);
-					}
-
-					// Extract link text and URL
-					std::string linkText(linkTextStart, linkTextEnd);
-					std::string url(urlStart, urlEnd);
-
-					// Render link
-					RenderLink(linkText, url, theme);
-
-					remaining = urlEnd + 1;
-					ImGui::SameLine(0.0f, 0.0f);
+					AddRun(document, MarkdownDocument::RunStyle::Link, remaining.substr(1, textEnd - 1), remaining.substr(textEnd + 2, urlEnd - textEnd - 2));
+					position += urlEnd + 1;
 					continue;
 				}
 			}
 		}
 
-		// No special formatting, just advance one character
-		const char* nextChar = remaining + 1;
-		while (nextChar < textEnd && !strchr("*`[", *nextChar))
-			nextChar++;
+		// No special formatting, take everything up to the next marker character
+		const size_t next = remaining.find_first_of("*`[", 1);
+		const size_t length = next == std::string_view::npos ? remaining.size() : next;
+		position += length;
+
+		// Text split around an unmatched marker joins the previous plain run; its terminator is the last byte of storage
+		if (document.runs.size() > firstRun && document.runs.back().style == MarkdownDocument::RunStyle::Plain)
+		{
+			document.storage.pop_back();
+			document.storage.append(remaining.substr(0, length));
+			document.storage.push_back('\0');
+			document.runs.back().textLength += static_cast<uint32_t>(length);
+			continue;
+		}
+		AddRun(document, MarkdownDocument::RunStyle::Plain, remaining.substr(0, length));
+	}
+}
+
+void MarkdownHelper::AddRun(MarkdownDocument& document, MarkdownDocument::RunStyle style, std::string_view text, std::string_view url)
+{
+	MarkdownDocument::Run run;
+	run.style = style;
+	run.text = static_cast<uint32_t>(document.storage.size());
+	run.textLength = static_cast<uint32_t>(text.size());
+	document.storage.append(text);
+	document.storage.push_back('\0');
+
+	if (style == MarkdownDocument::RunStyle::Link)
+	{
+		run.url = static_cast<uint32_t>(document.storage.size());
+		document.storage.append(url);
+		document.storage.push_back('\0');
+	}
+	document.runs.push_back(run);
+}
+
+// Render a parsed document, or just its cached height when it is off screen
+void MarkdownHelper::RenderMarkdown(MarkdownDocument& document, float wrapWidth, const UITheme& theme, uint32_t themeRevision)
+{
+	const bool layoutValid = document.layoutHeight >= 0.0f && document.layoutWrapWidth == wrapWidth && document.layoutThemeRevision == themeRevision;
+	if (layoutValid && !ImGui::IsRectVisible(ImVec2(wrapWidth, document.layoutHeight)))
+	{
+		ImGui::Dummy(ImVec2(0, document.layoutHeight));
+		return;
+	}
+
+	const float startY = ImGui::GetCursorPosY();
+	RenderBlocks(document, wrapWidth, theme);
+
+	// Measure without the trailing item spacing, which the placeholder Dummy adds back
+	document.layoutHeight = ImGui::GetCursorPosY() - startY - ImGui::GetStyle().ItemSpacing.y;
+	document.layoutWrapWidth = wrapWidth;
+	document.layoutThemeRevision = themeRevision;
+}
+
+void MarkdownHelper::RenderMarkdown(const std::string& markdown, float wrapWidth, const UITheme& theme)
+{
+	MarkdownDocument document;
+	ParseMarkdown(markdown, document);
+	RenderBlocks(document, wrapWidth, theme);
+}
+
+void MarkdownHelper::RenderBlocks(const MarkdownDocument& document, float wrapWidth, const UITheme& theme)
+{
+	// Text wrapping setup
+	ImGui::PushTextWrapPos(wrapWidth);
+	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+
+	for (const auto& block: document.blocks)
+	{
+		switch (block.kind)
+		{
+			case MarkdownDocument::BlockKind::Blank:
+				ImGui::Dummy(ImVec2(0, ImGui::GetTextLineHeight() * 0.5f));
+				break;
 
-		ImGui::TextUnformatted(remaining, nextChar);
-		if (nextChar < textEnd)
+			case MarkdownDocument::BlockKind::Header:
+				RenderHeader(document.storage.c_str() + document.runs[block.firstRun].text, block.level, theme);
+				break;
+
+			case MarkdownDocument::BlockKind::Bullet:
+				RenderBulletItem(document, block, theme);
+				break;
+
+			case MarkdownDocument::BlockKind::CodeBlock:
+				RenderCodeBlock(document, block, wrapWidth, theme);
+				break;
+
+			case MarkdownDocument::BlockKind::Paragraph:
+				RenderRuns(document, block, theme);
+				break;
+		}
+	}
+
+	// Pop spacing
+	ImGui::PopStyleVar();
+
+	ImGui::Dummy(ImVec2(0, 4));
+
+	// Pop text wrap
+	ImGui::PopTextWrapPos();
+}
+
+// Render the inline runs of a block on one (wrapped) line
+void MarkdownHelper::RenderRuns(const MarkdownDocument& document, const MarkdownDocument::Block& block, const UITheme& theme)
+{
+	for (uint32_t i = 0; i < block.runCount; i++)
+	{
+		const auto& run = document.runs[block.firstRun + i];
+		const char* text = document.storage.c_str() + run.text;
+
+		if (i > 0)
+		{
 			ImGui::SameLine(0.0f, 0.0f);
+		}
 
-		remaining = nextChar;
+		switch (run.style)
+		{
+			case MarkdownDocument::RunStyle::Plain:
+				ImGui::TextUnformatted(text, text + run.textLength);
+				break;
+
+			case MarkdownDocument::RunStyle::Bold:
+				RenderBoldText(text, theme);
+				break;
+
+			case MarkdownDocument::RunStyle::Italic:
+				RenderItalicText(text, theme);
+				break;
+
+			case MarkdownDocument::RunStyle::Code:
+				RenderInlineCode(text, theme);
+				break;
+
+			case MarkdownDocument::RunStyle::Link:
+				RenderLink(text, document.storage.c_str() + run.url, theme);
+				break;
+		}
 	}
 }
 
 // Render header with appropriate styling
-void MarkdownHelper::RenderHeader(const std::string& text, int level, const UITheme& theme)
+void MarkdownHelper::RenderHeader(const char* text, int level, const UITheme& theme)
 {
 	// Scale factor for headers (h1 is largest, h6 is smallest)
 	float scaleFactor = 1.0f + (0.5f - (level * 0.1f));
@@ -244,7 +301,7 @@ void MarkdownHelper::RenderHeader(const std::string& text, int level, const UITh
 
 	ImGui::SetWindowFontScale(scaleFactor);
 
-	ImGui::TextWrapped("%s", text.c_str());
+	ImGui::TextWrapped("%s", text);
 
 	// Pop styling
 	ImGui::PopStyleColor();
@@ -257,22 +314,20 @@ void MarkdownHelper::RenderHeader(const std::string& text, int level, const UITh
 }
 
 // Render code block
-void MarkdownHelper::RenderCodeBlock(const std::string& code, float width, const UITheme& theme)
+void MarkdownHelper::RenderCodeBlock(const MarkdownDocument& document, const MarkdownDocument::Block& block, float width, const UITheme& theme)
 {
 	ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.2f, 0.2f, 0.2f, 0.6f));
-	ImGui::BeginChild(("CodeBlock" + std::to_string(ImGui::GetCursorPosY())).c_str(), ImVec2(width - 20, 0), ImGuiChildFlags_AutoResizeY | ImGuiChildFlags_Border);
+	ImGui::BeginChild(ImGui::GetID(&block), ImVec2(width - 20, 0), ImGuiChildFlags_AutoResizeY | ImGuiChildFlags_Border);
 	ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.9f, 0.9f, 0.9f, 1.0f)); // Light gray text
 
 	// Use monospace font
 	ImGui::PushFont(GetMonoFont());
 
-	// Split the code into lines
-	std::istringstream codeStream(code);
-	std::string line;
-
-	while (std::getline(codeStream, line))
+	for (uint32_t i = 0; i < block.runCount; i++)
 	{
-		ImGui::TextUnformatted(line.c_str());
+		const auto& run = document.runs[block.firstRun + i];
+		const char* line = document.storage.c_str() + run.text;
+		ImGui::TextUnformatted(line, line + run.textLength);
 	}
 
 	// Pop monospace font if used
@@ -286,7 +341,7 @@ void MarkdownHelper::RenderCodeBlock(const std::string& code, float width, const
 }
 
 // Render bullet item
-void MarkdownHelper::RenderBulletItem(const std::string& text, const UITheme& theme)
+void MarkdownHelper::RenderBulletItem(const MarkdownDocument& document, const MarkdownDocument::Block& block, const UITheme& theme)
 {
 	float indent = ImGui::GetStyle().IndentSpacing * 0.5f;
 	ImGui::Indent(indent);
@@ -295,25 +350,25 @@ void MarkdownHelper::RenderBulletItem(const std::string& text, const UITheme& th
 	ImGui::TextColored(ImGui::GetStyle().Colors[ImGuiCol_Text], ICON_LC_DOT);
 	ImGui::SameLine();
 
-	// Process inline formatting in the bullet item
-	RenderInlineMarkdown(text, theme);
+	// Inline formatting in the bullet item
+	RenderRuns(document, block, theme);
 
 	ImGui::Unindent(indent);
 	ImGui::Spacing();
 }
 
 // Render hyperlink
-void MarkdownHelper::RenderLink(const std::string& text, const std::string& url, const UITheme& theme)
+void MarkdownHelper::RenderLink(const char* text, const char* url, const UITheme& theme)
 {
 	// Display as a colored link
 	ImGui::PushStyleColor(ImGuiCol_Text, theme.accentPrimary);
-	ImGui::TextUnformatted(text.c_str());
+	ImGui::TextUnformatted(text);
 
 	// Handle hover effect and click
 	if (ImGui::IsItemHovered())
 	{
 		ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
-		ImGui::SetTooltip("%s", url.c_str());
+		ImGui::SetTooltip("%s", url);
 
 		if (ImGui::IsMouseClicked(0))
 		{
@@ -325,17 +380,17 @@ void MarkdownHelper::RenderLink(const std::string& text, const std::string& url,
 }
 
 // Render inline code
-void MarkdownHelper::RenderInlineCode(const std::string& code, const UITheme& theme)
+void MarkdownHelper::RenderInlineCode(const char* code, const UITheme& theme)
 {
 	ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.9f, 0.7f, 0.5f, 1.0f));   // Light orange
 	ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.2f, 0.5f)); // Dark background
 
 	ImGui::PushFont(GetMonoFont());
 
-	if (ImGui::Button(code.c_str()))
+	if (ImGui::Button(code))
 	{
 		// copy the code to clipboard
-		ImGui::SetClipboardText(code.c_str());
+		ImGui::SetClipboardText(code);
 	}
 
 	ImGui::PopFont();
@@ -344,14 +399,14 @@ void MarkdownHelper::RenderInlineCode(const std::string& code, const UITheme& th
 }
 
 // Render bold text
-void MarkdownHelper::RenderBoldText(const std::string& text, const UITheme& theme)
+void MarkdownHelper::RenderBoldText(const char* text, const UITheme& theme)
 {
 	ImGui::PushStyleColor(ImGuiCol_Text, theme.textPrimary);
 
 	// In a real implementation, you would use a bold font:
 	ImGui::PushFont(GetBoldFont());
 
-	ImGui::TextUnformatted(text.c_str());
+	ImGui::TextUnformatted(text);
 
 	ImGui::PopFont();
 
@@ -359,14 +414,14 @@ void MarkdownHelper::RenderBoldText(const std::string& text, const UITheme& them
 }
 
 // Render italic text
-void MarkdownHelper::RenderItalicText(const std::string& text, const UITheme& theme)
+void MarkdownHelper::RenderItalicText(const char* text, const UITheme& theme)
 {
 	ImGui::PushStyleColor(ImGuiCol_Text, theme.textPrimary);
 
 	// In a real implementation, you would use an italic font:
 	ImGui::PushFont(GetItalicFont());
 
-	ImGui::TextUnformatted(text.c_str());
+	ImGui::TextUnformatted(text);
 
 	ImGui::PopFont();
 
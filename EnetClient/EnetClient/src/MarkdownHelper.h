@@ -1,27 +1,82 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "imgui.h"
 #include "ThemeManager.h"
 
+// Markdown parsed once into styled runs; rendering only walks these
+struct MarkdownDocument
+{
+	enum class BlockKind : uint8_t
+	{
+		Blank,
+		Paragraph,
+		Header,
+		Bullet,
+		CodeBlock
+	};
+
+	enum class RunStyle : uint8_t
+	{
+		Plain,
+		Bold,
+		Italic,
+		Code,
+		Link
+	};
+
+	// Offsets into storage; every text and url is null-terminated there
+	struct Run
+	{
+		RunStyle style = RunStyle::Plain;
+		uint32_t text = 0;
+		uint32_t textLength = 0;
+		uint32_t url = 0;
+	};
+
+	// Code blocks hold one run per line, headers a single run
+	struct Block
+	{
+		BlockKind kind = BlockKind::Blank;
+		uint8_t level = 0;
+		uint32_t firstRun = 0;
+		uint32_t runCount = 0;
+	};
+
+	std::string storage;
+	std::vector<Block> blocks;
+	std::vector<Run> runs;
+
+	// Height of the last full render, reused to skip off-screen documents while wrap width and theme are unchanged
+	float layoutHeight = -1.0f;
+	float layoutWrapWidth = 0.0f;
+	uint32_t layoutThemeRevision = 0;
+};
+
 class MarkdownHelper
 {
 public:
-	// Main function to render markdown content
-	static void RenderMarkdown(const std::string& markdown, float wrapWidth, const UITheme& theme);
+	// Parse markdown into a document that can be rendered every frame without re-parsing
+	static void ParseMarkdown(const std::string& markdown, MarkdownDocument& document);
 
-	// Parse and render various markdown elements
-	static void RenderInlineMarkdown(const std::string& text, const UITheme& theme);
+	// Render a parsed document; skipped down to a spacer when it is scrolled out of view
+	static void RenderMarkdown(MarkdownDocument& document, float wrapWidth, const UITheme& theme, uint32_t themeRevision);
+
+	// Parse and render one-off markdown content
+	static void RenderMarkdown(const std::string& markdown, float wrapWidth, const UITheme& theme);
 
 	// Helper functions for specific markdown elements
-	static void RenderHeader(const std::string& text, int level, const UITheme& theme);
-	static void RenderCodeBlock(const std::string& code, float width, const UITheme& theme);
-	static void RenderBulletItem(const std::string& text, const UITheme& theme);
-	static void RenderLink(const std::string& text, const std::string& url, const UITheme& theme);
-	static void RenderInlineCode(const std::string& code, const UITheme& theme);
-	static void RenderBoldText(const std::string& text, const UITheme& theme);
-	static void RenderItalicText(const std::string& text, const UITheme& theme);
+	static void RenderHeader(const char* text, int level, const UITheme& theme);
+	static void RenderBulletItem(const MarkdownDocument& document, const MarkdownDocument::Block& block, const UITheme& theme);
+	static void RenderCodeBlock(const MarkdownDocument& document, const MarkdownDocument::Block& block, float width, const UITheme& theme);
+	static void RenderLink(const char* text, const char* url, const UITheme& theme);
+	static void RenderInlineCode(const char* code, const UITheme& theme);
+	static void RenderBoldText(const char* text, const UITheme& theme);
+	static void RenderItalicText(const char* text, const UITheme& theme);
 
 	// Utility functions
 	static bool IsLinkHovered();
@@ -30,4 +85,10 @@ public:
 	static ImFont* GetMonoFont();
 	static ImFont* GetBoldFont();
 	static ImFont* GetItalicFont();
+
+private:
+	static void ParseInline(std::string_view text, MarkdownDocument& document);
+	static void AddRun(MarkdownDocument& document, MarkdownDocument::RunStyle style, std::string_view text, std::string_view url = {});
+	static void RenderBlocks(const MarkdownDocument& document, float wrapWidth, const UITheme& theme);
+	static void RenderRuns(const MarkdownDocument& document, const MarkdownDocument::Block& block, const UITheme& theme);
 };
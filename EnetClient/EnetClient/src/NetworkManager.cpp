@@ -5,8 +5,10 @@
 #include <iomanip>
 #include <sstream>
 
+#include "PooledAllocator.h"
+
 // TokenBucket implementation
-bool NetworkManager::TokenBucket::consumeTokens(float amount, uint64_t currentTime)
+void NetworkManager::TokenBucket::refill(uint64_t currentTime)
 {
 	// Update tokens based on time passed
 	if (lastUpdate > 0)
@@ -16,15 +18,6 @@ bool NetworkManager::TokenBucket::consumeTokens(float amount, uint64_t currentTi
 	}
 
 	lastUpdate = currentTime;
-
-	// Check if we have enough tokens
-	if (tokens >= amount)
-	{
-		tokens -= amount;
-		return true;
-	}
-
-	return false;
 }
 
 // Reset network diagnostics
@@ -79,13 +72,19 @@ NetworkManager::NetworkManager(std::shared_ptr<ThreadManager> threadManager)
 	// Default packet type configuration
 	auto configureMessageTypes = [this]()
 	{
-		messageTypeConfigs["AUTH:"] = { MessageCategory::CRITICAL, PRIORITY_CRITICAL, false, 1.0f };
-		messageTypeConfigs["PING:"] = { MessageCategory::CRITICAL, PRIORITY_HIGH, false, 1.0f };
-		messageTypeConfigs["POSITION:"] = { MessageCategory::POSITION, PRIORITY_NORMAL, true, 0.3f };
-		messageTypeConfigs["MOVE_DELTA:"] = { MessageCategory::POSITION, PRIORITY_NORMAL, true, 0.3f };
-		messageTypeConfigs["CHAT:"] = { MessageCategory::CHAT, PRIORITY_NORMAL, true, 0.7f };
-		messageTypeConfigs["COMMAND:"] = { MessageCategory::GAMEPLAY, PRIORITY_HIGH, false, 0.9f };
-		messageTypeConfigs["TELEPORT:"] = { MessageCategory::GAMEPLAY, PRIORITY_CRITICAL, false, 1.0f };
+		using GameProtocol::PacketType;
+		messageTypeConfigs[PacketType::AuthRequest] = { MessageCategory::CRITICAL, PRIORITY_CRITICAL, false, 1.0f };
+		messageTypeConfigs[PacketType::Registration] = { MessageCategory::CRITICAL, PRIORITY_CRITICAL, false, 1.0f };
+		messageTypeConfigs[PacketType::Disconnect] = { MessageCategory::CRITICAL, PRIORITY_CRITICAL, false, 1.0f };
+		messageTypeConfigs[PacketType::Heartbeat] = { MessageCategory::CRITICAL, PRIORITY_CRITICAL, false, 1.0f };
+		messageTypeConfigs[PacketType::Ping] = { MessageCategory::CRITICAL, PRIORITY_HIGH, false, 1.0f };
+		messageTypeConfigs[PacketType::PositionUpdate] = { MessageCategory::POSITION, PRIORITY_NORMAL, true, 0.3f };
+		messageTypeConfigs[PacketType::DeltaPositionUpdate] = { MessageCategory::POSITION, PRIORITY_NORMAL, true, 0.3f };
+		messageTypeConfigs[PacketType::ChatMessage] = { MessageCategory::CHAT, PRIORITY_HIGH, true, 0.7f };
+		messageTypeConfigs[PacketType::SystemMessage] = { MessageCategory::CHAT, PRIORITY_HIGH, true, 0.7f };
+		messageTypeConfigs[PacketType::Whisper] = { MessageCategory::CHAT, PRIORITY_HIGH, true, 0.7f };
+		messageTypeConfigs[PacketType::Command] = { MessageCategory::GAMEPLAY, PRIORITY_HIGH, false, 0.9f };
+		messageTypeConfigs[PacketType::Teleport] = { MessageCategory::GAMEPLAY, PRIORITY_CRITICAL, false, 1.0f };
 	};
 
 	threadManager->scheduleResourceTask({ GameResources::configResourceId }, configureMessageTypes);
@@ -93,6 +92,7 @@ NetworkManager::NetworkManager(std::shared_ptr<ThreadManager> threadManager)
 	// Default bandwidth allocation
 	auto configureBandwidth = [this]()
 	{
+		std::lock_guard<std::mutex> guard(bandwidthMutex);
 		categoryTokenBuckets[MessageCategory::CRITICAL] = TokenBucket(50000, 100000); // 50 KB/s, 100 KB burst
 		categoryTokenBuckets[MessageCategory::GAMEPLAY] = TokenBucket(40000, 80000);  // 40 KB/s, 80 KB burst
 		categoryTokenBuckets[MessageCategory::POSITION] = TokenBucket(30000, 60000);  // 30 KB/s, 60 KB burst
@@ -110,6 +110,7 @@ NetworkManager::NetworkManager(std::shared_ptr<ThreadManager> threadManager)
 // Destructor with enhanced cleanup
 NetworkManager::~NetworkManager()
 {
+	stopNetworkThread();
 	disconnect(true);
 
 	// Clean up ENet resources
@@ -138,8 +139,9 @@ bool NetworkManager::initialize()
 	                {
 		                logger.debug("Initializing ENet");
 
-		                // Initialize ENet
-		                if (enet_initialize() != 0)
+		                // Initialize ENet with pooled allocations, packets are created and freed on different threads
+		                const ENetCallbacks callbacks = PooledAllocator::callbacks();
+		                if (enet_initialize_with_callbacks(ENET_VERSION, &callbacks) != 0)
 		                {
 			                logger.error("Failed to initialize ENet");
 			                return false;
@@ -282,6 +284,13 @@ bool NetworkManager::connectToServer(const char* address, uint16_t port)
 					lastHeartbeatSent = getCurrentTimeMs();
 				}
 
+				// Start clock sync from scratch, the server clock may have changed
+				{
+					std::lock_guard<std::mutex> guard(clockSyncMutex);
+					clockSync.reset();
+				}
+				lastPingTime = 0;
+
 				// Update diagnostics
 				updateConnectionDiagnostics(connectStartTime);
 
@@ -339,6 +348,24 @@ bool NetworkManager::connectToServer(const char* address, uint16_t port)
 		return false;
 	}
 
+	// Negotiate encryption before any game traffic goes out
+	if (!establishSecureChannel())
+	{
+		{
+			std::lock_guard<std::mutex> guard(connectionStateMutex);
+			isConnected = false;
+			connectionState = ConnectionState::DISCONNECTED;
+			if (server != nullptr)
+			{
+				enet_peer_disconnect_now(server, 0);
+				server = nullptr;
+			}
+		}
+
+		connectionInProgress.store(false);
+		return false;
+	}
+
 	// Now we can process queued packets, but don't block here
 	threadManager->scheduleTask([this]() { processQueuedPackets(); });
 
@@ -346,6 +373,79 @@ bool NetworkManager::connectToServer(const char* address, uint16_t port)
 	return true;
 }
 
+// Run the key exchange on a fresh connection (caller holds enetMutex)
+// Returns false if the connection can't continue: encryption was required, or the server's state is unknown
+bool NetworkManager::establishSecureChannel()
+{
+	packetManager.removeSecureChannel(server);
+
+	if (!encryptionEnabled)
+	{
+		return true;
+	}
+
+	auto channel = std::make_shared<GameProtocol::SecureChannel>(GameProtocol::SecureChannel::Role::Client);
+	if (!channel->generateKeyPair())
+	{
+		logger.warning("Secure channel unavailable on this platform");
+		return !requireEncryption;
+	}
+
+	packetManager.sendPacket(server, *packetManager.createKeyExchange(true, channel->getPublicKey()), true);
+	packetManager.flushDeferredSends();
+
+	uint64_t startTime = getCurrentTimeMs();
+	while (getCurrentTimeMs() - startTime < keyExchangeTimeoutMs)
+	{
+		ENetEvent event;
+		int result = enet_host_service(client, &event, 50);
+		if (result < 0 || (result > 0 && event.type == ENET_EVENT_TYPE_DISCONNECT))
+		{
+			logger.error("Connection lost during key exchange");
+			return false;
+		}
+		if (result == 0 || event.type != ENET_EVENT_TYPE_RECEIVE)
+		{
+			continue;
+		}
+
+		// The server sends nothing else before answering the key exchange
+		auto packet = packetManager.receivePacket(event.packet, event.peer);
+		enet_packet_destroy(event.packet);
+		if (!packet || packet->getType() != GameProtocol::PacketType::KeyExchange)
+		{
+			continue;
+		}
+
+		const auto& reply = static_cast<const GameProtocol::KeyExchangePacket&>(*packet);
+		if (!reply.accepted)
+		{
+			if (requireEncryption)
+			{
+				logger.error("Server declined encryption");
+				return false;
+			}
+
+			logger.warning("Server declined encryption, continuing unencrypted");
+			return true;
+		}
+
+		// The server is already sealing its traffic, so a failure here leaves no way to continue
+		if (!channel->establish(reply.publicKey))
+		{
+			logger.error("Key exchange failed");
+			return false;
+		}
+
+		packetManager.setSecureChannel(server, std::move(channel));
+		logger.info("Secure channel established");
+		return true;
+	}
+
+	logger.error("Key exchange timed out");
+	return false;
+}
+
 void NetworkManager::disconnect(bool tellServer)
 {
 	// Check if we're already disconnected
@@ -357,6 +457,16 @@ void NetworkManager::disconnect(bool tellServer)
 	// Update connection state
 	connectionState = ConnectionState::DISCONNECTING;
 
+	// A position held back by the shaper belongs to this session
+	{
+		std::lock_guard<std::mutex> guard(bandwidthMutex);
+		heldPosition.clear();
+	}
+
+	// The network thread may be servicing the host
+	std::lock_guard<std::mutex> enetGuard(enetMutex);
+	packetManager.flushDeferredSends();
+
 	bool wasConnected = false;
 	ENetPeer* serverToDisconnect = nullptr;
 
@@ -414,6 +524,7 @@ void NetworkManager::disconnect(bool tellServer)
 			enet_peer_reset(serverToDisconnect);
 		}
 
+		packetManager.removeSecureChannel(serverToDisconnect);
 		server = nullptr;
 		isConnected = false;
 		connectionState = ConnectionState::DISCONNECTED;
@@ -545,25 +656,12 @@ void NetworkManager::cleanExpiredPackets()
 {
 	uint64_t currentTime = getCurrentTimeMs();
 
-	threadManager->scheduleResourceTask({ GameResources::queueResourceId },
-	        [this, currentTime]()
-	        {
-		        std::priority_queue<QueuedPacket> tempQueue;
-
-		        while (!outgoingQueue.empty())
-		        {
-			        QueuedPacket packet = outgoingQueue.top();
-			        outgoingQueue.pop();
-
-			        if (currentTime - packet.timestamp <= maxQueuedPacketAge * 2)
-			        {
-				        tempQueue.push(packet);
-			        }
-		        }
-
-		        outgoingQueue = std::move(tempQueue);
-		        logger.debug("Removed expired packets from queue, " + std::to_string(outgoingQueue.size()) + " remaining");
-	        });
+	std::lock_guard<std::mutex> guard(queueMutex);
+	const uint64_t maxAge = static_cast<uint64_t>(maxQueuedPacketAge) * 2;
+	if (currentTime > maxAge && outgoingQueue.removeOlderThan(currentTime - maxAge) > 0)
+	{
+		logger.debug("Removed expired packets from queue, " + std::to_string(outgoingQueue.size()) + " remaining");
+	}
 }
 
 void NetworkManager::sendPacket(std::shared_ptr<GameProtocol::Packet> packet, bool reliable)
@@ -580,43 +678,11 @@ void NetworkManager::sendPacket(std::shared_ptr<GameProtocol::Packet> packet, bo
 		// Check for packet queueing
 		bool shouldQueue = queuePacketsDuringDisconnection;
 
-		// Queue the packet if enabled
+		// Queue the serialized packet in the lane its type is configured for
 		if (shouldQueue)
 		{
-			uint8_t priority = PRIORITY_NORMAL;
-
-			// Determine priority based on packet type
 			GameProtocol::PacketType packetType = packet->getType();
-
-			// Set priority based on packet type
-			switch (packetType)
-			{
-				case GameProtocol::PacketType::AuthRequest:
-				case GameProtocol::PacketType::Heartbeat:
-				case GameProtocol::PacketType::Disconnect:
-					priority = PRIORITY_CRITICAL;
-					break;
-
-				case GameProtocol::PacketType::ChatMessage:
-				case GameProtocol::PacketType::SystemMessage:
-				case GameProtocol::PacketType::Whisper:
-					priority = PRIORITY_HIGH;
-					break;
-
-				case GameProtocol::PacketType::PositionUpdate:
-				case GameProtocol::PacketType::DeltaPositionUpdate:
-					priority = PRIORITY_NORMAL;
-					break;
-
-				default:
-					priority = PRIORITY_NORMAL;
-					break;
-			}
-
-			// Convert to binary and queue
-			std::vector<uint8_t> data = packet->serialize();
-			std::string dataStr(reinterpret_cast<const char*>(data.data()), data.size());
-			queuePacket(dataStr, reliable, priority);
+			queuePacket(packetType, packet->serialize(), reliable, getMessageConfig(packetType).priority);
 		}
 		return;
 	}
@@ -629,11 +695,9 @@ void NetworkManager::sendPacket(std::shared_ptr<GameProtocol::Packet> packet, bo
 		return;
 	}
 
-	// Use the packet manager to send the packet
-	packetManager.sendPacket(serverPeer, *packet, reliable);
-
 	// Update statistics
 	GameProtocol::PacketType packetType = packet->getType();
+	shapeAndSend(serverPeer, packet->serialize(), packetType, reliable);
 	std::string packetTypeName;
 
 	// Convert packet type to string for logging
@@ -675,27 +739,25 @@ void NetworkManager::sendPacket(std::shared_ptr<GameProtocol::Packet> packet, bo
 	}
 }
 
-void NetworkManager::queuePacket(const std::string& data, bool reliable, uint8_t priority)
+void NetworkManager::queuePacket(GameProtocol::PacketType type, std::vector<uint8_t>&& data, bool reliable, uint8_t priority)
 {
-	threadManager->scheduleResourceTask({ GameResources::queueResourceId },
-	        [this, data, reliable, priority]()
-	        {
-		        // Check if queue has room
-		        if (outgoingQueue.size() < maxQueueSize)
-		        {
-			        // Create queued packet with current time
-			        QueuedPacket packet(data, reliable, priority);
-			        packet.timestamp = getCurrentTimeMs();
-			        outgoingQueue.push(packet);
+	std::lock_guard<std::mutex> guard(queueMutex);
+	outgoingQueue.setCapacity(maxQueueSize);
 
-			        logger.debug("Queued packet (priority=" + std::to_string(priority) + ")");
-		        }
-		        else
-		        {
-			        // Queue is full, drop the packet
-			        logger.warning("Packet queue full, dropping packet");
-		        }
-	        });
+	switch (outgoingQueue.push(priority, type, std::move(data), reliable, getCurrentTimeMs()))
+	{
+		case OutboundQueue::PushResult::Queued:
+			logger.debug("Queued packet (priority=" + std::to_string(priority) + ", type=" + GameProtocol::getPacketTypeName(type) + ")");
+			break;
+
+		case OutboundQueue::PushResult::Coalesced:
+			// Superseded position update, nothing worth logging
+			break;
+
+		case OutboundQueue::PushResult::Dropped:
+			logger.warning("Packet queue full, dropping packet of type: " + GameProtocol::getPacketTypeName(type));
+			break;
+	}
 }
 
 void NetworkManager::sendPacketWithPriority(std::shared_ptr<GameProtocol::Packet> packet, bool reliable, uint8_t priority)
@@ -715,33 +777,7 @@ void NetworkManager::sendPacketWithPriority(std::shared_ptr<GameProtocol::Packet
 
 	if (shouldQueue)
 	{
-		// Serialize the packet to binary data for queueing
-		std::vector<uint8_t> serializedData = packet->serialize();
-		std::string dataStr(reinterpret_cast<const char*>(serializedData.data()), serializedData.size());
-
-		// Get packet type for logging
-		GameProtocol::PacketType packetType = packet->getType();
-		std::string packetTypeName = GameProtocol::getPacketTypeName(packetType);
-
-		threadManager->scheduleResourceTask({ GameResources::queueResourceId },
-		        [this, dataStr, reliable, priority, packetTypeName]()
-		        {
-			        // Check if queue has room
-			        if (outgoingQueue.size() < maxQueueSize)
-			        {
-				        // Create queued packet with current time
-				        QueuedPacket packet(dataStr, reliable, priority);
-				        packet.timestamp = getCurrentTimeMs();
-				        outgoingQueue.push(packet);
-
-				        logger.debug("Queued packet during disconnection (priority=" + std::to_string(priority) + ", type=" + packetTypeName + ")");
-			        }
-			        else
-			        {
-				        // Queue is full, drop the packet
-				        logger.warning("Packet queue full, dropping packet of type: " + packetTypeName);
-			        }
-		        });
+		queuePacket(packet->getType(), packet->serialize(), reliable, priority);
 	}
 }
 
@@ -769,156 +805,27 @@ void NetworkManager::processQueuedPackets()
 	}
 
 	uint64_t currentTime = getCurrentTimeMs();
-	uint32_t processLimit = 20; // Process at most 20 packets at once to avoid blocking
+	uint32_t processLimit = 256; // Sends only hand bytes to ENet, but leave room for other tasks between passes
 
 	logger.debug("Processing queued packets...");
 
-	// Process packets in batches without blocking on futures
-	for (uint32_t batch = 0; batch < processLimit / 5; batch++)
+	// Pop under the lock, send outside it; the bytes go out exactly as they were serialized
+	OutboundQueue::Entry packet;
+	for (uint32_t processed = 0; processed < processLimit; processed++)
 	{
-		// Get up to 5 packets from the queue
-		std::vector<QueuedPacket> packetsToProcess;
-
-		// Use a mutex to protect the queue instead of scheduling a task
 		{
 			std::lock_guard<std::mutex> guard(queueMutex);
-			uint32_t count = 0;
-			while (!outgoingQueue.empty() && count < 5)
+			if (currentTime > maxQueuedPacketAge)
 			{
-				QueuedPacket packet = outgoingQueue.top();
-				outgoingQueue.pop();
-
-				// Check if packet is too old
-				if (currentTime - packet.timestamp <= maxQueuedPacketAge)
-				{
-					packetsToProcess.push_back(packet);
-				}
-				count++;
+				outgoingQueue.removeOlderThan(currentTime - maxQueuedPacketAge);
 			}
-		}
-
-		// If no packets to process, we're done
-		if (packetsToProcess.empty())
-		{
-			break;
-		}
-
-		// Process each packet and convert to the new format
-		for (const auto& packet: packetsToProcess)
-		{
-			// Try to determine the packet type from the legacy message format
-			if (packet.message.substr(0, 5) == "AUTH:")
+			if (!outgoingQueue.pop(packet))
 			{
-				// Parse the auth message (AUTH:username,password)
-				size_t commaPos = packet.message.find(',', 5);
-				if (commaPos != std::string::npos)
-				{
-					std::string username = packet.message.substr(5, commaPos - 5);
-					std::string password = packet.message.substr(commaPos + 1);
-
-					// Create and send auth request packet
-					auto authPacket = packetManager.createAuthRequest(username, password);
-					packetManager.sendPacket(serverPeer, *authPacket, true);
-				}
-			}
-			else if (packet.message.substr(0, 5) == "PING:")
-			{
-				// Create and send heartbeat packet
-				auto heartbeatPacket = packetManager.createHeartbeat(static_cast<uint32_t>(getCurrentTimeMs()));
-				packetManager.sendPacket(serverPeer, *heartbeatPacket, true);
-			}
-			else if (packet.message.substr(0, 9) == "POSITION:")
-			{
-				// Parse the position message (POSITION:x,y,z)
-				try
-				{
-					std::string posStr = packet.message.substr(9);
-					std::vector<float> coords;
-
-					// Parse comma-separated coordinates
-					size_t start = 0, end = 0;
-					while ((end = posStr.find(',', start)) != std::string::npos)
-					{
-						coords.push_back(std::stof(posStr.substr(start, end - start)));
-						start = end + 1;
-					}
-					coords.push_back(std::stof(posStr.substr(start))); // Last coordinate
-
-					if (coords.size() >= 3)
-					{
-						Position pos;
-						pos.x = coords[0];
-						pos.y = coords[1];
-						pos.z = coords[2];
-
-						// Create and send position update packet
-						auto posPacket = packetManager.createPositionUpdate(0, pos); // PlayerID not available from queue, use 0
-						packetManager.sendPacket(serverPeer, *posPacket, false);
-					}
-				}
-				catch (const std::exception& e)
-				{
-					logger.error("Failed to parse queued position: " + std::string(e.what()));
-				}
-			}
-			else if (packet.message.substr(0, 10) == "MOVE_DELTA:")
-			{
-				// Parse delta position message (more complex, would need parsing logic)
-				// For simplicity, we'll just send a full position update instead
-				logger.debug("Queued delta position updates not supported, skipping");
-			}
-			else if (packet.message.substr(0, 5) == "CHAT:")
-			{
-				// Parse chat message (CHAT:message)
-				std::string message = packet.message.substr(5);
-
-				// Create and send chat message packet
-				// Note: For simplicity, we'll use "Queued" as the sender name
-				auto chatPacket = packetManager.createChatMessage("Queued", message);
-				packetManager.sendPacket(serverPeer, *chatPacket, true);
-			}
-			else if (packet.message.substr(0, 8) == "COMMAND:")
-			{
-				// Parse command message (COMMAND:command args...)
-				std::string commandText = packet.message.substr(8);
-
-				// Split into command and args
-				std::vector<std::string> args;
-				std::string command;
-
-				size_t spacePos = commandText.find(' ');
-				if (spacePos != std::string::npos)
-				{
-					command = commandText.substr(0, spacePos);
-
-					// Parse arguments
-					std::string argsStr = commandText.substr(spacePos + 1);
-					std::istringstream iss(argsStr);
-					std::string arg;
-
-					while (iss >> arg)
-					{
-						args.push_back(arg);
-					}
-				}
-				else
-				{
-					command = commandText;
-				}
-
-				// Create and send command packet
-				auto commandPacket = packetManager.createCommand(command, args);
-				packetManager.sendPacket(serverPeer, *commandPacket, true);
-			}
-			else
-			{
-				// Unknown packet type, log and skip
-				logger.warning("Unknown queued packet type: " + packet.message.substr(0, 20) + "...");
+				break;
 			}
 		}
 
-		// Small delay between batches
-		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		shapeAndSend(serverPeer, std::move(packet.data), packet.type, packet.reliable);
 	}
 
 	// Log results - get queue count locally
@@ -947,19 +854,20 @@ void NetworkManager::clearPacketQueue()
 	threadManager->scheduleResourceTask({ GameResources::queueResourceId },
 	        [this]()
 	        {
-		        std::priority_queue<QueuedPacket> empty;
-		        std::swap(outgoingQueue, empty);
+		        std::lock_guard<std::mutex> guard(queueMutex);
+		        outgoingQueue.clear();
 		        logger.debug("Packet queue cleared");
 	        });
 }
 
 size_t NetworkManager::getQueuedPacketCount()
 {
+	std::lock_guard<std::mutex> guard(queueMutex);
 	return outgoingQueue.size();
 }
 
 // The update method needs refactoring to use ThreadManager
-void NetworkManager::update(const std::function<void()>& updatePositionCallback, const std::function<void(const ENetPacket*)>& handlePacketCallback, const std::function<void()>& disconnectCallback)
+void NetworkManager::update(const std::function<void()>& updatePositionCallback, const std::function<void()>& disconnectCallback)
 {
 	// Update bandwidth stats (no ENet operations)
 	updateBandwidthStats();
@@ -976,19 +884,83 @@ void NetworkManager::update(const std::function<void()>& updatePositionCallback,
 		return;
 	}
 
+	// With a network thread running, it services ENet; the frame loop only drives game-level sends
+	if (!networkThreadRunning && !pumpEvents(0, disconnectCallback))
+	{
+		return;
+	}
+
+	// Call position update callback without blocking
+	if (updatePositionCallback)
+	{
+		// Check if still connected before scheduling
+		bool shouldUpdatePosition = false;
+		{
+			std::lock_guard<std::mutex> guard(connectionStateMutex);
+			shouldUpdatePosition = isConnected && connectionState == ConnectionState::CONNECTED;
+		}
+
+		if (shouldUpdatePosition)
+		{
+			threadManager->scheduleTask(updatePositionCallback);
+		}
+	}
+
+	// Send the position the shaper held back once the budget allows
+	flushHeldPosition();
+
+	// Check heartbeat
+	uint64_t currentTime = getCurrentTimeMs();
+	bool shouldSendHeartbeat = false;
+
+	{
+		std::lock_guard<std::mutex> guard(connectionStateMutex);
+		uint64_t timeSinceLastHeartbeat = currentTime - lastHeartbeatSent;
+		shouldSendHeartbeat = timeSinceLastHeartbeat >= heartbeatIntervalMs;
+	}
+
+	if (shouldSendHeartbeat)
+	{
+		sendHeartbeat();
+	}
+}
+
+// Service ENet: flush deferred sends, then drain received events into the incoming queue
+// Returns false if the connection was lost
+bool NetworkManager::pumpEvents(uint32_t waitMs, const std::function<void()>& disconnectCallback)
+{
 	// Process network events - needs enetMutex
 	std::lock_guard<std::mutex> enetGuard(enetMutex);
 
-	int eventCount = 0;
+	// Hand over anything other threads queued while the host was busy
+	packetManager.flushDeferredSends();
+
+	uint32_t eventCount = 0;
 	int errorCount = 0;
-	const int MAX_EVENTS_PER_UPDATE = 10;
 	const int MAX_ERRORS_PER_UPDATE = 3;
 
-	// Use a 0 timeout to ensure we don't block
-	while (eventCount < MAX_EVENTS_PER_UPDATE && errorCount < MAX_ERRORS_PER_UPDATE)
+	// Drain until ENet is empty or the time budget is spent, so a busy server can't build up a backlog a few events per frame at a time
+	const auto pumpStart = std::chrono::steady_clock::now();
+	const auto pumpBudget = std::chrono::microseconds(receivePumpBudgetUs);
+
+	while (errorCount < MAX_ERRORS_PER_UPDATE)
 	{
+		if (eventCount > 0 && std::chrono::steady_clock::now() - pumpStart >= pumpBudget)
+		{
+			pumpBudgetExhausted++;
+			break;
+		}
+
+		// Leave events in ENet rather than drop them if the game thread hasn't drained the queue
+		if (incomingPackets.isFull())
+		{
+			incomingQueueStalls++;
+			break;
+		}
+
+		// Only the first call may block, and only when asked to
 		ENetEvent event;
-		int serviceResult = enet_host_service(client, &event, 0);
+		int serviceResult = enet_host_service(client, &event, eventCount == 0 && errorCount == 0 ? waitMs : 0);
 
 		if (serviceResult > 0)
 		{
@@ -998,102 +970,55 @@ void NetworkManager::update(const std::function<void()>& updatePositionCallback,
 			{
 				case ENET_EVENT_TYPE_RECEIVE:
 				{
+					// Stamp arrival first so Pong samples aren't skewed by parsing
+					const uint64_t receiveTime = GameProtocol::getMonotonicTimeUs();
+
 					// Update stats
 					packetsReceived++;
 					bytesReceived += event.packet->dataLength;
 					bandwidthStats.bytesReceivedLastSecond += event.packet->dataLength;
 					lastNetworkActivity = getCurrentTimeMs();
 
-					// Try to process the packet with the PacketManager
-					auto receivedPacket = packetManager.receivePacket(event.packet);
+					// Decode once; the typed packet is all that travels further
+					auto receivedPacket = packetManager.receivePacket(event.packet, event.peer);
+
+					enet_packet_destroy(event.packet);
 
-					if (receivedPacket)
+					if (!receivedPacket)
 					{
-						// Successfully parsed as a structured packet
-						// logger.info("Received packet of type: " + GameProtocol::getPacketTypeName(receivedPacket->getType())); // Uncomment when debugging
-
-						// Check if it's a packet we handle internally
-						switch (receivedPacket->getType())
-						{
-							case GameProtocol::PacketType::AuthResponse:
-								// Handle auth response
-								if (authManager)
-								{
-									// Forward to auth manager
-									authManager->processAuthResponse(event.packet->data, event.packet->dataLength, nullptr, nullptr);
-								}
-								break;
-
-							case GameProtocol::PacketType::Heartbeat:
-								// Handle heartbeat as ping response
-								if (waitingForPingResponse)
-								{
-									// Process ping response
-									uint64_t currentTime = getCurrentTimeMs();
-									uint32_t pingTime = static_cast<uint32_t>(currentTime - lastPingSentTime);
-									pingMs = pingTime;
-									waitingForPingResponse = false;
-
-									// Reset failure counter on successful ping
-									successivePingFailures = 0;
-
-									// Adaptively decrease timeout
-									if (adaptiveTimeoutMultiplier > 1 && pingTime * 3 < serverResponseTimeout)
-									{
-										adaptiveTimeoutMultiplier--;
-										serverResponseTimeout = initialServerResponseTimeout * adaptiveTimeoutMultiplier;
-										logger.debug("Decreased server response timeout to " + std::to_string(serverResponseTimeout) + "ms");
-									}
-
-									// Update ping statistics
-									updatePingStatistics(pingTime);
-								}
-								break;
-
-							default:
-								// Pass to the callback handler if provided
-								if (handlePacketCallback)
-								{
-									try
-									{
-										// Schedule in thread pool to avoid blocking
-										// create a copy of the packet before passing it to the callback as the packet could be destroyed before the callback is executed
-										ENetPacket* packetCopy = enet_packet_create(event.packet->data, event.packet->dataLength, event.packet->flags);
-										threadManager->scheduleNetworkTask([callback = handlePacketCallback, packet = packetCopy]() { callback(packet); });
-									}
-									catch (std::exception& e)
-									{
-										logger.error("Error in packet callback: " + std::string(e.what()));
-									}
-								}
-								break;
-						}
+						break;
 					}
-					else
+
+					// logger.info("Received packet of type: " + GameProtocol::getPacketTypeName(receivedPacket->getType())); // Uncomment when debugging
+
+					// Handle network-level packets here, everything else goes to the game thread in arrival order
+					switch (receivedPacket->getType())
 					{
-						// Not a recognized structured packet, pass to callback
-						if (handlePacketCallback)
-						{
-							try
+						case GameProtocol::PacketType::AuthResponse:
+							if (authManager)
 							{
-								// Schedule in thread pool to avoid blocking
-								// create a copy of the packet before passing it to the callback as the packet could be destroyed before the callback is executed
-								ENetPacket* packetCopy = enet_packet_create(event.packet->data, event.packet->dataLength, event.packet->flags);
-								threadManager->scheduleNetworkTask([callback = handlePacketCallback, packet = packetCopy]() { callback(packet); });
+								authManager->processAuthResponse(static_cast<const GameProtocol::AuthResponsePacket&>(*receivedPacket), nullptr, nullptr);
 							}
-							catch (std::exception& e)
+							break;
+
+						case GameProtocol::PacketType::Pong:
+							handlePong(static_cast<const GameProtocol::PongPacket&>(*receivedPacket), receiveTime);
+							break;
+
+						default:
+							// Space was checked before servicing this event, so this is only a safety net
+							if (!incomingPackets.tryPush(std::move(receivedPacket)))
 							{
-								logger.error("Error in packet callback: " + std::string(e.what()));
+								logger.warning("Incoming packet queue full, dropped packet");
 							}
-						}
+							break;
 					}
-
-					enet_packet_destroy(event.packet);
 					break;
 				}
 
 				case ENET_EVENT_TYPE_DISCONNECT:
 					logger.warning("Disconnected from server");
+					packetManager.removeSecureChannel(event.peer);
 
 					// Schedule disconnect callback
 					if (disconnectCallback)
@@ -1109,7 +1034,7 @@ void NetworkManager::update(const std::function<void()>& updatePositionCallback,
 						server = nullptr;
 					}
 
-					return; // Exit early on disconnect
+					return false; // Exit early on disconnect
 
 				default:
 					break;
@@ -1139,36 +1064,79 @@ void NetworkManager::update(const std::function<void()>& updatePositionCallback,
 		}
 	}
 
-	// Call position update callback without blocking
-	if (updatePositionCallback)
+	// Record how much was left behind in ENet for the diagnostics
+	uint32_t backlog = 0;
+	if (server != nullptr)
 	{
-		// Check if still connected before scheduling
-		bool shouldUpdatePosition = false;
+		for (ENetListIterator it = enet_list_begin(&server->dispatchedCommands); it != enet_list_end(&server->dispatchedCommands); it = enet_list_next(it))
 		{
-			std::lock_guard<std::mutex> guard(connectionStateMutex);
-			shouldUpdatePosition = isConnected && connectionState == ConnectionState::CONNECTED;
+			backlog++;
 		}
+	}
+	lastPumpEvents = eventCount;
+	peakPumpEvents = (std::max)(peakPumpEvents.load(), eventCount);
+	receiveBacklog = backlog;
+	peakReceiveBacklog = (std::max)(peakReceiveBacklog.load(), backlog);
 
-		if (shouldUpdatePosition)
-		{
-			threadManager->scheduleTask(updatePositionCallback);
-		}
+	return true;
+}
+
+// Dedicated network thread: services ENet at a high rate regardless of how long frames take
+void NetworkManager::startNetworkThread(const std::function<void()>& disconnectCallback)
+{
+	if (networkThreadRunning)
+	{
+		return;
 	}
 
-	// Check heartbeat
-	uint64_t currentTime = getCurrentTimeMs();
-	bool shouldSendHeartbeat = false;
+	// Sends from other threads are queued from now on and flushed by the network thread
+	packetManager.setDeferredSends(true);
+	networkThreadRunning = true;
+
+	networkThread = std::thread(
+	        [this, disconnectCallback]()
+	        {
+		        logger.debug("Network thread started");
+
+		        while (networkThreadRunning)
+		        {
+			        bool currentlyConnected = false;
+			        {
+				        std::lock_guard<std::mutex> guard(connectionStateMutex);
+				        currentlyConnected = isConnected && client != nullptr && connectionState == ConnectionState::CONNECTED;
+			        }
+
+			        if (!currentlyConnected)
+			        {
+				        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				        continue;
+			        }
+
+			        // Blocks for at most networkThreadWaitMs, returning as soon as a packet arrives
+			        pumpEvents(networkThreadWaitMs, disconnectCallback);
+		        }
 
+		        logger.debug("Network thread stopped");
+	        });
+}
+
+void NetworkManager::stopNetworkThread()
+{
+	if (!networkThreadRunning)
 	{
-		std::lock_guard<std::mutex> guard(connectionStateMutex);
-		uint64_t timeSinceLastHeartbeat = currentTime - lastHeartbeatSent;
-		shouldSendHeartbeat = timeSinceLastHeartbeat >= heartbeatIntervalMs;
+		return;
 	}
 
-	if (shouldSendHeartbeat)
+	networkThreadRunning = false;
+	if (networkThread.joinable())
 	{
-		sendHeartbeat();
+		networkThread.join();
 	}
+
+	// Send whatever was still queued, then go back to sending directly
+	std::lock_guard<std::mutex> enetGuard(enetMutex);
+	packetManager.setDeferredSends(false);
+	packetManager.flushDeferredSends();
 }
 
 void NetworkManager::sendHeartbeat()
@@ -1186,7 +1154,7 @@ void NetworkManager::sendHeartbeat()
 
 	// Create and send a heartbeat packet
 	auto heartbeatPacket = packetManager.createHeartbeat(static_cast<uint32_t>(currentTime));
-	packetManager.sendPacket(serverPeer, *heartbeatPacket, false); // Using unreliable for heartbeats
+	shapeAndSend(serverPeer, heartbeatPacket->serialize(), heartbeatPacket->getType(), false); // Using unreliable for heartbeats
 }
 
 void NetworkManager::sendPing()
@@ -1202,12 +1170,15 @@ void NetworkManager::sendPing()
 	bool shouldLogTimeout = false;
 	uint32_t currentPingSequence = 0;
 
-	// Use ThreadManager to check and update ping-related state
-	threadManager->scheduleResourceTask({ GameResources::networkResourceId },
-	        [this, currentTime, &shouldSendPing, &shouldLogTimeout, &currentPingSequence]()
+	// Ping quickly until the clock estimate settles
+	const uint32_t interval = isClockSynchronized() ? pingIntervalMs : syncPingIntervalMs;
+
+	// Check and update ping-related state, waiting for the result since it fills the locals above
+	threadManager->scheduleResourceTaskWithResult<void>({ GameResources::networkResourceId },
+	        [this, currentTime, interval, &shouldSendPing, &shouldLogTimeout, &currentPingSequence]()
 	        {
 		        // Check if it's time to send a ping
-		        if (currentTime - lastPingTime >= pingIntervalMs)
+		        if (currentTime - lastPingTime >= interval)
 		        {
 			        lastPingTime = currentTime;
 			        lastPingSentTime = currentTime;
@@ -1262,7 +1233,8 @@ void NetworkManager::sendPing()
 				        }
 			        }
 		        }
-	        });
+	        })
+	        .get();
 
 	// Send ping with sequence number if needed
 	if (shouldSendPing)
@@ -1274,11 +1246,11 @@ void NetworkManager::sendPing()
 			return;
 		}
 
-		// Create heartbeat packet with current time as client time
-		auto heartbeatPacket = packetManager.createHeartbeat(static_cast<uint32_t>(currentTime));
+		// Stamp with the monotonic clock the Pong timestamps are compared against
+		auto pingPacket = packetManager.createPing(currentPingSequence, GameProtocol::getMonotonicTimeUs());
 
-		// Send the packet reliably for better detection
-		packetManager.sendPacket(serverPeer, *heartbeatPacket, true);
+		// Unreliable, a retransmitted ping would inflate the measured RTT
+		shapeAndSend(serverPeer, pingPacket->serialize(), pingPacket->getType(), false);
 	}
 
 	// Handle ping timeout
@@ -1288,6 +1260,54 @@ void NetworkManager::sendPing()
 	}
 }
 
+// Feed a Pong into the clock estimator and ping statistics
+void NetworkManager::handlePong(const GameProtocol::PongPacket& pong, uint64_t receiveTime)
+{
+	// Truncated pongs (or echoes of truncated pings) arrive empty
+	if (pong.clientSendTime == 0)
+	{
+		return;
+	}
+
+	uint32_t pingTime = 0;
+	{
+		std::lock_guard<std::mutex> guard(clockSyncMutex);
+		if (!clockSync.addSample(pong.clientSendTime, pong.serverReceiveTime, pong.serverSendTime, receiveTime))
+		{
+			logger.debug("Discarded inconsistent pong " + std::to_string(pong.sequence));
+			return;
+		}
+
+		// Network round trip, excluding time spent on the server
+		pingTime = static_cast<uint32_t>(((receiveTime - pong.clientSendTime) - (pong.serverSendTime - pong.serverReceiveTime) + 500) / 1000);
+	}
+
+	threadManager->scheduleResourceTask({ GameResources::networkResourceId },
+	        [this, pingTime, sequence = pong.sequence]()
+	        {
+		        // Late pongs still improve the clock estimate but don't answer the outstanding ping
+		        if (!waitingForPingResponse || sequence != pingSequence)
+			        return;
+
+		        pingMs = pingTime;
+		        waitingForPingResponse = false;
+
+		        // Reset failure counter on successful ping
+		        successivePingFailures = 0;
+
+		        // Adaptively decrease timeout
+		        if (adaptiveTimeoutMultiplier > 1 && pingTime * 3 < serverResponseTimeout)
+		        {
+			        adaptiveTimeoutMultiplier--;
+			        serverResponseTimeout = initialServerResponseTimeout * adaptiveTimeoutMultiplier;
+			        logger.debug("Decreased server response timeout to " + std::to_string(serverResponseTimeout) + "ms");
+		        }
+	        });
+
+	// Update ping statistics
+	updatePingStatistics(pingTime);
+}
+
 // Connection health checking
 void NetworkManager::checkConnectionHealth()
 {
@@ -1351,6 +1371,8 @@ void NetworkManager::updateBandwidthStats()
 	threadManager->scheduleResourceTask({ GameResources::bandwidthResourceId },
 	        [this, currentTime]()
 	        {
+		        std::lock_guard<std::mutex> guard(bandwidthMutex);
+
 		        // Check if we've moved to a new second
 		        if (bandwidthStats.currentSecondStart == 0)
 		        {
@@ -1407,7 +1429,7 @@ void NetworkManager::updateBandwidthStats()
 					        bandwidthThrottlingEnabled = true;
 				        }
 			        }
-			        else if (bandwidthThrottlingEnabled && bandwidthStats.averageSendRateBps < throttledOutgoingLimit * 0.7f)
+			        else if (bandwidthThrottlingEnabled && serverThrottleLevel == 0 && bandwidthStats.averageSendRateBps < throttledOutgoingLimit * 0.7f)
 			        {
 				        logger.info("Bandwidth usage normalized, disabling throttling");
 				        bandwidthThrottlingEnabled = false;
@@ -1416,97 +1438,185 @@ void NetworkManager::updateBandwidthStats()
 	        });
 }
 
-// Check if packet send is allowed based on bandwidth constraints
-bool NetworkManager::isPacketSendAllowed(const std::string& message, float size)
+// Send serialized bytes to the server through the bandwidth shaper
+void NetworkManager::shapeAndSend(ENetPeer* peer, std::vector<uint8_t>&& data, GameProtocol::PacketType type, bool reliable)
 {
-	// Access bandwidth settings without blocking
-	std::lock_guard<std::mutex> guard(bandwidthMutex);
+	const MessageTypeConfig config = getMessageConfig(type);
+	const bool isPosition = type == GameProtocol::PacketType::PositionUpdate || type == GameProtocol::PacketType::DeltaPositionUpdate;
 
-	if (outgoingBandwidthLimit == 0)
 	{
-		return true; // No limit set
-	}
+		std::lock_guard<std::mutex> guard(bandwidthMutex);
+		ShaperStats& stats = shaperStats[static_cast<size_t>(config.category)];
 
-	uint64_t currentTime = getCurrentTimeMs();
+		// Reliable and critical packets always go out; the rest wait for the budget
+		const bool mustSend = reliable || config.category == MessageCategory::CRITICAL;
+		if (!reserveBandwidth(config, static_cast<float>(data.size()), mustSend, getCurrentTimeMs()))
+		{
+			if (isPosition)
+			{
+				// Positions are absolute, so only the newest one needs to wait for flushHeldPosition()
+				if (!heldPosition.empty())
+				{
+					stats.mergedPackets++;
+					stats.mergedBytes += heldPosition.size();
+				}
+				heldPosition = std::move(data);
+				heldPositionType = type;
+			}
+			else
+			{
+				stats.droppedPackets++;
+				stats.droppedBytes += data.size();
+			}
+			return;
+		}
+
+		if (isPosition && !heldPosition.empty())
+		{
+			stats.mergedPackets++;
+			stats.mergedBytes += heldPosition.size();
+			heldPosition.clear();
+		}
+		recordSent(config, data.size());
+	}
 
-	// Get message type config
-	MessageTypeConfig config = getMessageConfig(message);
+	packetManager.sendSerialized(peer, std::move(data), type, reliable);
+}
 
-	// Critical messages always pass
-	if (config.category == MessageCategory::CRITICAL)
+void NetworkManager::flushHeldPosition()
+{
+	ENetPeer* serverPeer = getServerPeer();
+	if (!serverPeer)
 	{
-		return true;
+		return;
 	}
 
-	// Check if we need to throttle this message
-	if (bandwidthThrottlingEnabled && config.canThrottle)
+	std::vector<uint8_t> data;
+	GameProtocol::PacketType type;
 	{
-		// Check category token bucket first
-		TokenBucket& categoryBucket = categoryTokenBuckets[config.category];
-		if (!categoryBucket.consumeTokens(size * config.throttleMultiplier, currentTime))
+		std::lock_guard<std::mutex> guard(bandwidthMutex);
+		if (heldPosition.empty())
 		{
-			return false;
+			return;
 		}
+
+		const MessageTypeConfig config = getMessageConfig(heldPositionType);
+		if (!reserveBandwidth(config, static_cast<float>(heldPosition.size()), false, getCurrentTimeMs()))
+		{
+			return;
+		}
+
+		data.swap(heldPosition);
+		type = heldPositionType;
+		recordSent(config, data.size());
 	}
 
-	// Check global token bucket
-	return bandwidthTokenBucket.consumeTokens(size, currentTime);
+	packetManager.sendSerialized(serverPeer, std::move(data), type, false);
 }
 
-// Get message configuration
-MessageTypeConfig NetworkManager::getMessageConfig(const std::string& message)
+// Charge a packet to the global and category budgets, caller holds bandwidthMutex.
+// Packets that must go out are charged even if that leaves a bucket in debt.
+bool NetworkManager::reserveBandwidth(const MessageTypeConfig& config, float size, bool mustSend, uint64_t currentTime)
 {
-	// Default configuration
-	MessageTypeConfig defaultConfig = { MessageCategory::MISC, PRIORITY_NORMAL, true, 0.5f };
+	if (outgoingBandwidthLimit == 0 && serverThrottleLevel == 0)
+	{
+		return true; // No limit set
+	}
 
-	// Find the appropriate configuration for this message type
-	for (const auto& configPair: messageTypeConfigs)
+	// While throttled, a throttleable category only gets throttleMultiplier of its budget
+	float categoryCost = size;
+	if (bandwidthThrottlingEnabled && config.canThrottle && config.throttleMultiplier > 0.0f)
 	{
-		if (!configPair.first.empty() && message.find(configPair.first) == 0)
-		{
-			return configPair.second;
-		}
+		categoryCost = size / config.throttleMultiplier;
 	}
 
-	return defaultConfig;
+	TokenBucket& categoryBucket = categoryTokenBuckets[config.category];
+	categoryBucket.refill(currentTime);
+	bandwidthTokenBucket.refill(currentTime);
+
+	if (!mustSend && (categoryBucket.tokens < categoryCost || bandwidthTokenBucket.tokens < size))
+	{
+		return false;
+	}
+
+	categoryBucket.take(categoryCost);
+	bandwidthTokenBucket.take(size);
+	return true;
+}
+
+// Count a packet that passed the shaper, caller holds bandwidthMutex
+void NetworkManager::recordSent(const MessageTypeConfig& config, size_t size)
+{
+	ShaperStats& stats = shaperStats[static_cast<size_t>(config.category)];
+	stats.sentPackets++;
+	stats.sentBytes += size;
+
+	packetsSent++;
+	bytesSent += size;
+	bandwidthStats.bytesSentLastSecond += size;
+}
+
+std::array<ShaperStats, MESSAGE_CATEGORY_COUNT> NetworkManager::getShaperStats() const
+{
+	std::lock_guard<std::mutex> guard(bandwidthMutex);
+	return shaperStats;
+}
+
+// Get message configuration
+MessageTypeConfig NetworkManager::getMessageConfig(GameProtocol::PacketType type)
+{
+	auto it = messageTypeConfigs.find(type);
+	if (it != messageTypeConfigs.end())
+	{
+		return it->second;
+	}
+
+	// Default configuration
+	return { MessageCategory::MISC, PRIORITY_NORMAL, true, 0.5f };
 }
 
 // Configure a message type
-void NetworkManager::configureMessageType(const std::string& prefix, uint8_t priority, bool canThrottle, float throttleMultiplier)
+void NetworkManager::configureMessageType(GameProtocol::PacketType type, uint8_t priority, bool canThrottle, float throttleMultiplier)
 {
 	threadManager->scheduleResourceTask({ GameResources::configResourceId },
-	        [this, prefix, priority, canThrottle, throttleMultiplier]()
+	        [this, type, priority, canThrottle, throttleMultiplier]()
 	        {
-		        // Determine message category based on prefix
+		        // Determine message category based on packet type
 		        MessageCategory category;
-		        if (prefix == "AUTH:" || prefix == "PING:" || prefix == "PONG:" || prefix == "HEARTBEAT")
-		        {
-			        category = MessageCategory::CRITICAL;
-		        }
-		        else if (prefix == "POSITION:" || prefix == "MOVE_DELTA:")
-		        {
-			        category = MessageCategory::POSITION;
-		        }
-		        else if (prefix == "CHAT:")
-		        {
-			        category = MessageCategory::CHAT;
-		        }
-		        else if (prefix == "TELEMETRY:")
-		        {
-			        category = MessageCategory::TELEMETRY;
-		        }
-		        else if (prefix == "COMMAND:" || prefix == "ACTION:" || prefix == "COMBAT:")
-		        {
-			        category = MessageCategory::GAMEPLAY;
-		        }
-		        else
+		        switch (type)
 		        {
-			        category = MessageCategory::MISC;
+			        case GameProtocol::PacketType::AuthRequest:
+			        case GameProtocol::PacketType::Registration:
+			        case GameProtocol::PacketType::Disconnect:
+			        case GameProtocol::PacketType::Heartbeat:
+			        case GameProtocol::PacketType::Ping:
+				        category = MessageCategory::CRITICAL;
+				        break;
+
+			        case GameProtocol::PacketType::PositionUpdate:
+			        case GameProtocol::PacketType::DeltaPositionUpdate:
+				        category = MessageCategory::POSITION;
+				        break;
+
+			        case GameProtocol::PacketType::ChatMessage:
+			        case GameProtocol::PacketType::SystemMessage:
+			        case GameProtocol::PacketType::Whisper:
+				        category = MessageCategory::CHAT;
+				        break;
+
+			        case GameProtocol::PacketType::Command:
+			        case GameProtocol::PacketType::Teleport:
+				        category = MessageCategory::GAMEPLAY;
+				        break;
+
+			        default:
+				        category = MessageCategory::MISC;
+				        break;
 		        }
 
-		        messageTypeConfigs[prefix] = { category, priority, canThrottle, throttleMultiplier };
+		        messageTypeConfigs[type] = { category, priority, canThrottle, throttleMultiplier };
 
-		        logger.debug("Configured message type: prefix=\"" + prefix + "\", category=" + std::to_string(static_cast<int>(category)) + ", priority=" + std::to_string(priority) + ", canThrottle=" + (canThrottle ? "true" : "false") + ", throttleMultiplier=" + std::to_string(throttleMultiplier));
+		        logger.debug("Configured message type: type=" + GameProtocol::getPacketTypeName(type) + ", category=" + std::to_string(static_cast<int>(category)) + ", priority=" + std::to_string(priority) + ", canThrottle=" + (canThrottle ? "true" : "false") + ", throttleMultiplier=" + std::to_string(throttleMultiplier));
 	        });
 }
 
@@ -1516,6 +1626,7 @@ void NetworkManager::configureBandwidthManagement(size_t outgoingLimitBps, size_
 	threadManager->scheduleResourceTask({ GameResources::bandwidthResourceId },
 	        [this, outgoingLimitBps, throttledLimitBps, enableThrottling]()
 	        {
+		        std::lock_guard<std::mutex> guard(bandwidthMutex);
 		        outgoingBandwidthLimit = outgoingLimitBps;
 		        throttledOutgoingLimit = throttledLimitBps;
 		        bandwidthThrottlingEnabled = enableThrottling;
@@ -1565,6 +1676,10 @@ void NetworkManager::setPacketQueueing(bool enabled, size_t maxSize, uint32_t ma
 	        {
 		        queuePacketsDuringDisconnection = enabled;
 		        maxQueueSize = maxSize;
+		        {
+			        std::lock_guard<std::mutex> guard(queueMutex);
+			        outgoingQueue.setCapacity(maxSize);
+		        }
 		        maxQueuedPacketAge = maxAgeMs;
 
 		        logger.debug("Packet queueing " + std::string(enabled ? "enabled" : "disabled") + ", maxSize=" + std::to_string(maxSize) + ", maxAge=" + std::to_string(maxAgeMs) + "ms");
@@ -1791,6 +1906,41 @@ void NetworkManager::estimatePacketLoss()
 	diagnostics.packetLossPercentage = static_cast<uint32_t>(packetLossEstimate * 100.0f);
 }
 
+// Hand decoded packets to the game thread in the order they arrived
+// World state chunks from snapshots older than the newest one in the batch are skipped, it replaces them anyway
+size_t NetworkManager::processIncomingPackets(const std::function<void(const GameProtocol::Packet&)>& handler)
+{
+	auto isWorldState = [](GameProtocol::PacketType type) { return type == GameProtocol::PacketType::WorldState || type == GameProtocol::PacketType::CompactWorldState; };
+
+	incomingBatch.clear();
+	uint32_t newestSnapshotId = 0;
+	std::unique_ptr<GameProtocol::Packet> packet;
+	while (incomingPackets.tryPop(packet))
+	{
+		if (isWorldState(packet->getType()))
+		{
+			newestSnapshotId = (std::max)(newestSnapshotId, static_cast<const GameProtocol::WorldStatePacket&>(*packet).snapshotId);
+		}
+		incomingBatch.push_back(std::move(packet));
+	}
+
+	size_t processed = 0;
+	for (const auto& batched: incomingBatch)
+	{
+		if (isWorldState(batched->getType()) && static_cast<const GameProtocol::WorldStatePacket&>(*batched).snapshotId < newestSnapshotId)
+		{
+			supersededWorldStates++;
+			continue;
+		}
+
+		handler(*batched);
+		processed++;
+	}
+
+	incomingBatch.clear();
+	return processed;
+}
+
 // Process a received packet
 bool NetworkManager::processReceivedPacket(const void* packetData, size_t packetLength)
 {
@@ -1812,7 +1962,7 @@ bool NetworkManager::processReceivedPacket(const void* packetData, size_t packet
 		if (authManager)
 		{
 			// Forward to auth manager and return true if processed
-			authManager->processAuthResponse(packetData, packetLength, nullptr, nullptr);
+			authManager->processAuthResponse(static_cast<const GameProtocol::AuthResponsePacket&>(*packet), nullptr, nullptr);
 			return true;
 		}
 	}
@@ -2097,6 +2247,28 @@ std::string NetworkManager::generateDiagnosticsReport()
 			                report << "N/A\n";
 		                }
 
+		                // Clock sync
+		                {
+			                std::lock_guard<std::mutex> guard(clockSyncMutex);
+			                report << "\n--- Clock Sync ---\n";
+			                report << "Synchronized: " << (clockSync.isSynchronized() ? "Yes" : "No") << "\n";
+			                report << "Server Offset: " << (clockSync.getOffsetUs() / 1000.0) << "ms\n";
+			                report << "RTT: " << (clockSync.getRttUs() / 1000.0) << "ms (jitter " << (clockSync.getJitterUs() / 1000.0) << "ms)\n";
+			                report << "Samples: " << clockSync.getSampleCount() << " (" << clockSync.getRejectedSampleCount() << " rejected)\n";
+		                }
+
+		                // Encryption
+		                if (auto secure = packetManager.getSecureChannel(server))
+		                {
+			                report << "\n--- Encryption ---\n";
+			                report << "Secure Channel: AES-256-GCM\n";
+			                report << "Sealed: " << secure->getSealedCount() << ", Opened: " << secure->getOpenedCount() << ", Rejected: " << secure->getRejectedCount() << "\n";
+		                }
+		                else
+		                {
+			                report << "\n--- Encryption ---\nSecure Channel: None\n";
+		                }
+
 		                // Packet statistics
 		                report << "\n--- Packet Statistics ---\n";
 		                report << "Packets Sent: " << packetsSent << "\n";
@@ -2104,7 +2276,22 @@ std::string NetworkManager::generateDiagnosticsReport()
 		                report << "Bytes Sent: " << bytesSent << " bytes\n";
 		                report << "Bytes Received: " << bytesReceived << " bytes\n";
 		                report << "Estimated Packet Loss: " << diagnostics.packetLossPercentage << "%\n";
-		                report << "Queued Packets: " << outgoingQueue.size() << "\n";
+		                {
+			                std::lock_guard<std::mutex> guard(queueMutex);
+			                report << "Queued Packets: " << outgoingQueue.size() << " (" << outgoingQueue.getCoalescedCount() << " position updates coalesced, " << outgoingQueue.getDroppedCount() << " dropped)\n";
+		                }
+		                {
+			                const auto allocator = PooledAllocator::getCounters();
+			                report << "ENet Allocations: " << allocator.allocations << " (" << allocator.frees << " freed, " << allocator.cacheMisses << " pool refills, " << allocator.largeAllocations << " large, "
+			                       << allocator.bytesReserved / 1024 << " KB reserved)\n";
+		                }
+		                report << "\n--- Receive Pump ---\n";
+		                report << "Network Thread: " << (networkThreadRunning ? "Running (" + std::to_string(networkThreadWaitMs) + "ms wait)" : std::string("Off, serviced per frame")) << "\n";
+		                report << "Budget: " << receivePumpBudgetUs << "us per update (" << pumpBudgetExhausted << " times exhausted)\n";
+		                report << "Events Last Update: " << lastPumpEvents << " (peak " << peakPumpEvents << ")\n";
+		                report << "ENet Backlog: " << receiveBacklog << " (peak " << peakReceiveBacklog << ")\n";
+		                report << "Incoming Queue: " << incomingPackets.size() << "/" << incomingPackets.capacity() << " (" << incomingQueueStalls << " stalls)\n";
+		                report << "Superseded World States: " << supersededWorldStates << "\n";
 
 		                // Bandwidth usage
 		                report << "\n--- Bandwidth Usage ---\n";
@@ -2116,6 +2303,27 @@ std::string NetworkManager::generateDiagnosticsReport()
 			                report << "Bandwidth Usage: " << (bandwidthStats.averageSendRateBps * 100 / outgoingBandwidthLimit) << "% of limit\n";
 		                }
 
+		                // What the outbound shaper did per message category
+		                {
+			                static const char* categoryNames[MESSAGE_CATEGORY_COUNT] = { "Critical", "Gameplay", "Position", "Chat", "Telemetry", "Misc" };
+			                std::lock_guard<std::mutex> guard(bandwidthMutex);
+			                report << "Server Throttle Level: " << serverThrottleLevel << "\n";
+			                for (size_t category = 0; category < MESSAGE_CATEGORY_COUNT; category++)
+			                {
+				                const ShaperStats& stats = shaperStats[category];
+				                if (stats.sentPackets + stats.mergedPackets + stats.droppedPackets == 0)
+				                {
+					                continue;
+				                }
+				                report << "Shaped " << categoryNames[category] << ": " << stats.sentBytes << " bytes sent (" << stats.sentPackets << " packets), " << stats.mergedBytes << " bytes merged ("
+				                       << stats.mergedPackets << "), " << stats.droppedBytes << " bytes dropped (" << stats.droppedPackets << ")\n";
+			                }
+			                if (!heldPosition.empty())
+			                {
+				                report << "Position Update Held: " << heldPosition.size() << " bytes\n";
+			                }
+		                }
+
 		                // Error tracking
 		                report << "\n--- Error Statistics ---\n";
 		                report << "Packet Creation Errors: " << diagnostics.packetCreationErrors << "\n";
@@ -2165,23 +2373,15 @@ void NetworkManager::prepareForZoneTransition()
 		        uint32_t originalTimeout = serverResponseTimeout;
 		        serverResponseTimeout = 30000; // 30 seconds for zone transition
 
-		        // Keep only critical packets in the queue
-		        std::priority_queue<QueuedPacket> tempQueue;
-
-		        while (!outgoingQueue.empty())
+		        // Keep only high and critical priority packets in the queue
+		        size_t kept = 0;
 		        {
-			        QueuedPacket packet = outgoingQueue.top();
-			        outgoingQueue.pop();
-
-			        if (packet.priority <= PRIORITY_HIGH)
-			        { // Keep only high and critical priority packets
-				        tempQueue.push(packet);
-			        }
+			        std::lock_guard<std::mutex> guard(queueMutex);
+			        outgoingQueue.keepUpToPriority(PRIORITY_HIGH);
+			        kept = outgoingQueue.size();
 		        }
 
-		        outgoingQueue = std::move(tempQueue);
-
-		        logger.info("Prepared for zone transition - increased timeout to 30s, kept " + std::to_string(outgoingQueue.size()) + " critical packets");
+		        logger.info("Prepared for zone transition - increased timeout to 30s, kept " + std::to_string(kept) + " critical packets");
 
 		        // Schedule timeout reset after zone transition using ThreadManager
 		        threadManager->scheduleTask(
@@ -2264,6 +2464,7 @@ void NetworkManager::setPriorityMode(PriorityMode mode)
 	threadManager->scheduleResourceTask({ GameResources::networkResourceId, GameResources::bandwidthResourceId },
 	        [this, mode]()
 	        {
+		        std::lock_guard<std::mutex> guard(bandwidthMutex);
 		        currentPriorityMode = mode;
 
 		        // Adjust category token buckets based on mode
@@ -2335,6 +2536,7 @@ void NetworkManager::setServerRequestedThrottling(int throttleLevel)
 	threadManager->scheduleResourceTask({ GameResources::networkResourceId, GameResources::bandwidthResourceId },
 	        [this, throttleLevel]()
 	        {
+		        std::lock_guard<std::mutex> guard(bandwidthMutex);
 		        serverThrottleLevel = throttleLevel;
 
 		        if (throttleLevel > 0)
@@ -2344,8 +2546,9 @@ void NetworkManager::setServerRequestedThrottling(int throttleLevel)
 			        if (throttleFactor < 0.1f)
 				        throttleFactor = 0.1f; // Min 10% of normal
 
-			        // Apply throttling to bandwidth limits
-			        uint32_t throttledLimit = static_cast<uint32_t>(outgoingBandwidthLimit * throttleFactor);
+			        // Apply throttling to bandwidth limits, starting from the default allocation if none was configured
+			        const size_t baseLimit = outgoingBandwidthLimit > 0 ? outgoingBandwidthLimit : 150000;
+			        uint32_t throttledLimit = static_cast<uint32_t>(baseLimit * throttleFactor);
 			        bandwidthThrottlingEnabled = true;
 			        throttledOutgoingLimit = throttledLimit;
 
@@ -2373,6 +2576,8 @@ void NetworkManager::resetStats()
 	threadManager->scheduleResourceTask({ GameResources::networkResourceId, GameResources::bandwidthResourceId },
 	        [this]()
 	        {
+		        std::lock_guard<std::mutex> guard(bandwidthMutex);
+
 		        // Reset network statistics
 		        packetsSent = 0;
 		        packetsReceived = 0;
@@ -2386,6 +2591,7 @@ void NetworkManager::resetStats()
 		        bandwidthStats.bytesReceivedLastSecond = 0;
 		        bandwidthStats.sendRateHistory.clear();
 		        bandwidthStats.receiveRateHistory.clear();
+		        shaperStats = {};
 
 		        // Reset ping stats
 		        pingHistory.clear();
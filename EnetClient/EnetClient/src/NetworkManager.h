@@ -1,20 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <enet/enet.h>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "AuthManager.h"
+#include "ClockSync.h"
 #include "Constants.h"
 #include "Logger.h"
+#include "OutboundQueue.h"
 #include "PacketManager.h"
+#include "SpscQueue.h"
 #include "ThreadManager.h"
 
 // Advanced diagnostics
@@ -62,25 +66,6 @@ struct NetworkDiagnostics
 	void reset();
 };
 
-struct QueuedPacket
-{
-	std::string message;
-	bool reliable;
-	uint64_t timestamp;
-	uint8_t priority;
-	uint32_t retryCount;
-
-	QueuedPacket(const std::string& msg, bool rel, uint8_t pri = 128)
-	      : message(msg), reliable(rel), timestamp(0), priority(pri), retryCount(0)
-	{
-	}
-
-	bool operator<(const QueuedPacket& other) const
-	{
-		return priority != other.priority ? priority > other.priority : timestamp > other.timestamp;
-	}
-};
-
 // Bandwidth management
 struct BandwidthStats
 {
@@ -105,6 +90,8 @@ enum class MessageCategory
 	MISC       // Miscellaneous
 };
 
+constexpr size_t MESSAGE_CATEGORY_COUNT = static_cast<size_t>(MessageCategory::MISC) + 1;
+
 // Message type configuration
 struct MessageTypeConfig
 {
@@ -114,6 +101,17 @@ struct MessageTypeConfig
 	float throttleMultiplier;
 };
 
+// What the outbound shaper did with one message category's traffic
+struct ShaperStats
+{
+	uint64_t sentPackets = 0;
+	uint64_t sentBytes = 0;
+	uint64_t mergedPackets = 0; // Position updates superseded while the budget was exhausted
+	uint64_t mergedBytes = 0;
+	uint64_t droppedPackets = 0;
+	uint64_t droppedBytes = 0;
+};
+
 namespace GameResources
 {
 	// Helper to create resource IDs with the right type
@@ -129,7 +127,7 @@ namespace GameResources
 	};
 
 	const ResourceId networkResourceId = create<NetworkState>("NetworkState");
-	const ResourceId queueResourceId = create<QueuedPacket>("PacketQueue");
+	const ResourceId queueResourceId = create<OutboundQueue>("PacketQueue");
 	const ResourceId bandwidthResourceId = create<BandwidthStats>("BandwidthStats");
 	const ResourceId configResourceId = create<MessageTypeConfig>("MessageConfig");
 } // namespace GameResources
@@ -156,13 +154,23 @@ public:
 
 	void updateConnectionDiagnostics(uint64_t connectStartTime);
 
-	// Packet sending
+	// Packet sending; every packet for the server goes through the bandwidth shaper
 	void sendPacket(std::shared_ptr<GameProtocol::Packet> packet, bool reliable);
-	void queuePacket(const std::string& data, bool reliable, uint8_t priority);
+	void queuePacket(GameProtocol::PacketType type, std::vector<uint8_t>&& data, bool reliable, uint8_t priority);
 	void sendPacketWithPriority(std::shared_ptr<GameProtocol::Packet> packet, bool reliable, uint8_t priority);
 
 	// Network processing
-	void update(const std::function<void()>& updatePositionCallback, const std::function<void(const ENetPacket*)>& handlePacketCallback, const std::function<void()>& disconnectCallback);
+	void update(const std::function<void()>& updatePositionCallback, const std::function<void()>& disconnectCallback);
+	size_t processIncomingPackets(const std::function<void(const GameProtocol::Packet&)>& handler);
+
+	// Optional dedicated thread that services ENet instead of update()
+	void startNetworkThread(const std::function<void()>& disconnectCallback);
+	void stopNetworkThread();
+
+	bool isNetworkThreadRunning() const
+	{
+		return networkThreadRunning;
+	}
 	void sendPing();
 	void checkConnectionHealth();
 
@@ -180,7 +188,7 @@ public:
 	void configureAdaptiveTimeout(uint32_t initial, uint32_t max, uint32_t pingFailures);
 	void configureBandwidthManagement(size_t outgoingLimitBps, size_t throttledLimitBps, bool enableThrottling);
 	void setPacketQueueing(bool enabled, size_t maxSize = 1000, uint32_t maxAgeMs = 30000);
-	void configureMessageType(const std::string& prefix, uint8_t priority, bool canThrottle, float throttleMultiplier);
+	void configureMessageType(GameProtocol::PacketType type, uint8_t priority, bool canThrottle, float throttleMultiplier);
 
 	void setReconnectAttempts(uint32_t attempts)
 	{
@@ -233,6 +241,31 @@ public:
 		return pingMs;
 	}
 
+	// Received packets ENet had ready but the last update left for the next one
+	uint32_t getReceiveBacklog() const
+	{
+		return receiveBacklog;
+	}
+
+	// Server clock estimated from Ping/Pong exchanges, microseconds
+	uint64_t getServerTimeUs() const
+	{
+		std::lock_guard<std::mutex> guard(clockSyncMutex);
+		return clockSync.toServerTime(GameProtocol::getMonotonicTimeUs());
+	}
+
+	int64_t getClockOffsetUs() const
+	{
+		std::lock_guard<std::mutex> guard(clockSyncMutex);
+		return clockSync.getOffsetUs();
+	}
+
+	bool isClockSynchronized() const
+	{
+		std::lock_guard<std::mutex> guard(clockSyncMutex);
+		return clockSync.isSynchronized();
+	}
+
 	size_t getPacketsSent() const
 	{
 		return packetsSent;
@@ -264,6 +297,7 @@ public:
 	}
 
 	size_t getQueuedPacketCount();
+	std::array<ShaperStats, MESSAGE_CATEGORY_COUNT> getShaperStats() const;
 	std::string getConnectionStateString() const;
 
 	bool isNetworkDegraded() const
@@ -342,6 +376,7 @@ private:
 	mutable std::mutex diagnosticsMutex;             // Protects diagnostics data
 	mutable std::mutex bandwidthMutex;               // Protects bandwidth management
 	mutable std::mutex queueMutex;                   // Protects the packet queue
+	mutable std::mutex clockSyncMutex;               // Protects the clock sync estimator
 	std::atomic<bool> connectionInProgress{ false }; // Prevent concurrent connection attempts
 
 	PacketManager packetManager;
@@ -379,6 +414,10 @@ private:
 	uint32_t connectionCheckInterval = 1000;
 	uint32_t heartbeatIntervalMs = 2000;
 	uint32_t pingIntervalMs = 5000;
+	uint32_t syncPingIntervalMs = 250; // Faster pings until the clock estimate has enough samples
+	uint32_t keyExchangeTimeoutMs = 2000;
+	bool encryptionEnabled = ENABLE_ENCRYPTION;
+	bool requireEncryption = REQUIRE_ENCRYPTION;
 	uint32_t reconnectAttempts = 3;
 
 	// Timeout management
@@ -403,6 +442,9 @@ private:
 	bool networkDegraded = false;
 	uint32_t pingSequence = 0;
 
+	// Server clock offset and RTT from Ping/Pong timestamps
+	GameProtocol::ClockSyncEstimator clockSync;
+
 	// Network statistics
 	size_t packetsSent = 0;
 	size_t packetsReceived = 0;
@@ -414,7 +456,7 @@ private:
 	size_t throttledOutgoingLimit = 0;
 	bool bandwidthThrottlingEnabled = false;
 
-	std::unordered_map<std::string, MessageTypeConfig> messageTypeConfigs;
+	std::unordered_map<GameProtocol::PacketType, MessageTypeConfig> messageTypeConfigs;
 
 	// Token bucket for rate limiting
 	struct TokenBucket
@@ -435,14 +477,44 @@ private:
 		{
 		}
 
-		bool consumeTokens(float amount, uint64_t currentTime);
+		void refill(uint64_t currentTime);
+
+		// May run into debt (down to one burst) for packets that have to go out anyway
+		void take(float amount)
+		{
+			tokens = (std::max)(tokens - amount, -maxTokens);
+		}
 	};
 
 	TokenBucket bandwidthTokenBucket{ 0, 0 };
 	std::unordered_map<MessageCategory, TokenBucket> categoryTokenBuckets;
 
+	// Outbound shaper state, guarded by bandwidthMutex
+	std::array<ShaperStats, MESSAGE_CATEGORY_COUNT> shaperStats{};
+	std::vector<uint8_t> heldPosition; // Newest position update the budget refused, empty if none
+	GameProtocol::PacketType heldPositionType = GameProtocol::PacketType::PositionUpdate;
+
+	// Decoded packets from update() to the game thread, popped in order by processIncomingPackets()
+	SpscQueue<std::unique_ptr<GameProtocol::Packet>> incomingPackets{ 1024 };
+	std::vector<std::unique_ptr<GameProtocol::Packet>> incomingBatch; // Consumer side only
+	std::atomic<uint64_t> incomingQueueStalls{ 0 };
+	std::atomic<uint64_t> supersededWorldStates{ 0 };
+
+	// Network thread
+	std::thread networkThread;
+	std::atomic<bool> networkThreadRunning{ false };
+	uint32_t networkThreadWaitMs = NETWORK_THREAD_WAIT_MS;
+
+	// Receive pump
+	uint32_t receivePumpBudgetUs = 2000;
+	std::atomic<uint32_t> lastPumpEvents{ 0 };
+	std::atomic<uint32_t> peakPumpEvents{ 0 };
+	std::atomic<uint32_t> receiveBacklog{ 0 };
+	std::atomic<uint32_t> peakReceiveBacklog{ 0 };
+	std::atomic<uint64_t> pumpBudgetExhausted{ 0 };
+
 	// Packet queuing system
-	std::priority_queue<QueuedPacket> outgoingQueue;
+	OutboundQueue outgoingQueue;
 	bool queuePacketsDuringDisconnection = true;
 	size_t maxQueueSize = 1000;
 	uint32_t maxQueuedPacketAge = 30000;
@@ -476,12 +548,18 @@ private:
 	void sendCommand(const std::string& command, const std::vector<std::string>& args);
 	void sendTeleport(const Position& position);
 	void updateBandwidthStats();
-	bool isPacketSendAllowed(const std::string& message, float size);
-	MessageTypeConfig getMessageConfig(const std::string& message);
+	void shapeAndSend(ENetPeer* peer, std::vector<uint8_t>&& data, GameProtocol::PacketType type, bool reliable);
+	void flushHeldPosition();
+	bool reserveBandwidth(const MessageTypeConfig& config, float size, bool mustSend, uint64_t currentTime);
+	void recordSent(const MessageTypeConfig& config, size_t size);
+	MessageTypeConfig getMessageConfig(GameProtocol::PacketType type);
 	void sendHeartbeat();
 	void cleanExpiredPackets();
 	std::string compressMessage(const std::string& message, float* ratio = nullptr);
 	std::string decompressMessage(const std::string& compressedData);
+	void handlePong(const GameProtocol::PongPacket& pong, uint64_t receiveTime);
+	bool establishSecureChannel();
+	bool pumpEvents(uint32_t waitMs, const std::function<void()>& disconnectCallback);
 	void updatePingStatistics(uint32_t pingTime);
 	void calculateJitter();
 	void estimatePacketLoss();
@@ -0,0 +1,137 @@
+#include "OutboundQueue.h"
+
+#include <algorithm>
+
+OutboundQueue::PushResult OutboundQueue::push(uint8_t priority, GameProtocol::PacketType type, std::vector<uint8_t>&& data, bool reliable, uint64_t nowMs)
+{
+	const size_t laneIndex = (std::min)(laneFor(priority), LANE_COUNT - 1);
+	Lane& lane = lanes[laneIndex];
+
+	// Retire the superseded position update; it stays in the deque as a dead slot so the lane keeps O(1) removal
+	PushResult result = PushResult::Queued;
+	if (isPositionUpdate(type) && lane.latestPosition != NO_POSITION && lane.latestPosition >= lane.popped)
+	{
+		Entry& previous = lane.entries[lane.latestPosition - lane.popped];
+		previous.live = false;
+		std::vector<uint8_t>().swap(previous.data);
+		liveCount--;
+		coalescedCount++;
+		result = PushResult::Coalesced;
+	}
+	else if (liveCount >= capacity && !shedLowerThan(laneIndex))
+	{
+		droppedCount++;
+		return PushResult::Dropped;
+	}
+
+	if (isPositionUpdate(type))
+	{
+		lane.latestPosition = lane.popped + lane.entries.size();
+	}
+
+	Entry& entry = lane.entries.emplace_back();
+	entry.data = std::move(data);
+	entry.type = type;
+	entry.reliable = reliable;
+	entry.live = true;
+	entry.timestamp = nowMs;
+	liveCount++;
+	return result;
+}
+
+bool OutboundQueue::pop(Entry& entry)
+{
+	for (auto& lane: lanes)
+	{
+		while (!lane.entries.empty())
+		{
+			if (lane.entries.front().live)
+			{
+				entry = std::move(lane.entries.front());
+				popFront(lane);
+				liveCount--;
+				return true;
+			}
+			popFront(lane);
+		}
+	}
+	return false;
+}
+
+size_t OutboundQueue::removeOlderThan(uint64_t cutoffMs)
+{
+	// Timestamps only grow along a lane, so expired packets are always at the front
+	size_t removed = 0;
+	for (auto& lane: lanes)
+	{
+		while (!lane.entries.empty() && lane.entries.front().timestamp < cutoffMs)
+		{
+			if (lane.entries.front().live)
+			{
+				liveCount--;
+				removed++;
+			}
+			popFront(lane);
+		}
+	}
+	return removed;
+}
+
+size_t OutboundQueue::keepUpToPriority(uint8_t priority)
+{
+	size_t removed = 0;
+	for (size_t laneIndex = laneFor(priority) + 1; laneIndex < LANE_COUNT; laneIndex++)
+	{
+		Lane& lane = lanes[laneIndex];
+		for (const auto& entry: lane.entries)
+		{
+			removed += entry.live ? 1 : 0;
+		}
+		lane.popped += lane.entries.size();
+		lane.entries.clear();
+		lane.latestPosition = NO_POSITION;
+	}
+	liveCount -= removed;
+	return removed;
+}
+
+void OutboundQueue::clear()
+{
+	for (auto& lane: lanes)
+	{
+		lane.popped += lane.entries.size();
+		lane.entries.clear();
+		lane.latestPosition = NO_POSITION;
+	}
+	liveCount = 0;
+}
+
+void OutboundQueue::popFront(Lane& lane)
+{
+	if (lane.latestPosition == lane.popped)
+	{
+		lane.latestPosition = NO_POSITION;
+	}
+	lane.entries.pop_front();
+	lane.popped++;
+}
+
+bool OutboundQueue::shedLowerThan(size_t laneIndex)
+{
+	for (size_t index = LANE_COUNT; index-- > laneIndex + 1;)
+	{
+		Lane& lane = lanes[index];
+		while (!lane.entries.empty())
+		{
+			const bool live = lane.entries.front().live;
+			popFront(lane);
+			if (live)
+			{
+				liveCount--;
+				droppedCount++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "PacketTypes.h"
+
+/**
+ * Packets serialized while disconnected, waiting to be flushed after a reconnect.
+ * One FIFO lane per priority level (priority / 64), drained highest priority first.
+ * A newer position update supersedes the one still queued in its lane, since both
+ * carry an absolute position. Not thread-safe; NetworkManager guards it with queueMutex.
+ */
+class OutboundQueue
+{
+public:
+	static constexpr size_t LANE_COUNT = 4;
+
+	struct Entry
+	{
+		std::vector<uint8_t> data;
+		GameProtocol::PacketType type = GameProtocol::PacketType::Heartbeat;
+		bool reliable = false;
+		bool live = false; // Cleared when a newer position update supersedes this one
+		uint64_t timestamp = 0;
+	};
+
+	enum class PushResult
+	{
+		Queued,
+		Coalesced,
+		Dropped
+	};
+
+	explicit OutboundQueue(size_t capacity = 1000)
+	      : capacity(capacity)
+	{
+	}
+
+	// Takes ownership of the serialized bytes; sheds the oldest lower-priority packet when full
+	PushResult push(uint8_t priority, GameProtocol::PacketType type, std::vector<uint8_t>&& data, bool reliable, uint64_t nowMs);
+
+	// Highest priority first, FIFO within a lane; returns false when empty
+	bool pop(Entry& entry);
+
+	// Drop packets queued before cutoffMs, returns how many
+	size_t removeOlderThan(uint64_t cutoffMs);
+
+	// Drop every lane below the given priority, returns how many packets were removed
+	size_t keepUpToPriority(uint8_t priority);
+
+	void clear();
+
+	void setCapacity(size_t maxPackets)
+	{
+		capacity = maxPackets;
+	}
+
+	size_t size() const
+	{
+		return liveCount;
+	}
+
+	bool empty() const
+	{
+		return liveCount == 0;
+	}
+
+	uint64_t getCoalescedCount() const
+	{
+		return coalescedCount;
+	}
+
+	uint64_t getDroppedCount() const
+	{
+		return droppedCount;
+	}
+
+	static size_t laneFor(uint8_t priority)
+	{
+		return priority / 64;
+	}
+
+private:
+	static constexpr uint64_t NO_POSITION = UINT64_MAX;
+
+	struct Lane
+	{
+		std::deque<Entry> entries;
+		uint64_t popped = 0;                   // Absolute index of entries.front()
+		uint64_t latestPosition = NO_POSITION; // Absolute index of the queued position update
+	};
+
+	static bool isPositionUpdate(GameProtocol::PacketType type)
+	{
+		return type == GameProtocol::PacketType::PositionUpdate || type == GameProtocol::PacketType::DeltaPositionUpdate;
+	}
+
+	void popFront(Lane& lane);
+	bool shedLowerThan(size_t lane);
+
+	std::array<Lane, LANE_COUNT> lanes;
+	size_t capacity;
+	size_t liveCount = 0;
+	uint64_t coalescedCount = 0;
+	uint64_t droppedCount = 0;
+};
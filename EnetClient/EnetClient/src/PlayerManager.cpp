@@ -1,39 +1,36 @@
 #include "PlayerManager.h"
 
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	uint64_t steadyNowMs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+} // namespace
+
 void PlayerManager::updatePlayerPosition(uint32_t playerId, const Position& position)
 {
 	std::lock_guard<std::mutex> lock(playersMutex);
-	auto& player = otherPlayers[playerId];
-	player.id = playerId;
+	const uint64_t nowMs = steadyNowMs();
+	auto& player = entities[findOrAddEntity(playerId, nowMs)];
 	player.position = position;
-	player.lastSeen = time(0);
-	player.status = "active";
+	player.lastSeenMs = nowMs;
+	snapshotDirty = true;
 }
 
 void PlayerManager::updatePlayerInfo(const PlayerInfo& playerInfo)
 {
 	std::lock_guard<std::mutex> lock(playersMutex);
-	auto& player = otherPlayers[playerInfo.id];
-	player = playerInfo;
-	player.lastSeen = time(0);
-	player.status = "active";
-}
-
-void PlayerManager::removeStalePlayers()
-{
-	std::lock_guard<std::mutex> lock(playersMutex);
-	auto it = otherPlayers.begin();
-	while (it != otherPlayers.end())
-	{
-		if (it->second.status == "stale")
-		{
-			it = otherPlayers.erase(it);
-		}
-		else
-		{
-			++it;
-		}
-	}
+	const uint64_t nowMs = steadyNowMs();
+	auto& player = entities[findOrAddEntity(playerInfo.id, nowMs)];
+	player.name = playerInfo.name;
+	player.position = playerInfo.position;
+	player.lastSnapshotId = playerInfo.lastSnapshotId;
+	player.lastSeenMs = nowMs;
+	snapshotDirty = true;
 }
 
 void PlayerManager::handlePositionUpdate(const GameProtocol::PositionUpdatePacket& packet)
@@ -51,71 +48,124 @@ void PlayerManager::handlePositionUpdate(const GameProtocol::PositionUpdatePacke
 
 void PlayerManager::handleWorldState(const GameProtocol::WorldStatePacket& packet)
 {
-	// Mark all players for potential removal
 	std::lock_guard<std::mutex> lock(playersMutex);
-	for (auto& pair: otherPlayers)
+
+	// A chunk of a snapshot that was already overtaken only carries older positions
+	if (packet.snapshotId < pendingSnapshotId)
 	{
-		pair.second.status = "stale";
+		return;
 	}
 
-	// Update player data
+	if (packet.snapshotId != pendingSnapshotId)
+	{
+		pendingSnapshotId = packet.snapshotId;
+		pendingChunksReceived = 0;
+		std::fill(seenInSnapshot.begin(), seenInSnapshot.end(), 0);
+	}
+	pendingChunksReceived++;
+	snapshotDirty = true;
+
+	// Each chunk is self-contained, so apply the players it carries straight away
+	const uint64_t nowMs = steadyNowMs();
 	for (const auto& playerInfo: packet.players)
 	{
 		// Skip self
 		if (playerInfo.id == myPlayerId)
 			continue;
 
-		// Update or add player
-		auto it = otherPlayers.find(playerInfo.id);
-		if (it != otherPlayers.end())
+		const uint32_t index = findOrAddEntity(playerInfo.id, nowMs);
+		auto& player = entities[index];
+		player.position.x = playerInfo.position.x;
+		player.position.y = playerInfo.position.y;
+		player.position.z = playerInfo.position.z;
+		if (player.name != playerInfo.name)
 		{
-			// Existing player, update info
-			it->second.position.x = playerInfo.position.x;
-			it->second.position.y = playerInfo.position.y;
-			it->second.position.z = playerInfo.position.z;
-			it->second.name = playerInfo.name;
-			it->second.lastSeen = time(0);
-			it->second.status = "active";
+			player.name = playerInfo.name;
 		}
-		else
+		player.lastSeenMs = nowMs;
+		player.lastSnapshotId = packet.snapshotId;
+		seenInSnapshot[index / 64] |= uint64_t(1) << (index % 64);
+	}
+
+	// Count chunks of the current snapshot; a lost chunk just defers removal to the next complete one
+	if (pendingChunksReceived < packet.chunkCount || packet.snapshotId <= lastCompletedSnapshotId)
+	{
+		return;
+	}
+	lastCompletedSnapshotId = packet.snapshotId;
+
+	// Remove players that were not part of the completed snapshot. Walking backwards means the entity
+	// swapped into a removed slot has already been checked.
+	for (uint32_t index = static_cast<uint32_t>(entities.size()); index-- > 0;)
+	{
+		if (!(seenInSnapshot[index / 64] & (uint64_t(1) << (index % 64))))
 		{
-			// New player
-			PlayerInfo newPlayer;
-			newPlayer.id = playerInfo.id;
-			newPlayer.name = playerInfo.name;
-			newPlayer.position.x = playerInfo.position.x;
-			newPlayer.position.y = playerInfo.position.y;
-			newPlayer.position.z = playerInfo.position.z;
-			newPlayer.lastSeen = time(0);
-			newPlayer.status = "active";
-
-			otherPlayers[playerInfo.id] = newPlayer;
+			removeEntity(index);
 		}
 	}
+}
+
+uint32_t PlayerManager::findOrAddEntity(uint32_t playerId, uint64_t nowMs)
+{
+	auto [it, inserted] = entityIndex.try_emplace(playerId, static_cast<uint32_t>(entities.size()));
+	if (!inserted)
+	{
+		return it->second;
+	}
+
+	auto& player = entities.emplace_back();
+	player.id = playerId;
+	player.lastSeenMs = nowMs;
+	player.generation = ++nextGeneration;
+	seenInSnapshot.resize((entities.size() + 63) / 64, 0);
 
-	// Remove stale players (not in the update)
-	auto it = otherPlayers.begin();
-	while (it != otherPlayers.end())
+	if (onEnter)
 	{
-		if (it->second.status == "stale")
+		onEnter(player);
+	}
+	return it->second;
+}
+
+void PlayerManager::removeEntity(uint32_t index)
+{
+	if (onLeave)
+	{
+		onLeave(entities[index]);
+	}
+	entityIndex.erase(entities[index].id);
+
+	// Move the last entity (and its seen bit) into the hole
+	const uint32_t last = static_cast<uint32_t>(entities.size() - 1);
+	if (index != last)
+	{
+		entities[index] = std::move(entities[last]);
+		entityIndex[entities[index].id] = index;
+
+		const uint64_t bit = uint64_t(1) << (index % 64);
+		if (seenInSnapshot[last / 64] & (uint64_t(1) << (last % 64)))
 		{
-			it = otherPlayers.erase(it);
+			seenInSnapshot[index / 64] |= bit;
 		}
 		else
 		{
-			++it;
+			seenInSnapshot[index / 64] &= ~bit;
 		}
 	}
+	seenInSnapshot[last / 64] &= ~(uint64_t(1) << (last % 64));
+	entities.pop_back();
+	snapshotDirty = true;
 }
 
 PlayerInfo PlayerManager::getPlayer(uint32_t playerId)
 {
-	return otherPlayers[playerId];
+	std::lock_guard<std::mutex> lock(playersMutex);
+	auto it = entityIndex.find(playerId);
+	return it != entityIndex.end() ? entities[it->second] : PlayerInfo{};
 }
 
 PlayerInfo& PlayerManager::getMyPlayer()
 {
-	return otherPlayers[myPlayerId];
+	return myPlayer;
 }
 
 uint32_t PlayerManager::getMyPlayerId()
@@ -125,7 +175,14 @@ uint32_t PlayerManager::getMyPlayerId()
 
 Position PlayerManager::getPlayerPosition(uint32_t playerId)
 {
-	return otherPlayers[playerId].position;
+	if (playerId == myPlayerId)
+	{
+		return myPosition;
+	}
+
+	std::lock_guard<std::mutex> lock(playersMutex);
+	auto it = entityIndex.find(playerId);
+	return it != entityIndex.end() ? entities[it->second].position : Position{};
 }
 
 Position PlayerManager::getMyPosition()
@@ -146,6 +203,7 @@ void PlayerManager::setLastSentPosition(const Position& position)
 void PlayerManager::setMyPlayerId(uint32_t playerId)
 {
 	myPlayerId = playerId;
+	myPlayer.id = playerId;
 }
 
 void PlayerManager::setMyPosition(const Position& position)
@@ -156,19 +214,66 @@ void PlayerManager::setMyPosition(const Position& position)
 void PlayerManager::clearPlayers()
 {
 	std::lock_guard<std::mutex> lock(playersMutex);
-	otherPlayers.clear();
+	while (!entities.empty())
+	{
+		removeEntity(static_cast<uint32_t>(entities.size() - 1));
+	}
+	pendingSnapshotId = 0;
+	pendingChunksReceived = 0;
+	lastCompletedSnapshotId = 0;
+
+	// Publish right away so the UI never shows players from the previous session
+	snapshotDirty = true;
+	publishSnapshotLocked();
 
 	// Reset my position
 	myPosition = { 0, 0, 0 };
 	myPlayerId = 0;
+	myPlayer = PlayerInfo{};
 }
 
-std::mutex& PlayerManager::getMutex()
+void PlayerManager::setEntityCallbacks(EntityCallback onEnter, EntityCallback onLeave)
 {
-	return playersMutex;
+	std::lock_guard<std::mutex> lock(playersMutex);
+	this->onEnter = std::move(onEnter);
+	this->onLeave = std::move(onLeave);
+}
+
+void PlayerManager::publishSnapshot()
+{
+	std::lock_guard<std::mutex> lock(playersMutex);
+	publishSnapshotLocked();
+}
+
+void PlayerManager::publishSnapshotLocked()
+{
+	if (!snapshotDirty)
+	{
+		return;
+	}
+	snapshotDirty = false;
+
+	// Order by id through pointers so the player records themselves are only copied once
+	snapshotOrder.clear();
+	for (const auto& player: entities)
+	{
+		snapshotOrder.push_back(&player);
+	}
+	std::sort(snapshotOrder.begin(), snapshotOrder.end(), [](const PlayerInfo* a, const PlayerInfo* b) { return a->id < b->id; });
+
+	// Assign element-wise so the recycled buffer keeps its vector and string capacity
+	auto& snapshot = snapshots.back();
+	snapshot.players.resize(snapshotOrder.size());
+	for (size_t i = 0; i < snapshotOrder.size(); i++)
+	{
+		snapshot.players[i] = *snapshotOrder[i];
+	}
+	snapshot.version = ++snapshotVersion;
+
+	snapshots.publish();
 }
 
-const std::unordered_map<uint32_t, PlayerInfo>& PlayerManager::getPlayers() const
+const PlayerSnapshot& PlayerManager::acquireSnapshot()
 {
-	return otherPlayers;
+	return snapshots.acquire();
 }
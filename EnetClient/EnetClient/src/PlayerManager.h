@@ -1,24 +1,37 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 #include "PacketTypes.h"
+#include "TripleBuffer.h"
 
 struct PlayerInfo
 {
 	uint32_t id = 0;
 	std::string name;
 	Position position;
-	time_t lastSeen = 0;
-	std::string status;
+	uint64_t lastSeenMs = 0;     // Steady clock
+	uint32_t generation = 0;     // Changes every time this id enters view, so a rejoin is a new entity
+	uint32_t lastSnapshotId = 0;
+};
+
+// Immutable view of the other players handed to the UI thread
+struct PlayerSnapshot
+{
+	std::vector<PlayerInfo> players; // Sorted by id so the list order is stable between frames
+	uint64_t version = 0;
 };
 
 class PlayerManager
 {
 public:
+	// Called with playersMutex held on the thread applying the update; don't call back into PlayerManager
+	using EntityCallback = std::function<void(const PlayerInfo&)>;
+
 	void updatePlayerPosition(uint32_t playerId, const Position& position);
 	void updatePlayerInfo(const PlayerInfo& playerInfo);
-	void removeStalePlayers();
 	void handlePositionUpdate(const GameProtocol::PositionUpdatePacket& packet);
 	void handleWorldState(const GameProtocol::WorldStatePacket& packet);
 
@@ -36,16 +49,48 @@ public:
 	// This will remove all player and reset all of your player data
 	void clearPlayers();
 
-	std::mutex& getMutex();
+	void setEntityCallbacks(EntityCallback onEnter, EntityCallback onLeave);
+
+	// Copy the entity table into a new snapshot if it changed; call once per network update
+	void publishSnapshot();
 
-	const std::unordered_map<uint32_t, PlayerInfo>& getPlayers() const;
+	// UI thread only; lock-free, the reference stays valid until the next call
+	const PlayerSnapshot& acquireSnapshot();
 
 private:
-	std::unordered_map<uint32_t, PlayerInfo> otherPlayers;
+	// Returns the dense index for the id, adding the entity (and firing onEnter) if it is new
+	uint32_t findOrAddEntity(uint32_t playerId, uint64_t nowMs);
+	void removeEntity(uint32_t index);
+	void publishSnapshotLocked();
+
+	// Dense entity table: other players packed in entities and located by server id through entityIndex.
+	// Removal swaps the last entity into the hole, so indices are only stable until the next removal.
+	std::vector<PlayerInfo> entities;
+	std::unordered_map<uint32_t, uint32_t> entityIndex;
+	uint32_t nextGeneration = 0;
+
+	// One bit per dense index, set when the pending world state snapshot carried that entity
+	std::vector<uint64_t> seenInSnapshot;
+
+	EntityCallback onEnter;
+	EntityCallback onLeave;
+
 	std::mutex playersMutex;
+	PlayerInfo myPlayer;
+
+	// Written under playersMutex, read by the UI without it
+	TripleBuffer<PlayerSnapshot> snapshots;
+	std::vector<const PlayerInfo*> snapshotOrder;
+	uint64_t snapshotVersion = 0;
+	bool snapshotDirty = false;
 
 	uint32_t myPlayerId = 0;
 	Position myPosition;
 	Position lastSentPosition;
 	bool useCompressedUpdates = true;
+
+	// World state chunk tracking
+	uint32_t pendingSnapshotId = 0;
+	uint16_t pendingChunksReceived = 0;
+	uint32_t lastCompletedSnapshotId = 0;
 };
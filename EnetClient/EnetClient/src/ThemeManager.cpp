@@ -239,6 +239,7 @@ void ThemeManager::applyTheme()
 	Logger& logger = Logger::getInstance();
 
 	ImGuiStyle& style = ImGui::GetStyle();
+	revision++;
 
 	// Set style parameters
 	style.WindowRounding = currentTheme.windowRounding;
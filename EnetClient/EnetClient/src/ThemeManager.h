@@ -86,6 +86,12 @@ public:
 		return currentTheme;
 	}
 
+	// Bumped on every applyTheme so cached layouts can tell the style changed
+	uint32_t getRevision() const
+	{
+		return revision;
+	}
+
 	// Get list of available themes
 	std::vector<std::string> getThemeNames() const;
 
@@ -95,6 +101,7 @@ public:
 private:
 	std::unordered_map<std::string, UITheme> themes;
 	UITheme currentTheme;
+	uint32_t revision = 0;
 
 	bool isDebuggerAttached = true; // UPDATE THIS VALUE
 
@@ -6,6 +6,51 @@
 #include "MarkdownHelper.h"
 #include "Utils.h"
 
+#include <array>
+#include <cmath>
+
+namespace
+{
+	// Unit circle shared by every map marker
+	constexpr int MARKER_SEGMENTS = 12;
+
+	const std::array<ImVec2, MARKER_SEGMENTS>& markerRing()
+	{
+		static const auto ring = []()
+		{
+			std::array<ImVec2, MARKER_SEGMENTS> points{};
+			for (int i = 0; i < MARKER_SEGMENTS; i++)
+			{
+				const float angle = 2.0f * 3.14159265f * i / MARKER_SEGMENTS;
+				points[i] = ImVec2(cosf(angle), sinf(angle));
+			}
+			return points;
+		}();
+		return ring;
+	}
+
+	// Filled circle written straight into the draw list as a triangle fan, skipping path building
+	// and anti-aliasing; fine for soft halos underneath an anti-aliased dot
+	void addMarkerFan(ImDrawList* drawList, const ImVec2& center, float radius, ImU32 color, const ImVec2& whitePixelUv)
+	{
+		drawList->PrimReserve(MARKER_SEGMENTS * 3, MARKER_SEGMENTS + 1);
+		const auto base = static_cast<ImDrawIdx>(drawList->_VtxCurrentIdx);
+
+		drawList->PrimWriteVtx(center, whitePixelUv, color);
+		for (const ImVec2& point: markerRing())
+		{
+			drawList->PrimWriteVtx(ImVec2(center.x + point.x * radius, center.y + point.y * radius), whitePixelUv, color);
+		}
+
+		for (int i = 0; i < MARKER_SEGMENTS; i++)
+		{
+			drawList->PrimWriteIdx(base);
+			drawList->PrimWriteIdx(static_cast<ImDrawIdx>(base + 1 + i));
+			drawList->PrimWriteIdx(static_cast<ImDrawIdx>(base + 1 + (i + 1) % MARKER_SEGMENTS));
+		}
+	}
+} // namespace
+
 void UIManager::drawUI()
 {
 	Position myPosition = playerManager->getMyPosition();
@@ -433,65 +478,70 @@ void UIManager::drawPlayersPanel(float width, float height)
 	);
 	ImGui::Dummy(ImVec2(0, 10)); // Space after separator
 
-	const auto otherPlayers = playerManager->getPlayers();
-	auto& playersMutex = playerManager->getMutex();
+	// Lock-free view published by the network update; no per-frame copy of the player map
+	const auto& otherPlayers = playerManager->acquireSnapshot().players;
 
 	// Display other players with card-like styling
 	const float listHeight = height - 525; // Reserve space for the map
 	ImGui::BeginChild("PlayersList", ImVec2(width - 40, listHeight), false);
 
-	std::lock_guard<std::mutex> lock(playersMutex);
 	if (otherPlayers.empty())
 	{
 		ImGui::TextColored(theme.textSecondary, ICON_LC_USERS " No other players online");
 	}
 	else
 	{
-		for (const auto& pair: otherPlayers)
+		// Only the rows scrolled into view are built
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(otherPlayers.size()));
+		while (clipper.Step())
 		{
-			const PlayerInfo& player = pair.second;
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+			{
+				const PlayerInfo& player = otherPlayers[row];
 
-			// Player card with hover effect
-			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(12, 10));
-			ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 6.0f);
+				// Player card with hover effect
+				ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(12, 10));
+				ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 6.0f);
 
-			// Generate unique ID for this player card
-			ImGui::PushID(player.id);
+				// Scope the card's id by the player id so no label string is built per row
+				ImGui::PushID(static_cast<int>(player.id));
 
-			bool isHovered = false;
+				bool isHovered = false;
 
-			// Start of card
-			ImGui::BeginChild(("Player_" + std::to_string(player.id)).c_str(), ImVec2(width - 60, 75), true);
-			isHovered = ImGui::IsItemHovered();
+				// Start of card
+				ImGui::BeginChild("PlayerCard", ImVec2(width - 60, 75), true);
+				isHovered = ImGui::IsItemHovered();
 
-			// Player name and ID
-			ImGui::SetCursorPos(ImVec2(30, 8));
-			ImGui::TextUnformatted(player.name.c_str());
-			ImGui::SameLine();
-			ImGui::TextColored(theme.textSecondary, "(ID: %u)", player.id);
+				// Player name and ID
+				ImGui::SetCursorPos(ImVec2(30, 8));
+				ImGui::TextUnformatted(player.name.c_str());
+				ImGui::SameLine();
+				ImGui::TextColored(theme.textSecondary, "(ID: %u)", player.id);
 
-			// Position with icon
-			ImGui::SetCursorPos(ImVec2(30, 35));
-			ImGui::TextColored(theme.textSecondary, ICON_LC_MAP_PIN " %.1f, %.1f, %.1f", player.position.x, player.position.y, player.position.z);
+				// Position with icon
+				ImGui::SetCursorPos(ImVec2(30, 35));
+				ImGui::TextColored(theme.textSecondary, ICON_LC_MAP_PIN " %.1f, %.1f, %.1f", player.position.x, player.position.y, player.position.z);
 
-			ImGui::EndChild(); // End of card
+				ImGui::EndChild(); // End of card
 
-			// Card highlight effect on hover
-			if (isHovered)
-			{
-				ImVec2 min = ImGui::GetItemRectMin();
-				ImVec2 max = ImGui::GetItemRectMax();
-				drawList->AddRect(ImVec2(min.x - 1, min.y - 1),
-				        ImVec2(max.x + 1, max.y + 1),
-				        ImGui::GetColorU32(theme.accentPrimary), // Accent color
-				        6.0f,
-				        0,
-				        2.0f);
-			}
+				// Card highlight effect on hover
+				if (isHovered)
+				{
+					ImVec2 min = ImGui::GetItemRectMin();
+					ImVec2 max = ImGui::GetItemRectMax();
+					drawList->AddRect(ImVec2(min.x - 1, min.y - 1),
+					        ImVec2(max.x + 1, max.y + 1),
+					        ImGui::GetColorU32(theme.accentPrimary), // Accent color
+					        6.0f,
+					        0,
+					        2.0f);
+				}
 
-			ImGui::PopID();
-			ImGui::PopStyleVar(2); // FramePadding, FrameRounding
-			ImGui::Spacing();
+				ImGui::PopID();
+				ImGui::PopStyleVar(2); // FramePadding, FrameRounding
+				ImGui::Spacing();
+			}
 		}
 	}
 	ImGui::EndChild(); // End PlayersList
@@ -598,30 +648,40 @@ void UIManager::drawPlayersPanel(float width, float height)
 		drawList->AddCircleFilled(playerPos, 6.0f, ImGui::GetColorU32(theme.playerSelf));
 		drawList->AddCircle(playerPos, 6.0f, ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, 0.5f)), 0, 1.5f);
 
-		// Draw other players with subtle glow
-		for (const auto& pair: otherPlayers)
+		// Draw other players with subtle glow. Halo and outline fans for every player go into the draw
+		// list in one pass; only the hovered player gets a tooltip.
+		ImVec4 otherGlowColor = theme.playerOthers;
+		otherGlowColor.w = 0.3f;
+		const ImU32 glowColor = ImGui::GetColorU32(otherGlowColor);
+		const ImU32 outlineColor = ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, 0.3f));
+		const ImU32 dotColor = ImGui::GetColorU32(theme.playerOthers);
+		const ImVec2 whitePixelUv = ImGui::GetFontTexUvWhitePixel();
+		const ImVec2 mousePos = ImGui::GetIO().MousePos;
+		const bool mouseOverMap = ImGui::IsItemHovered();
+		const PlayerInfo* hoveredPlayer = nullptr;
+
+		for (const PlayerInfo& player: otherPlayers)
 		{
-			const PlayerInfo& player = pair.second;
-			ImVec2 otherPlayerPos = worldToMap(player.position.x, -player.position.z);
-
-			// Subtle glow
-			ImVec4 otherGlowColor = theme.playerOthers;
-			otherGlowColor.w = 0.3f;
-			drawList->AddCircleFilled(otherPlayerPos, 7.0f, ImGui::GetColorU32(otherGlowColor));
+			const ImVec2 otherPlayerPos = worldToMap(player.position.x, -player.position.z);
 
-			// Player dot
-			drawList->AddCircleFilled(otherPlayerPos, 5.0f, ImGui::GetColorU32(theme.playerOthers));
-			drawList->AddCircle(otherPlayerPos, 5.0f, ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, 0.3f)), 0, 1.0f);
+			addMarkerFan(drawList, otherPlayerPos, 7.0f, glowColor, whitePixelUv);
+			addMarkerFan(drawList, otherPlayerPos, 5.5f, outlineColor, whitePixelUv);
+			drawList->AddCircleFilled(otherPlayerPos, 4.5f, dotColor, MARKER_SEGMENTS);
 
-			// Tooltip on hover
-			if (ImGui::IsMouseHoveringRect(ImVec2(otherPlayerPos.x - 8, otherPlayerPos.y - 8), ImVec2(otherPlayerPos.x + 8, otherPlayerPos.y + 8)))
+			if (mouseOverMap && fabsf(mousePos.x - otherPlayerPos.x) <= 8.0f && fabsf(mousePos.y - otherPlayerPos.y) <= 8.0f)
 			{
-				ImGui::BeginTooltip();
-				ImGui::Text("%s (ID: %u)", player.name.c_str(), player.id);
-				ImGui::Text("Position: %.1f, %.1f, %.1f", player.position.x, player.position.y, player.position.z);
-				ImGui::EndTooltip();
+				hoveredPlayer = &player;
 			}
 		}
+
+		// Tooltip on hover
+		if (hoveredPlayer)
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("%s (ID: %u)", hoveredPlayer->name.c_str(), hoveredPlayer->id);
+			ImGui::Text("Position: %.1f, %.1f, %.1f", hoveredPlayer->position.x, hoveredPlayer->position.y, hoveredPlayer->position.z);
+			ImGui::EndTooltip();
+		}
 	}
 
 	// Compass with translucent background
@@ -724,24 +784,41 @@ void UIManager::drawChatPanel(float width, float height)
 	ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, theme.frameRounding);
 	ImGui::BeginChild("ChatMessages", ImVec2(width - 40, messagesHeight), true);
 	{
-		std::lock_guard<std::mutex> chatLock(chatManager->getMutex());
+		// Pick up only the messages added since the last frame; each is parsed once
+		newChatEntries.clear();
+		chatNextSequence = chatManager->readChatMessages(chatNextSequence, newChatEntries);
+		for (auto& entry: newChatEntries)
+		{
+			auto& line = chatLines.emplace_back();
+			line.entry = std::move(entry);
+			line.timeLabel = Utils::formatTimestamp(line.entry->timestamp);
+			MarkdownHelper::ParseMarkdown(line.entry->content, line.layout);
+		}
+
+		// Drop what the store evicted or cleared
+		const uint64_t oldestSequence = chatManager->getOldestSequence();
+		while (!chatLines.empty() && chatLines.front().entry->sequence < oldestSequence)
+		{
+			chatLines.pop_front();
+		}
 
 		// Variables for message grouping
-		std::string currentSender = "";
+		const std::string* currentSender = nullptr;
 		time_t groupStartTime = 0;
 		bool isFirstInGroup = true;
 		const int GROUP_TIME_THRESHOLD = 120; // Group messages within 2 minutes (adjust as needed)
 
-		for (size_t i = 0; i < chatManager->getChatMessages().size(); i++)
+		for (auto& line: chatLines)
 		{
-			const auto& msg = chatManager->getChatMessages()[i];
+			const ChatEntry& msg = *line.entry;
+			const std::string& sender = *msg.sender;
 			if (msg.timestamp == 0)
 			{
 				continue;
 			}
 
 			// Check if this message should start a new group
-			bool startNewGroup = (currentSender != msg.sender) || (msg.timestamp - groupStartTime > GROUP_TIME_THRESHOLD);
+			bool startNewGroup = (!currentSender || *currentSender != sender) || (msg.timestamp - groupStartTime > GROUP_TIME_THRESHOLD);
 
 			if (startNewGroup)
 			{
@@ -756,19 +833,19 @@ void UIManager::drawChatPanel(float width, float height)
 				}
 
 				// Start a new message group
-				currentSender = msg.sender;
+				currentSender = &sender;
 				groupStartTime = msg.timestamp;
 				isFirstInGroup = false;
 
 				// Format sender with different colors based on type
 				ImVec4 senderColor;
 				std::string senderIcon;
-				if (msg.sender == "System" || msg.sender == "Server")
+				if (sender == "System" || sender == "Server")
 				{
 					senderColor = theme.systemMessage; // Gold for system
 					senderIcon = ICON_LC_CIRCLE_ALERT " ";
 				}
-				else if (msg.sender == "You")
+				else if (sender == "You")
 				{
 					senderColor = theme.accentPrimary; // Accent blue for self
 					senderIcon = ICON_LC_USER " ";
@@ -785,7 +862,7 @@ void UIManager::drawChatPanel(float width, float height)
 
 				// Set background color based on sender
 				ImVec4 bubbleBgColor;
-				if (msg.sender == "You")
+				if (sender == "You")
 				{
 					// Your messages
 					bubbleBgColor = theme.accentSecondary;
@@ -799,28 +876,25 @@ void UIManager::drawChatPanel(float width, float height)
 				}
 				ImGui::PushStyleColor(ImGuiCol_ChildBg, bubbleBgColor);
 
-				// Begin message bubble group with unique ID
-				ImGui::BeginChild(("MsgGroup" + std::to_string(msg.timestamp)).c_str(), ImVec2(width - 80, 0), ImGuiChildFlags_AlwaysAutoResize | ImGuiChildFlags_AutoResizeY);
+				// Begin message bubble group with an ID from its first message
+				ImGui::BeginChild(ImGui::GetID(line.entry.get()), ImVec2(width - 80, 0), ImGuiChildFlags_AlwaysAutoResize | ImGuiChildFlags_AutoResizeY);
 
 				// Add some extra space at the top of the bubble
 				ImGui::Dummy(ImVec2(0, 4));
 				ImGui::Indent(16.0f);
 
 				// Print sender name with icon and color
-				ImGui::TextColored(senderColor, "%s%s:", senderIcon.c_str(), msg.sender.c_str());
+				ImGui::TextColored(senderColor, "%s%s:", senderIcon.c_str(), sender.c_str());
 			}
 
 			if (startNewGroup)
 			{
-				// Format timestamp
-				std::string timeStr = Utils::formatTimestamp(msg.timestamp);
-
 				// First message in group shows timestamp at the top
-				ImGui::TextColored(theme.textSecondary, "%s", timeStr.c_str());
+				ImGui::TextColored(theme.textSecondary, "%s", line.timeLabel.c_str());
 			}
 
-			// Render markdown content using MarkdownHelper
-			MarkdownHelper::RenderMarkdown(msg.content, ImGui::GetContentRegionAvail().x, theme);
+			// Render the cached markdown layout; messages scrolled out of view only cost a spacer
+			MarkdownHelper::RenderMarkdown(line.layout, ImGui::GetContentRegionAvail().x, theme, themeManager.getRevision());
 		}
 
 		// Close the last group if there was one
@@ -1007,10 +1081,17 @@ void UIManager::drawStatusBar()
 	ImGui::SetCursorPos(ImVec2(20, 5));
 	ImGui::TextColored(themeManager.getCurrentTheme().textSecondary, ICON_LC_WIFI " %ums | " ICON_LC_PACKAGE " %u/%u | " ICON_LC_HARD_DRIVE " %u/%u bytes", networkManager->getPing(), networkManager->getPacketsSent(), networkManager->getPacketsReceived(), networkManager->getBytesSent(), networkManager->getBytesReceived());
 
+	// Only shown while the receive pump is falling behind
+	if (uint32_t backlog = networkManager->getReceiveBacklog(); backlog > 0)
+	{
+		ImGui::SameLine();
+		ImGui::TextColored(themeManager.getCurrentTheme().statusConnecting, "| " ICON_LC_INBOX " %u queued", backlog);
+	}
+
 	// Players online with icon
 	float playerOnlineTextWidth = ImGui::CalcTextSize(ICON_LC_USERS " Players Online: 999").x;
 	ImGui::SameLine(ImGui::GetContentRegionAvail().x - playerOnlineTextWidth - 20);
-	ImGui::TextColored(themeManager.getCurrentTheme().accentPrimary, ICON_LC_USERS " Players Online: %zu", playerManager->getPlayers().size() + 1); // +1 for self
+	ImGui::TextColored(themeManager.getCurrentTheme().accentPrimary, ICON_LC_USERS " Players Online: %zu", playerManager->acquireSnapshot().players.size() + 1); // +1 for self
 
 	ImGui::EndChild();
 }
@@ -1100,7 +1181,7 @@ void UIManager::initiateRegistration()
 		        if (serverPeer)
 		        {
 			        // Send registration packet
-			        networkManager->GetPacketManager()->sendPacket(serverPeer, *regPacket, true);
+			        networkManager->sendPacket(regPacket, true);
 
 			        // Update UI state
 			        threadManager->scheduleUITask(
@@ -2,6 +2,7 @@
 
 #include "ChatManager.h"
 #include "ConnectionManager.h"
+#include "MarkdownHelper.h"
 #include "NetworkManager.h"
 #include "PlayerManager.h"
 #include "ThemeManager.h"
@@ -67,5 +68,16 @@ private:
 	// Chat input
 	char chatInputBuffer[256] = { 0 };
 
+	// Chat messages read incrementally from ChatManager, with their parsed markdown
+	struct ChatLine
+	{
+		std::shared_ptr<const ChatEntry> entry;
+		std::string timeLabel;
+		MarkdownDocument layout;
+	};
+	std::deque<ChatLine> chatLines;
+	uint64_t chatNextSequence = 0;
+	std::vector<std::shared_ptr<const ChatEntry>> newChatEntries;
+
 	bool showPassword = false;
 };
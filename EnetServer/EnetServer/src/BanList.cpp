@@ -0,0 +1,403 @@
+#include "BanList.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <sstream>
+
+namespace
+{
+	int bitAt(const BanAddress& address, uint8_t index)
+	{
+		return index < 64 ? static_cast<int>((address.high >> (63 - index)) & 1) : static_cast<int>((address.low >> (127 - index)) & 1);
+	}
+
+	uint8_t commonPrefix(const BanAddress& a, const BanAddress& b)
+	{
+		if (const uint64_t diff = a.high ^ b.high)
+		{
+			return static_cast<uint8_t>(std::countl_zero(diff));
+		}
+		const uint64_t diff = a.low ^ b.low;
+		return static_cast<uint8_t>(diff ? 64 + std::countl_zero(diff) : 128);
+	}
+
+	BanAddress masked(const BanAddress& address, uint8_t length)
+	{
+		BanAddress result = address;
+		if (length < 64)
+		{
+			result.high = length == 0 ? 0 : result.high & (~uint64_t(0) << (64 - length));
+			result.low = 0;
+		}
+		else if (length < 128)
+		{
+			result.low = length == 64 ? 0 : result.low & (~uint64_t(0) << (128 - length));
+		}
+		return result;
+	}
+
+	bool isMappedIPv4(const BanAddress& address)
+	{
+		return address.high == 0 && (address.low >> 32) == 0xFFFF;
+	}
+
+	bool parseNumber(const std::string& text, uint32_t maxValue, uint32_t& value)
+	{
+		if (text.empty() || text.size() > 3 || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; }))
+		{
+			return false;
+		}
+		value = static_cast<uint32_t>(std::stoul(text));
+		return value <= maxValue;
+	}
+
+	bool parseIPv4(const std::string& text, uint32_t& address)
+	{
+		std::istringstream stream(text);
+		std::string part;
+		address = 0;
+		int parts = 0;
+		while (std::getline(stream, part, '.'))
+		{
+			uint32_t octet = 0;
+			if (++parts > 4 || !parseNumber(part, 255, octet))
+			{
+				return false;
+			}
+			address = (address << 8) | octet;
+		}
+		return parts == 4 && text.back() != '.';
+	}
+
+	// Hex groups of one side of "::"; a trailing dotted IPv4 counts as two groups
+	bool parseGroups(const std::string& text, std::vector<uint16_t>& groups)
+	{
+		if (text.empty())
+		{
+			return true;
+		}
+
+		std::istringstream stream(text);
+		std::string group;
+		while (std::getline(stream, group, ':'))
+		{
+			if (group.find('.') != std::string::npos && stream.eof())
+			{
+				uint32_t ipv4 = 0;
+				if (!parseIPv4(group, ipv4))
+				{
+					return false;
+				}
+				groups.push_back(static_cast<uint16_t>(ipv4 >> 16));
+				groups.push_back(static_cast<uint16_t>(ipv4));
+				return true;
+			}
+			if (group.empty() || group.size() > 4 || !std::all_of(group.begin(), group.end(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; }))
+			{
+				return false;
+			}
+			groups.push_back(static_cast<uint16_t>(std::stoul(group, nullptr, 16)));
+		}
+		return text.back() != ':';
+	}
+
+	bool parseIPv6(const std::string& text, BanAddress& address)
+	{
+		std::vector<uint16_t> head;
+		std::vector<uint16_t> tail;
+		const size_t gap = text.find("::");
+		if (gap == std::string::npos)
+		{
+			if (!parseGroups(text, head) || head.size() != 8)
+			{
+				return false;
+			}
+		}
+		else if (text.find("::", gap + 1) != std::string::npos || !parseGroups(text.substr(0, gap), head) || !parseGroups(text.substr(gap + 2), tail) || head.size() + tail.size() > 7)
+		{
+			return false;
+		}
+
+		uint16_t groups[8] = {};
+		std::copy(head.begin(), head.end(), groups);
+		std::copy(tail.begin(), tail.end(), groups + 8 - tail.size());
+
+		address = BanAddress{};
+		for (int i = 0; i < 4; i++)
+		{
+			address.high = (address.high << 16) | groups[i];
+			address.low = (address.low << 16) | groups[i + 4];
+		}
+		return true;
+	}
+} // namespace
+
+BanAddress BanAddress::fromEnet(const ENetAddress& address)
+{
+	// ENet keeps the IPv4 host in network byte order
+	const auto* bytes = reinterpret_cast<const uint8_t*>(&address.host);
+	BanAddress result;
+	result.low = (uint64_t(0xFFFF) << 32) | (uint64_t(bytes[0]) << 24) | (uint64_t(bytes[1]) << 16) | (uint64_t(bytes[2]) << 8) | bytes[3];
+	return result;
+}
+
+void BanTrie::build(const std::vector<BanRule>& rules)
+{
+	nodes.clear();
+	addNode(BanAddress{}, 0, Action::None);
+	for (const auto& rule: rules)
+	{
+		insert(masked(rule.network, rule.prefixLength), rule.prefixLength, rule.allow ? Action::Allow : Action::Ban);
+	}
+}
+
+BanTrie::Action BanTrie::match(const BanAddress& address) const
+{
+	Action result = Action::None;
+	int32_t current = nodes.empty() ? -1 : 0;
+	while (current >= 0)
+	{
+		const Node& node = nodes[current];
+		if (commonPrefix(address, node.key) < node.length)
+		{
+			break;
+		}
+		if (node.action != Action::None)
+		{
+			result = node.action;
+		}
+		if (node.length == 128)
+		{
+			break;
+		}
+		current = node.child[bitAt(address, node.length)];
+	}
+	return result;
+}
+
+void BanTrie::insert(const BanAddress& key, uint8_t length, Action action)
+{
+	// Nodes are addressed by index, addNode may reallocate
+	int32_t current = 0;
+	while (nodes[current].length != length)
+	{
+		const int bit = bitAt(key, nodes[current].length);
+		const int32_t next = nodes[current].child[bit];
+		if (next < 0)
+		{
+			const int32_t leaf = addNode(key, length, action);
+			nodes[current].child[bit] = leaf;
+			return;
+		}
+
+		const uint8_t common = (std::min)({ commonPrefix(key, nodes[next].key), length, nodes[next].length });
+		if (common == nodes[next].length)
+		{
+			current = next;
+			continue;
+		}
+
+		// Split the edge where the new prefix leaves it (or ends on it)
+		const int32_t middle = addNode(masked(key, common), common, common == length ? action : Action::None);
+		nodes[middle].child[bitAt(nodes[next].key, common)] = next;
+		if (common != length)
+		{
+			const int32_t leaf = addNode(key, length, action);
+			nodes[middle].child[bitAt(key, common)] = leaf;
+		}
+		nodes[current].child[bit] = middle;
+		return;
+	}
+	nodes[current].action = action;
+}
+
+int32_t BanTrie::addNode(const BanAddress& key, uint8_t length, Action action)
+{
+	Node& node = nodes.emplace_back();
+	node.key = key;
+	node.length = length;
+	node.action = action;
+	return static_cast<int32_t>(nodes.size() - 1);
+}
+
+BanList::BanList()
+{
+	setReaderCount(1);
+}
+
+void BanList::setReaderCount(size_t count)
+{
+	std::lock_guard<std::mutex> lock(rulesMutex);
+	readerCount = (std::max)(count, size_t(1));
+	tries = std::make_unique<TripleBuffer<BanTrie>[]>(readerCount);
+	publishLocked();
+}
+
+bool BanList::addRule(const std::string& cidr, bool allow, const std::string& reason, const std::string& createdBy, std::string& error)
+{
+	BanRule rule;
+	if (!parseCidr(cidr, rule.network, rule.prefixLength))
+	{
+		error = "Invalid address or CIDR: " + cidr;
+		return false;
+	}
+	rule.allow = allow;
+	rule.reason = reason;
+	rule.createdBy = createdBy;
+	rule.createdAt = std::time(nullptr);
+
+	std::lock_guard<std::mutex> lock(rulesMutex);
+	auto it = std::find_if(rules.begin(), rules.end(),
+	        [&rule](const BanRule& existing) { return existing.prefixLength == rule.prefixLength && existing.network.high == rule.network.high && existing.network.low == rule.network.low; });
+	if (it != rules.end())
+	{
+		*it = std::move(rule);
+	}
+	else
+	{
+		rules.push_back(std::move(rule));
+	}
+	publishLocked();
+	return true;
+}
+
+bool BanList::removeRule(const std::string& cidr)
+{
+	BanAddress network;
+	uint8_t prefixLength = 0;
+	if (!parseCidr(cidr, network, prefixLength))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(rulesMutex);
+	const size_t removed = std::erase_if(rules,
+	        [&](const BanRule& rule) { return rule.prefixLength == prefixLength && rule.network.high == network.high && rule.network.low == network.low; });
+	if (removed == 0)
+	{
+		return false;
+	}
+	publishLocked();
+	return true;
+}
+
+void BanList::setRules(std::vector<BanRule> newRules)
+{
+	std::lock_guard<std::mutex> lock(rulesMutex);
+	rules = std::move(newRules);
+	publishLocked();
+}
+
+std::vector<BanRule> BanList::getRules() const
+{
+	std::lock_guard<std::mutex> lock(rulesMutex);
+	return rules;
+}
+
+bool BanList::isBanned(const ENetAddress& address, size_t reader)
+{
+	return tries[reader].acquire().match(BanAddress::fromEnet(address)) == BanTrie::Action::Ban;
+}
+
+void BanList::publishLocked()
+{
+	// The back buffer holds a trie from two publishes ago, build() starts it over
+	tries[0].back().build(rules);
+	for (size_t i = 1; i < readerCount; i++)
+	{
+		tries[i].back() = tries[0].back();
+	}
+	for (size_t i = 0; i < readerCount; i++)
+	{
+		tries[i].publish();
+	}
+}
+
+bool BanList::parseCidr(const std::string& cidr, BanAddress& network, uint8_t& prefixLength)
+{
+	const size_t slash = cidr.find('/');
+	const std::string host = cidr.substr(0, slash);
+	const bool ipv6 = host.find(':') != std::string::npos;
+
+	BanAddress address;
+	if (ipv6)
+	{
+		if (!parseIPv6(host, address))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		uint32_t ipv4 = 0;
+		if (!parseIPv4(host, ipv4))
+		{
+			return false;
+		}
+		address.low = (uint64_t(0xFFFF) << 32) | ipv4;
+	}
+
+	uint32_t length = ipv6 ? 128 : 32;
+	if (slash != std::string::npos && !parseNumber(cidr.substr(slash + 1), length, length))
+	{
+		return false;
+	}
+
+	prefixLength = static_cast<uint8_t>(ipv6 ? length : length + 96);
+	network = masked(address, prefixLength);
+	return true;
+}
+
+std::string BanList::formatCidr(const BanAddress& network, uint8_t prefixLength)
+{
+	std::ostringstream result;
+	if (isMappedIPv4(network) && prefixLength >= 96)
+	{
+		result << ((network.low >> 24) & 0xFF) << '.' << ((network.low >> 16) & 0xFF) << '.' << ((network.low >> 8) & 0xFF) << '.' << (network.low & 0xFF) << '/' << (prefixLength - 96);
+		return result.str();
+	}
+
+	uint16_t groups[8];
+	for (int i = 0; i < 4; i++)
+	{
+		groups[i] = static_cast<uint16_t>(network.high >> (48 - 16 * i));
+		groups[i + 4] = static_cast<uint16_t>(network.low >> (48 - 16 * i));
+	}
+
+	// Collapse the longest run of two or more zero groups into "::"
+	int gapStart = -1;
+	int gapLength = 1;
+	for (int i = 0; i < 8;)
+	{
+		int run = 0;
+		while (i + run < 8 && groups[i + run] == 0)
+		{
+			run++;
+		}
+		if (run > gapLength)
+		{
+			gapStart = i;
+			gapLength = run;
+		}
+		i += run > 0 ? run : 1;
+	}
+
+	result << std::hex;
+	for (int i = 0; i < 8; i++)
+	{
+		if (i == gapStart)
+		{
+			result << "::";
+			i += gapLength - 1;
+			continue;
+		}
+		if (i > 0 && i != gapStart + gapLength)
+		{
+			result << ':';
+		}
+		result << groups[i];
+	}
+	result << std::dec << '/' << static_cast<int>(prefixLength);
+	return result.str();
+}
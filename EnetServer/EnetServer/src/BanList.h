@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <enet/enet.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "TripleBuffer.h"
+
+// 128-bit address; IPv4 is stored IPv4-mapped (::ffff:a.b.c.d) so one trie holds both families
+struct BanAddress
+{
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	static BanAddress fromEnet(const ENetAddress& address);
+};
+
+struct BanRule
+{
+	BanAddress network;
+	uint8_t prefixLength = 128; // Over the 128-bit form, so an IPv4 /24 is 120
+	bool allow = false;         // Allow rules carve exceptions out of wider bans
+	std::string reason;
+	std::string createdBy;
+	int64_t createdAt = 0;
+};
+
+// Path-compressed binary trie over the 128-bit address; the longest matching prefix decides
+class BanTrie
+{
+public:
+	enum class Action : uint8_t
+	{
+		None,
+		Ban,
+		Allow
+	};
+
+	void build(const std::vector<BanRule>& rules);
+	Action match(const BanAddress& address) const;
+
+	size_t getNodeCount() const
+	{
+		return nodes.size();
+	}
+
+private:
+	struct Node
+	{
+		BanAddress key; // Prefix bits, zero past length
+		int32_t child[2] = { -1, -1 };
+		uint8_t length = 0;
+		Action action = Action::None;
+	};
+
+	void insert(const BanAddress& key, uint8_t length, Action action);
+	int32_t addNode(const BanAddress& key, uint8_t length, Action action);
+
+	std::vector<Node> nodes;
+};
+
+// Ban and allow rules edited from the console; connects are checked against an immutable trie
+// published through a triple buffer per network thread, so no network thread ever takes a lock
+class BanList
+{
+public:
+	BanList();
+
+	// One reader per network thread; call before any of them runs
+	void setReaderCount(size_t count);
+
+	// Add or replace the rule for a CIDR ("10.0.0.0/8", "2001:db8::/32", a bare address is a single host)
+	bool addRule(const std::string& cidr, bool allow, const std::string& reason, const std::string& createdBy, std::string& error);
+	bool removeRule(const std::string& cidr);
+	void setRules(std::vector<BanRule> newRules);
+	std::vector<BanRule> getRules() const;
+
+	// Network threads only, each passing its own reader index
+	bool isBanned(const ENetAddress& address, size_t reader = 0);
+
+	static bool parseCidr(const std::string& cidr, BanAddress& network, uint8_t& prefixLength);
+	static std::string formatCidr(const BanAddress& network, uint8_t prefixLength);
+
+private:
+	void publishLocked();
+
+	mutable std::mutex rulesMutex;
+	std::vector<BanRule> rules;
+	std::unique_ptr<TripleBuffer<BanTrie>[]> tries;
+	size_t readerCount = 0;
+};
@@ -0,0 +1,87 @@
+#include "BulkStreamer.h"
+
+uint32_t BulkStreamer::queueStream(ENetPeer* peer, GameProtocol::BulkStreamKind kind, const std::vector<uint8_t>& payload)
+{
+	if (peer == nullptr)
+		return 0;
+
+	uint32_t streamId = nextStreamId;
+	auto chunks = GameProtocol::splitBulkStream(streamId, kind, payload);
+	if (chunks.empty())
+		return 0;
+	nextStreamId++;
+
+	auto& queue = queues[peer];
+	for (auto& chunk: chunks)
+	{
+		queue.push_back(std::move(chunk));
+	}
+
+	return streamId;
+}
+
+void BulkStreamer::removePeer(ENetPeer* peer)
+{
+	queues.erase(peer);
+}
+
+void BulkStreamer::pump(const SendFunction& send, size_t bytesPerTick, size_t windowBytes)
+{
+	for (auto it = queues.begin(); it != queues.end();)
+	{
+		ENetPeer* peer = it->first;
+		auto& queue = it->second;
+
+		if (peer->state != ENET_PEER_STATE_CONNECTED)
+		{
+			it = queues.erase(it);
+			continue;
+		}
+
+		size_t sentBytes = 0;
+		while (!queue.empty() && sentBytes < bytesPerTick)
+		{
+			// Back off while the peer still has too much unacknowledged reliable data
+			if (peer->reliableDataInTransit >= windowBytes)
+			{
+				deferredTicks++;
+				break;
+			}
+
+			const auto& chunk = queue.front();
+			send(peer, chunk);
+			sentBytes += chunk.payload.size();
+			chunksSent++;
+			queue.pop_front();
+		}
+
+		if (queue.empty())
+		{
+			it = queues.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+size_t BulkStreamer::getPendingChunkCount() const
+{
+	size_t count = 0;
+	for (const auto& pair: queues)
+	{
+		count += pair.second.size();
+	}
+	return count;
+}
+
+uint64_t BulkStreamer::getChunksSent() const
+{
+	return chunksSent;
+}
+
+uint64_t BulkStreamer::getDeferredTicks() const
+{
+	return deferredTicks;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <enet/enet.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "BulkStream.h"
+
+// Queues large reliable transfers per peer and drains them on the bulk channel with flow control,
+// so chat backfill or world sync never crowds out realtime updates
+class BulkStreamer
+{
+public:
+	using SendFunction = std::function<void(ENetPeer*, const GameProtocol::BulkDataPacket&)>;
+
+	// Queue a stream payload (a sequence of serialized packets) for a peer; 0 if it is too large to stream
+	uint32_t queueStream(ENetPeer* peer, GameProtocol::BulkStreamKind kind, const std::vector<uint8_t>& payload);
+	void removePeer(ENetPeer* peer);
+
+	// Send queued chunks while each peer stays under the in-flight window and the per-tick budget
+	void pump(const SendFunction& send, size_t bytesPerTick, size_t windowBytes);
+
+	size_t getPendingChunkCount() const;
+	uint64_t getChunksSent() const;
+	uint64_t getDeferredTicks() const;
+
+private:
+	std::unordered_map<ENetPeer*, std::deque<GameProtocol::BulkDataPacket>> queues;
+	uint32_t nextStreamId = 1;
+	uint64_t chunksSent = 0;
+	uint64_t deferredTicks = 0;
+};
@@ -4,6 +4,7 @@
 #define VERSION "1.0.0"
 #define AUTH_DB_FILE "player_auth.dat"
 #define WORLD_DB_FILE "world_data.dat"
+#define BAN_LIST_FILE "bans.txt"
 #define DEBUG_LOG_FILE "server.log"
 #define CONFIG_FILE "server_config.cfg"
 #define MAX_PLAYERS 500
@@ -22,6 +23,31 @@
 #define MAX_MOVEMENT_SPEED 2.0f      // Max allowed movement speed per update
 #define SECURE_PASSWORD_STORAGE true // Use secure hash for passwords
 #define ADMIN_PASSWORD "admin123"    // Default admin password (should be changed)
+#define COMPACT_WORLD_STATE true    // Send world state using the bit-packed encoding
+#define WORLD_STATE_CHUNK_BYTES 1200 // Max world state packet size before splitting into chunks (below ENet MTU)
+#define BULK_BYTES_PER_TICK 16384    // Max bulk stream bytes sent per peer per update tick
+#define BULK_WINDOW_BYTES 32768      // Pause bulk streams while a peer has this much reliable data in flight
+#define ADAPTIVE_SEND_RATE true      // Degrade world state rate and detail per peer from RTT, loss and ENet throttle
+#define SEND_RATE_FAIR_RTT_MS 80     // RTT at or above this is at least fair quality
+#define SEND_RATE_POOR_RTT_MS 150    // RTT at or above this is at least poor quality
+#define SEND_RATE_BAD_RTT_MS 300     // RTT at or above this is bad quality
+#define SEND_RATE_FAIR_LOSS 1.0f     // Packet loss percent for fair quality
+#define SEND_RATE_POOR_LOSS 3.0f     // Packet loss percent for poor quality
+#define SEND_RATE_BAD_LOSS 10.0f     // Packet loss percent for bad quality
+#define SEND_RATE_POOR_MAX_ENTITIES 64 // Nearest players sent per world state at poor quality
+#define SEND_RATE_BAD_MAX_ENTITIES 24  // Nearest players sent per world state at bad quality
+#define SEND_RATE_RECOVERY_TICKS 20  // Consecutive better samples needed before upgrading quality
+#define ENCRYPTION_ENABLED true      // Accept key exchanges and encrypt traffic for clients that ask for it
+#define REQUIRE_ENCRYPTION false     // Disconnect clients that send game traffic without a secure channel (Windows only, startup fails elsewhere)
+#define PRE_AUTH_PACKETS_PER_SECOND 20 // Packets a connection may send per second before logging in
+#define ENET_POOLED_ALLOCATOR true     // Serve ENet's allocations from thread-caching size-class pools
+#define NETWORK_LISTENERS 1            // ENet hosts sharing the port via SO_REUSEPORT, one network thread each (Linux)
+#define OVERLOAD_CONTROL true          // Degrade service in steps when ticks overrun
+#define OVERLOAD_TICK_BUDGET_MS 50     // World state tick latency treated as full load
+#define OVERLOAD_QUEUE_LIMIT 2000      // Queued thread pool tasks treated as full load
+#define OVERLOAD_RECOVER_TICKS 50      // Calm ticks before restoring a service level
+#define OVERLOAD_INTEREST_SCALE 0.6f   // Interest radius multiplier once interest is reduced
+#define WORLD_STATE_GRAIN 16           // Recipients per parallel world state chunk; 0 builds the tick on one thread
 
 // Database configuration
 #define USE_DATABASE true        // Enable database storage
@@ -1,5 +1,7 @@
 #include "DatabaseManager.h"
 
+#include <algorithm>
+
 DatabaseManager::DatabaseManager(Logger& loggerRef)
       : connection(nullptr), host("localhost"), user("gameserver"), password(""), database("gameserver"), port(3306), connected(false), logger(loggerRef)
 {
@@ -174,11 +176,21 @@ bool DatabaseManager::createTablesIfNotExist()
 	                               "FOREIGN KEY (player_id) REFERENCES players(id) ON DELETE CASCADE"
 	                               ")";
 
+	// Ban and allow rules by CIDR
+	std::string createBansTable = "CREATE TABLE IF NOT EXISTS bans ("
+	                              "cidr VARCHAR(64) PRIMARY KEY,"
+	                              "allow_rule BOOLEAN DEFAULT FALSE,"
+	                              "reason VARCHAR(255),"
+	                              "created_by VARCHAR(64),"
+	                              "created_at TIMESTAMP NULL DEFAULT NULL"
+	                              ")";
+
 	// Execute table creation queries
 	bool success = true;
 	success &= executeQuery(createPlayersTable);
 	success &= executeQuery(createPositionsTable);
 	success &= executeQuery(createStatsTable);
+	success &= executeQuery(createBansTable);
 
 	return success;
 }
@@ -397,3 +409,82 @@ bool DatabaseManager::getPlayerIdByName(const std::string& username, uint32_t& p
 
 	return false;
 }
+
+bool DatabaseManager::saveBans(const std::vector<BanRule>& rules)
+{
+	if (!connected && !connect())
+	{
+		return false;
+	}
+
+	if (!beginTransaction())
+	{
+		return false;
+	}
+
+	// The table mirrors the in-memory list, so replace it wholesale
+	bool success = executeQuery("DELETE FROM bans");
+
+	// Insert in batches, a large list would otherwise take one round trip per rule
+	const size_t batchSize = 500;
+	for (size_t first = 0; success && first < rules.size(); first += batchSize)
+	{
+		std::string query = "INSERT INTO bans (cidr, allow_rule, reason, created_by, created_at) VALUES ";
+		const size_t last = (std::min)(rules.size(), first + batchSize);
+		for (size_t i = first; i < last; i++)
+		{
+			const BanRule& rule = rules[i];
+			query += (i == first ? "(" : ", (") + std::string("'") + escapeString(BanList::formatCidr(rule.network, rule.prefixLength)) + "', " + (rule.allow ? "TRUE" : "FALSE") + ", '" + escapeString(rule.reason) + "', '"
+			         + escapeString(rule.createdBy) + "', FROM_UNIXTIME(" + std::to_string(rule.createdAt) + "))";
+		}
+		success = executeQuery(query);
+	}
+
+	if (success)
+	{
+		return commitTransaction();
+	}
+
+	rollbackTransaction();
+	return false;
+}
+
+bool DatabaseManager::loadBans(std::vector<BanRule>& rules)
+{
+	if (!connected && !connect())
+	{
+		return false;
+	}
+
+	if (!executeQuery("SELECT cidr, allow_rule, reason, created_by, UNIX_TIMESTAMP(created_at) FROM bans"))
+	{
+		return false;
+	}
+
+	MySQLResultPtr result = getQueryResult();
+	if (!result)
+	{
+		logger.error("Failed to get query result");
+		return false;
+	}
+
+	rules.clear();
+	MYSQL_ROW row;
+	while ((row = mysql_fetch_row(result.get())))
+	{
+		BanRule rule;
+		if (!row[0] || !BanList::parseCidr(row[0], rule.network, rule.prefixLength))
+		{
+			logger.warning("Skipping invalid ban entry: " + std::string(row[0] ? row[0] : ""));
+			continue;
+		}
+		rule.allow = row[1] ? (std::string(row[1]) == "1") : false;
+		rule.reason = row[2] ? row[2] : "";
+		rule.createdBy = row[3] ? row[3] : "";
+		rule.createdAt = row[4] ? std::stoll(row[4]) : 0;
+		rules.push_back(std::move(rule));
+	}
+
+	logger.info("Loaded " + std::to_string(rules.size()) + " ban rules from database");
+	return true;
+}
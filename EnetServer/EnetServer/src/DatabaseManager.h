@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "BanList.h"
 #include "Logger.h"
 #include "Structs.h"
 
@@ -50,6 +51,10 @@ public:
 	bool savePlayerPosition(uint32_t playerId, const Position& position);
 	bool getPlayerIdByName(const std::string& username, uint32_t& playerId);
 
+	// Ban list operations
+	bool saveBans(const std::vector<BanRule>& rules);
+	bool loadBans(std::vector<BanRule>& rules);
+
 private:
 	MYSQL* connection;
 	std::string host;
@@ -0,0 +1,112 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Offset of the first address at or after data + from that is a multiple of alignment
+	size_t alignedOffset(const std::byte* data, size_t from, size_t alignment)
+	{
+		const uintptr_t address = reinterpret_cast<uintptr_t>(data) + from;
+		return from + ((alignment - address % alignment) % alignment);
+	}
+} // namespace
+
+FrameArena::FrameArena(size_t blockBytes, std::pmr::memory_resource* upstream)
+      : upstream(upstream), blockBytes(blockBytes)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	for (auto& block: blocks)
+	{
+		upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+	}
+}
+
+FrameArena& FrameArena::forThisThread()
+{
+	thread_local FrameArena arena;
+	return arena;
+}
+
+void FrameArena::reset()
+{
+	// A tick that spilled into several blocks gets one block big enough for all of them next time
+	if (blocks.size() > 1)
+	{
+		const size_t total = getBytesReserved();
+		for (auto& block: blocks)
+		{
+			upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+		}
+		blocks.clear();
+		addBlock(total);
+	}
+
+	current = 0;
+	offset = 0;
+	bytesUsed = 0;
+	peakBytes = 0;
+}
+
+size_t FrameArena::getBytesReserved() const
+{
+	size_t total = 0;
+	for (const auto& block: blocks)
+	{
+		total += block.size;
+	}
+	return total;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+	if (!blocks.empty())
+	{
+		const size_t start = alignedOffset(blocks[current].data, offset, alignment);
+		if (start + bytes <= blocks[current].size)
+		{
+			offset = start + bytes;
+			bytesUsed += bytes;
+			peakBytes = (std::max)(peakBytes, bytesUsed);
+			return blocks[current].data + start;
+		}
+	}
+
+	// Move on to the next kept block if it is big enough, otherwise add one
+	if (blocks.empty() || current + 1 >= blocks.size() || bytes + alignment > blocks[current + 1].size)
+	{
+		addBlock(bytes + alignment);
+	}
+	else
+	{
+		current++;
+	}
+
+	const size_t start = alignedOffset(blocks[current].data, 0, alignment);
+	offset = start + bytes;
+	bytesUsed += bytes;
+	peakBytes = (std::max)(peakBytes, bytesUsed);
+	return blocks[current].data + start;
+}
+
+void FrameArena::addBlock(size_t minimumBytes)
+{
+	const size_t size = (std::max)(blockBytes, minimumBytes);
+	Block block{ static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t))), size };
+	upstreamAllocations++;
+
+	// New blocks go right after the current one so the rest stay in line for this tick
+	if (blocks.empty())
+	{
+		blocks.push_back(block);
+		current = 0;
+	}
+	else
+	{
+		blocks.insert(blocks.begin() + current + 1, block);
+		current++;
+	}
+}
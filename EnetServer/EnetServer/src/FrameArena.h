@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for data that only lives for one tick task. std::pmr containers built on it
+// cost a pointer bump per allocation and nothing per free; reset() at the end of the task
+// rewinds the whole arena at once. Blocks are kept across resets (and merged into one after
+// a tick that needed several), so once warmed up a tick never reaches the system allocator.
+// Each worker thread has its own arena and nothing here is synchronized.
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+	explicit FrameArena(size_t blockBytes = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+	~FrameArena() override;
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Arena owned by the calling thread
+	static FrameArena& forThisThread();
+
+	// Give back everything handed out since the last reset; containers using it must be gone
+	void reset();
+
+	// Rewinds the arena to where it stood on construction, so per-item scratch inside a tick
+	// reuses the same bytes; declare it before the containers it outlives
+	class Scope
+	{
+	public:
+		explicit Scope(FrameArena& arena)
+		      : arena(arena), block(arena.current), offset(arena.offset), bytesUsed(arena.bytesUsed)
+		{
+		}
+
+		~Scope()
+		{
+			arena.current = block;
+			arena.offset = offset;
+			arena.bytesUsed = bytesUsed;
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		FrameArena& arena;
+		size_t block;
+		size_t offset;
+		size_t bytesUsed;
+	};
+
+	// Most bytes in use at once since the last reset
+	size_t getPeakBytes() const
+	{
+		return peakBytes;
+	}
+
+	size_t getBytesReserved() const;
+
+	// Blocks taken from the upstream resource so far; diff two reads to see whether a tick outgrew the arena
+	uint64_t getUpstreamAllocations() const
+	{
+		return upstreamAllocations;
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+
+	void do_deallocate(void*, size_t, size_t) override
+	{
+		// Freed all at once by reset()
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+private:
+	struct Block
+	{
+		std::byte* data;
+		size_t size;
+	};
+
+	std::pmr::memory_resource* upstream;
+	std::vector<Block> blocks;
+	size_t current = 0; // Block being bumped
+	size_t offset = 0;  // Next free byte in it
+	size_t blockBytes;
+	size_t bytesUsed = 0;
+	size_t peakBytes = 0;
+	uint64_t upstreamAllocations = 0;
+
+	void addBlock(size_t minimumBytes);
+};
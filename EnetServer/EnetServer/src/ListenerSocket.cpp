@@ -0,0 +1,47 @@
+#include "ListenerSocket.h"
+
+#ifdef __linux__
+#	include <sys/socket.h>
+#endif
+
+bool ListenerSocket::canShare()
+{
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	return true;
+#else
+	// Windows lets sockets share a port but delivers each datagram to one of them arbitrarily
+	return false;
+#endif
+}
+
+ENetHost* ListenerSocket::createHost(const ENetAddress& address, size_t peerCount, size_t channelLimit, bool shared)
+{
+	if (!shared || !canShare())
+	{
+		return enet_host_create(&address, peerCount, channelLimit, 0, 0);
+	}
+
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	// An unbound host gets its socket and buffers set up; the option has to be set before bind
+	ENetHost* host = enet_host_create(nullptr, peerCount, channelLimit, 0, 0);
+	if (host == nullptr)
+	{
+		return nullptr;
+	}
+
+	const int enable = 1;
+	if (setsockopt(host->socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0 || enet_socket_bind(host->socket, &address) != 0)
+	{
+		enet_host_destroy(host);
+		return nullptr;
+	}
+
+	if (enet_socket_get_address(host->socket, &host->address) != 0)
+	{
+		host->address = address;
+	}
+	return host;
+#else
+	return nullptr;
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <enet/enet.h>
+
+// ENet hosts that can share one UDP port. With SO_REUSEPORT the kernel hashes each client's
+// address to one of the bound sockets, so every host sees a stable subset of the connections
+// and can be serviced by its own network thread.
+class ListenerSocket
+{
+public:
+	// True where the platform balances datagrams across sockets bound to the same port (Linux)
+	static bool canShare();
+
+	// Create a host bound to address; shared binds with SO_REUSEPORT so more hosts can join the port
+	static ENetHost* createHost(const ENetAddress& address, size_t peerCount, size_t channelLimit, bool shared);
+};
@@ -0,0 +1,98 @@
+#include "OverloadController.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr size_t MAX_HISTORY = 8;
+	constexpr float SMOOTHING = 0.3f; // Weight of the newest sample
+} // namespace
+
+void OverloadController::configure(const Settings& newSettings)
+{
+	settings = newSettings;
+	settings.tickBudgetMs = (std::max)(settings.tickBudgetMs, 1u);
+	settings.queueLimit = (std::max)(settings.queueLimit, size_t(1));
+}
+
+bool OverloadController::sample(uint32_t tickLatencyMs, size_t queuedTasks, uint32_t nowMs)
+{
+	// Whichever of latency and backlog is closer to its limit sets the load
+	const float tickLoad = static_cast<float>(tickLatencyMs) / static_cast<float>(settings.tickBudgetMs);
+	const float queueLoad = static_cast<float>(queuedTasks) / static_cast<float>(settings.queueLimit);
+	const float load = smoothedLoad.load(std::memory_order_relaxed) * (1.0f - SMOOTHING) + (std::max)(tickLoad, queueLoad) * SMOOTHING;
+	smoothedLoad.store(load, std::memory_order_relaxed);
+
+	if (forced.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	// Degrade quickly, recover slowly; the gap between 1.0 and recoverLoad keeps the level from flapping
+	const OverloadLevel current = getLevel();
+	if (load >= 1.0f)
+	{
+		calmSamples = 0;
+		if (++overloadedSamples >= settings.escalateSamples && current < OverloadLevel::RefuseLogins)
+		{
+			changeLevel(static_cast<OverloadLevel>(static_cast<uint8_t>(current) + 1), nowMs);
+			overloadedSamples = 0;
+			return true;
+		}
+	}
+	else if (load < settings.recoverLoad)
+	{
+		overloadedSamples = 0;
+		if (++calmSamples >= settings.recoverSamples && current > OverloadLevel::Normal)
+		{
+			changeLevel(static_cast<OverloadLevel>(static_cast<uint8_t>(current) - 1), nowMs);
+			calmSamples = 0;
+			return true;
+		}
+	}
+	else
+	{
+		overloadedSamples = 0;
+		calmSamples = 0;
+	}
+	return false;
+}
+
+void OverloadController::forceLevel(OverloadLevel next, bool automatic, uint32_t nowMs)
+{
+	forced.store(!automatic, std::memory_order_relaxed);
+	if (!automatic && next != getLevel())
+	{
+		changeLevel(next, nowMs);
+	}
+}
+
+std::vector<OverloadController::Transition> OverloadController::getRecentTransitions() const
+{
+	std::lock_guard<std::mutex> lock(historyMutex);
+	return std::vector<Transition>(history.begin(), history.end());
+}
+
+const char* OverloadController::levelName(OverloadLevel level)
+{
+	static const char* names[] = { "normal", "reduced far updates", "reduced interest", "deferred background work", "refusing logins" };
+	return names[static_cast<size_t>(level)];
+}
+
+void OverloadController::changeLevel(OverloadLevel next, uint32_t nowMs)
+{
+	Transition transition;
+	transition.timeMs = nowMs;
+	transition.from = getLevel();
+	transition.to = next;
+	transition.load = getLoad();
+
+	level.store(next, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(historyMutex);
+	history.push_back(transition);
+	if (history.size() > MAX_HISTORY)
+	{
+		history.pop_front();
+	}
+}
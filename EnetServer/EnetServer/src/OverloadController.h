@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Service levels, each one also applies everything below it
+enum class OverloadLevel : uint8_t
+{
+	Normal = 0,
+	ReduceFarUpdates, // World state carries only the nearest players
+	ReduceInterest,   // Smaller interest radius
+	DeferBackground,  // Persistence and plugin ticks wait
+	RefuseLogins      // New logins are turned away
+};
+
+// Watches world state tick latency and thread pool queue depth once per update tick and
+// steps the service level down under pressure, back up only after a sustained calm period
+class OverloadController
+{
+public:
+	struct Settings
+	{
+		uint32_t tickBudgetMs = 50;   // Tick latency counted as full load
+		size_t queueLimit = 2000;     // Queued tasks counted as full load
+		uint32_t escalateSamples = 3; // Consecutive overloaded samples before degrading a step
+		uint32_t recoverSamples = 50; // Consecutive calm samples before restoring a step
+		float recoverLoad = 0.5f;     // Load must fall below this to count as calm
+	};
+
+	struct Transition
+	{
+		uint32_t timeMs = 0;
+		OverloadLevel from = OverloadLevel::Normal;
+		OverloadLevel to = OverloadLevel::Normal;
+		float load = 0.0f;
+	};
+
+	void configure(const Settings& newSettings);
+
+	// Feed one sample; returns true when the level changed. Update thread only.
+	bool sample(uint32_t tickLatencyMs, size_t queuedTasks, uint32_t nowMs);
+
+	// Pin the level from the console, or hand control back with automatic = true
+	void forceLevel(OverloadLevel level, bool automatic, uint32_t nowMs);
+
+	OverloadLevel getLevel() const
+	{
+		return level.load(std::memory_order_relaxed);
+	}
+
+	bool atLeast(OverloadLevel threshold) const
+	{
+		return getLevel() >= threshold;
+	}
+
+	float getLoad() const
+	{
+		return smoothedLoad.load(std::memory_order_relaxed);
+	}
+
+	bool isForced() const
+	{
+		return forced.load(std::memory_order_relaxed);
+	}
+
+	std::vector<Transition> getRecentTransitions() const;
+
+	static const char* levelName(OverloadLevel level);
+
+private:
+	void changeLevel(OverloadLevel next, uint32_t nowMs);
+
+	Settings settings;
+	std::atomic<OverloadLevel> level{ OverloadLevel::Normal };
+	std::atomic<float> smoothedLoad{ 0.0f };
+	std::atomic<bool> forced{ false };
+	uint32_t overloadedSamples = 0;
+	uint32_t calmSamples = 0;
+
+	mutable std::mutex historyMutex;
+	std::deque<Transition> history;
+};
@@ -20,13 +20,19 @@
 #include <future>
 
 // Configuration
+#include "BanList.h"
+#include "BulkStreamer.h"
+#include "ClockSync.h"
 #include "Constants.h"
 #include "DatabaseManager.h"
+#include "FrameArena.h"
 #include "Logger.h"
+#include "OverloadController.h"
 #include "PluginManager.h"
 #include "SpatialGrid.h"
 #include "Structs.h"
 #include "ThreadManager.h"
+#include "VisiblePlayers.h"
 #include "PacketManager.h"
 
 // Command handler function type
@@ -40,10 +46,12 @@ struct ServerStats
 	uint32_t authFailures = 0;
 	uint32_t maxConcurrentPlayers = 0;
 	uint32_t totalPacketsSent = 0;
-	uint32_t totalPacketsReceived = 0;
+	std::atomic<uint32_t> totalPacketsReceived{ 0 }; // Received counters are written by every network thread
 	uint32_t totalBytesSent = 0;
-	uint32_t totalBytesReceived = 0;
+	std::atomic<uint32_t> totalBytesReceived{ 0 };
 	uint32_t chatMessagesSent = 0;
+	std::atomic<uint32_t> preAuthDrops{ 0 };
+	std::atomic<uint32_t> refusedConnections{ 0 };
 
 	ServerStats();
 	static uint32_t getCurrentTimeMs();
@@ -68,6 +76,31 @@ struct ServerConfig
 	int logLevel = 1; // 0=errors only, 1=normal, 2=debug
 	bool enableChat = true;
 	Position spawnPosition = { DEFAULT_SPAWN_X, DEFAULT_SPAWN_Y, DEFAULT_SPAWN_Z };
+	bool compactWorldState = COMPACT_WORLD_STATE;
+	uint32_t worldStateChunkBytes = WORLD_STATE_CHUNK_BYTES;
+	uint32_t bulkBytesPerTick = BULK_BYTES_PER_TICK;
+	uint32_t bulkWindowBytes = BULK_WINDOW_BYTES;
+	bool adaptiveSendRate = ADAPTIVE_SEND_RATE;
+	uint32_t sendRateFairRttMs = SEND_RATE_FAIR_RTT_MS;
+	uint32_t sendRatePoorRttMs = SEND_RATE_POOR_RTT_MS;
+	uint32_t sendRateBadRttMs = SEND_RATE_BAD_RTT_MS;
+	float sendRateFairLoss = SEND_RATE_FAIR_LOSS;
+	float sendRatePoorLoss = SEND_RATE_POOR_LOSS;
+	float sendRateBadLoss = SEND_RATE_BAD_LOSS;
+	uint32_t sendRatePoorMaxEntities = SEND_RATE_POOR_MAX_ENTITIES;
+	uint32_t sendRateBadMaxEntities = SEND_RATE_BAD_MAX_ENTITIES;
+	uint32_t sendRateRecoveryTicks = SEND_RATE_RECOVERY_TICKS;
+	bool encryptionEnabled = ENCRYPTION_ENABLED;
+	bool requireEncryption = REQUIRE_ENCRYPTION;
+	uint32_t preAuthPacketsPerSecond = PRE_AUTH_PACKETS_PER_SECOND;
+	bool enetPooledAllocator = ENET_POOLED_ALLOCATOR;
+	uint32_t networkListeners = NETWORK_LISTENERS;
+	bool overloadControl = OVERLOAD_CONTROL;
+	uint32_t overloadTickBudgetMs = OVERLOAD_TICK_BUDGET_MS;
+	uint32_t overloadQueueLimit = OVERLOAD_QUEUE_LIMIT;
+	uint32_t overloadRecoverTicks = OVERLOAD_RECOVER_TICKS;
+	float overloadInterestScale = OVERLOAD_INTEREST_SCALE;
+	uint32_t worldStateGrain = WORLD_STATE_GRAIN;
 
 	// Database configuration
 	std::string dbHost = DB_HOST;
@@ -78,6 +111,23 @@ struct ServerConfig
 	bool useDatabase = USE_DATABASE;
 };
 
+// World state quality tier for a peer, worse tiers send less often and with less detail
+enum class SendQuality : uint8_t
+{
+	Good = 0,
+	Fair,
+	Poor,
+	Bad
+};
+
+// Per-peer adaptive send state
+struct PeerSendState
+{
+	SendQuality quality = SendQuality::Good;
+	uint32_t ticksSinceSend = 0;
+	uint32_t recoverySamples = 0; // Consecutive samples better than the current quality
+};
+
 // Packet stats
 struct PacketStats
 {
@@ -85,6 +135,38 @@ struct PacketStats
 	std::atomic<uint32_t> totalBytesReceived{ 0 };
 };
 
+// One ENet host on the server port and the thread that services it; its peers own the
+// connection slots [slotBase, slotBase + host->peerCount)
+struct NetworkListener
+{
+	ENetHost* host = nullptr;
+	uint32_t slotBase = 0;
+	uint32_t index = 0;
+	std::thread thread; // Listeners after the first; the first runs on the thread pool
+	std::atomic<uint32_t> packetsReceived{ 0 };
+};
+
+// Per-connection state, indexed by listener slotBase + ENetPeer::incomingPeerID
+struct ConnectionSlot
+{
+	ENetPeer* peer = nullptr; // Null while the slot is free
+	uint32_t playerId = 0;    // 0 until the connection authenticates
+	Player* player = nullptr; // &guest before authentication, the players map entry after
+	Player guest;
+	PeerSendState sendState;
+	PacketStats traffic; // Updated lock-free from the network and send paths
+
+	// Pre-auth filter state; the flag is set by the auth tasks, the budget belongs to the peer's network thread
+	std::atomic<bool> authenticated{ false };
+	uint32_t preAuthWindowStart = 0;
+	uint32_t preAuthPackets = 0;
+
+	// ENet reuses a freed peer right away, so connect, disconnect, message, auth and registration tasks carry the
+	// generation the network thread saw at their event; 'generation' is the one the slot's state currently belongs to
+	std::atomic<uint32_t> latestGeneration{ 0 }; // Bumped by the network thread on every connect and disconnect
+	uint32_t generation = 0;
+};
+
 namespace GameResources
 {
 	// Helper to create resource IDs with the right type
@@ -103,8 +185,8 @@ namespace GameResources
 	const ResourceId PluginsId = create<PluginManager>("plugins");
 	const ResourceId ConfigId = create<ServerConfig>("config");
 	const ResourceId DatabaseId = create<DatabaseManager>("database");
-	const ResourceId PeerDataId = create<void*>("peerData");
-	const ResourceId PeerStatsId = create<PacketStats>("peerStats");
+	const ResourceId ConnectionSlotsId = create<ConnectionSlot>("connectionSlots");
+	const ResourceId BulkStreamsId = create<BulkStreamer>("bulkStreams");
 }
 
 // Main game server class
@@ -132,7 +214,7 @@ public:
 
 	void broadcastSystemMessage(const std::string& message);
 
-	std::vector<std::string> getOnlinePlayerNames();
+	Task<std::vector<std::string>> getOnlinePlayerNames();
 
 	Logger logger;
 
@@ -140,10 +222,11 @@ private:
 	// Packet manager instance
 	PacketManager packetManager;
 
-	// Network
-	ENetHost* server = nullptr;
-	bool isRunning = false;
-	bool stopRequested = false;
+	// Network; usually one listener, more only with SO_REUSEPORT
+	std::unique_ptr<NetworkListener[]> listeners;
+	uint32_t listenerCount = 0;
+	std::atomic<bool> isRunning{ false }; // Read by the listener threads and recurring tasks
+	std::atomic<bool> stopRequested{ false };
 
 	// Thread Manager
 	ThreadManager threadManager;
@@ -166,6 +249,27 @@ private:
 	// Chat history
 	std::deque<ChatMessage> chatHistory;
 
+	// Bulk transfers (chat backfill, world sync) drained on the bulk channel
+	BulkStreamer bulkStreamer;
+
+	// Address ban and allow rules, checked on the network thread at connect
+	BanList banList;
+
+	// Service level under load, sampled once per update tick
+	OverloadController overload;
+	std::atomic<uint32_t> worldStateLatencyMs{ 0 }; // Schedule-to-finish time of the last world state task
+	std::atomic<uint64_t> worldStateArenaBlocks{ 0 }; // Blocks the frame arenas had to take from the heap during it
+	std::atomic<size_t> worldStateArenaBytes{ 0 };    // Frame arena bytes it used
+	std::atomic<bool> saveDeferred{ false };
+
+	// World state snapshot counter, shared by all chunks of one broadcast
+	std::atomic<uint32_t> worldSnapshotId{ 0 };
+
+	// One slot per ENet peer across all listeners (guarded by ConnectionSlots)
+	std::unique_ptr<ConnectionSlot[]> connectionSlots;
+	uint32_t connectionSlotCount = 0;
+	uint32_t activeConnections = 0;
+
 	// Command handlers
 	std::unordered_map<std::string, CommandHandler> commandHandlers;
 
@@ -183,16 +287,13 @@ private:
 	std::thread updateThread;
 	std::thread saveThread;
 
-	// Stats tracking
-	std::unordered_map<uintptr_t, PacketStats> peerStats;
-
 	// Pliugins
 	std::unique_ptr<PluginManager> pluginManager;
 	uint32_t pluginCheckIntervalMs = 5000; // Check for plugin updates every 5 seconds
 	uint32_t lastPluginCheckTime = 0;
 
 	// Private methods
-	void networkTaskFunc();
+	void networkTaskFunc(NetworkListener& listener);
 	void updateTaskFunc();
 	void saveTaskFunc();
 
@@ -202,22 +303,31 @@ private:
 	void handleClientConnect(const ENetEvent& event);
 	void handleClientMessage(const ENetEvent& event);
 	void handleClientDisconnect(const ENetEvent& event);
-	void handleAuthMessage(const std::string& authDataStr, ENetPeer* peer);
-	void handleRegistration(const Player& player, const std::string& username, const std::string& password);
+	void handleAuthMessage(const std::string& authDataStr, ENetPeer* peer, uint32_t generation);
+	void handleRegistration(const Player& player, const std::string& username, const std::string& password, uint32_t generation);
 	void syncPlayerStats();
+	ConnectionSlot* slotFor(ENetPeer* peer);
+	static bool isPreAuthPacketType(GameProtocol::PacketType type);
+	bool admitPreAuthPacket(ConnectionSlot& slot, ENetPeer* peer, GameProtocol::PacketType type);
 	void handleDeltaPositionUpdate(uint32_t playerId, const std::string& deltaData);
 	void handleSendPosition(uint32_t playerId);
-	void handleChatMessage(const Player& player, const std::string& message);
-	void handlePingMessage(const Player& player, const std::string& pingData);
+	Task<> handleChatMessage(Player player, std::string message);
+	void handlePing(ENetPeer* peer, const GameProtocol::PingPacket& ping, uint64_t receiveTime);
+	void handleKeyExchange(ENetPeer* peer, const GameProtocol::KeyExchangePacket& request);
 	void handleCommandMessage(const Player& player, const std::string& commandStr);
 
-    void sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable);
+    void sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable, GameProtocol::Channel channel = GameProtocol::Channel::Realtime);
+	void sendSerialized(ENetPeer* peer, std::vector<uint8_t> data, GameProtocol::PacketType type, bool reliable, GameProtocol::Channel channel = GameProtocol::Channel::Realtime);
+	std::function<void(size_t)> makeSentStatsCallback(ENetPeer* peer);
     void sendSystemMessage(const Player& player, const std::string& message);
     void sendAuthResponse(ENetPeer* peer, bool success, const std::string& message, uint32_t playerId = 0);
     void sendTeleport(const Player& player, const Position& position);
     void broadcastChatMessage(const std::string& sender, const std::string& message);
     void broadcastWorldState();
-	void handlePacket(const Player& player, std::unique_ptr<GameProtocol::Packet> packet);
+	float currentInterestRadius() const;
+	void queueJoinStreams(ENetPeer* peer, const Player& player);
+	SendQuality updatePeerSendQuality(Player& player, PeerSendState& state);
+	void handlePacket(const Player& player, uint32_t generation, std::unique_ptr<GameProtocol::Packet> packet);
 
 	void handlePositionUpdate(uint32_t playerId, const Position& newPos);
 
@@ -225,12 +335,16 @@ private:
 	void savePlayerData(const std::string& username, const Position& lastPos);
 	void loadAuthData();
 	void saveAuthData();
+	void loadBanList();
+	void saveBanList();
+	void printBanList();
 	void loadConfig();
 	void createDefaultConfig();
 	void initializeCommandHandlers();
-	bool kickPlayer(const std::string& playerName, const std::string& adminName = "Server");
-	bool banPlayer(const std::string& playerName, const std::string& adminName = "Server");
+	Task<bool> kickPlayer(std::string playerName, std::string adminName = "Server");
+	Task<bool> banPlayer(std::string playerName, std::string adminName = "Server");
 	bool setPlayerAdmin(const std::string& playerName, bool isAdmin);
+	Task<bool> updateAdminStatus(std::string playerName, bool isAdmin, ENetPeer* requester = nullptr);
 	void printServerStatus();
 	void printPlayerList();
 	void printConsoleHelp();
@@ -1,5 +1,7 @@
 #include "SpatialGrid.h"
 
+#include <algorithm>
+
 SpatialGrid::SpatialGrid(float cellSize)
       : cellSize(cellSize)
 {
@@ -19,7 +21,7 @@ void SpatialGrid::getCellCoords(const Position& pos, int& cellX, int& cellZ) con
 
 void SpatialGrid::updateEntity(uint32_t entityId, const Position& oldPos, const Position& newPos)
 {
-	std::lock_guard<std::mutex> lock(gridMutex);
+	std::lock_guard<std::shared_mutex> lock(gridMutex);
 
 	int oldCellX, oldCellZ;
 	int newCellX, newCellZ;
@@ -52,7 +54,7 @@ void SpatialGrid::updateEntity(uint32_t entityId, const Position& oldPos, const
 
 void SpatialGrid::addEntity(uint32_t entityId, const Position& pos)
 {
-	std::lock_guard<std::mutex> lock(gridMutex);
+	std::lock_guard<std::shared_mutex> lock(gridMutex);
 
 	int cellX, cellZ;
 	getCellCoords(pos, cellX, cellZ);
@@ -63,7 +65,7 @@ void SpatialGrid::addEntity(uint32_t entityId, const Position& pos)
 
 void SpatialGrid::removeEntity(uint32_t entityId, const Position& pos)
 {
-	std::lock_guard<std::mutex> lock(gridMutex);
+	std::lock_guard<std::shared_mutex> lock(gridMutex);
 
 	int cellX, cellZ;
 	getCellCoords(pos, cellX, cellZ);
@@ -84,7 +86,7 @@ void SpatialGrid::removeEntity(uint32_t entityId, const Position& pos)
 
 std::set<uint32_t> SpatialGrid::getNearbyEntities(const Position& pos, float radius)
 {
-	std::lock_guard<std::mutex> lock(gridMutex);
+	std::shared_lock<std::shared_mutex> lock(gridMutex);
 	std::set<uint32_t> result;
 
 	// Calculate cell range to check
@@ -112,8 +114,33 @@ std::set<uint32_t> SpatialGrid::getNearbyEntities(const Position& pos, float rad
 	return result;
 }
 
+void SpatialGrid::getNearbyEntities(const Position& pos, float radius, std::pmr::vector<uint32_t>& result)
+{
+	std::shared_lock<std::shared_mutex> lock(gridMutex);
+	const size_t first = result.size();
+
+	int cellRadius = static_cast<int>(std::ceil(radius / cellSize));
+	int centerCellX, centerCellZ;
+	getCellCoords(pos, centerCellX, centerCellZ);
+
+	for (int dz = -cellRadius; dz <= cellRadius; ++dz)
+	{
+		for (int dx = -cellRadius; dx <= cellRadius; ++dx)
+		{
+			auto cellIt = grid.find(getCellKey(centerCellX + dx, centerCellZ + dz));
+			if (cellIt != grid.end())
+			{
+				result.insert(result.end(), cellIt->second.begin(), cellIt->second.end());
+			}
+		}
+	}
+
+	// An entity is in exactly one cell, so sorting is all the set did for us
+	std::sort(result.begin() + first, result.end());
+}
+
 void SpatialGrid::clear()
 {
-	std::lock_guard<std::mutex> lock(gridMutex);
+	std::lock_guard<std::shared_mutex> lock(gridMutex);
 	grid.clear();
 }
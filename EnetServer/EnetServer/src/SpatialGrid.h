@@ -1,8 +1,11 @@
 #pragma once
 #include <cstdint>
+#include <memory_resource>
 #include <set>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 #include "Structs.h"
 
 class SpatialGrid
@@ -13,12 +16,14 @@ public:
 	void addEntity(uint32_t entityId, const Position& pos);
 	void removeEntity(uint32_t entityId, const Position& pos);
 	std::set<uint32_t> getNearbyEntities(const Position& pos, float radius);
+	// Same ids, appended to result in ascending order; no node allocations when result sits in an arena
+	void getNearbyEntities(const Position& pos, float radius, std::pmr::vector<uint32_t>& result);
 	void clear();
 
 private:
 	float cellSize;
 	std::unordered_map<int64_t, std::set<uint32_t>> grid;
-	std::mutex gridMutex;
+	std::shared_mutex gridMutex; // Queries share it, so parallel world state builds don't queue on it
 
 	int64_t getCellKey(int cellX, int cellZ) const;
 	void getCellCoords(const Position& pos, int& cellX, int& cellZ) const;
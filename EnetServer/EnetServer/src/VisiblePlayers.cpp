@@ -0,0 +1,44 @@
+#include "VisiblePlayers.h"
+
+#include <algorithm>
+
+void collectVisiblePlayers(const Player& player, const std::unordered_map<uint32_t, Player>& world, SpatialGrid& grid, float radius, std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView>& entries)
+{
+	// Ids come from the same memory resource as the entries
+	std::pmr::vector<uint32_t> visibleEntities(entries.get_allocator().resource());
+
+	// Get nearby entities
+	if (radius > 0)
+	{
+		grid.getNearbyEntities(player.position, radius, visibleEntities);
+	}
+	else
+	{
+		// No interest management, see all players
+		visibleEntities.reserve(world.size());
+		for (const auto& otherPair: world)
+		{
+			if (otherPair.second.isAuthenticated)
+			{
+				visibleEntities.push_back(otherPair.first);
+			}
+		}
+		std::sort(visibleEntities.begin(), visibleEntities.end());
+	}
+
+	entries.reserve(entries.size() + visibleEntities.size());
+
+	for (uint32_t entityId: visibleEntities)
+	{
+		// Skip self
+		if (entityId == player.id)
+			continue;
+
+		auto it = world.find(entityId);
+		if (it != world.end() && it->second.isAuthenticated)
+		{
+			const Player& otherPlayer = it->second;
+			entries.push_back({ otherPlayer.id, otherPlayer.name, otherPlayer.position });
+		}
+	}
+}
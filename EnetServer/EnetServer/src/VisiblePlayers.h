@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+#include "PacketTypes.h"
+#include "SpatialGrid.h"
+#include "Structs.h"
+
+// Append views of the players visible to 'player', in ascending id order; radius 0 sees every authenticated player.
+// The caller holds the locks guarding world and grid, and names are borrowed from world, so the entries must not outlive them
+void collectVisiblePlayers(const Player& player, const std::unordered_map<uint32_t, Player>& world, SpatialGrid& grid, float radius, std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView>& entries);
@@ -2,12 +2,15 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <functional>
 #include <iostream>
 
 #ifdef _WIN32
 #	include <conio.h>
 #endif
 
+#include "ListenerSocket.h"
+#include "PooledAllocator.h"
 #include "Utils.h"
 
 // Constructor
@@ -31,6 +34,7 @@ GameServer::GameServer()
 
 	// Load saved player data
 	loadAuthData();
+	loadBanList();
 
 	// Initialize plugin system
 	initializePluginSystem();
@@ -51,9 +55,18 @@ GameServer::~GameServer()
 // Initialize server
 bool GameServer::initialize()
 {
+	// Without secure channels every client would be refused once it sent game traffic
+	if (config.requireEncryption && !GameProtocol::SecureChannel::isAvailable())
+	{
+		logger.error("require_encryption is set but secure channels are not available on this platform");
+		return false;
+	}
+
 	logger.info("Initializing ENet...");
 
-	if (enet_initialize() != 0)
+	// Packets are created on worker threads and freed on the network thread; pools keep that off the system heap
+	const ENetCallbacks callbacks = PooledAllocator::callbacks();
+	if ((config.enetPooledAllocator ? enet_initialize_with_callbacks(ENET_VERSION, &callbacks) : enet_initialize()) != 0)
 	{
 		logger.error("Failed to initialize ENet");
 		return false;
@@ -63,21 +76,56 @@ bool GameServer::initialize()
 	address.host = ENET_HOST_ANY;
 	address.port = config.port;
 
-	logger.info("Creating server host on port " + std::to_string(config.port));
+	// Extra listeners only help where the kernel spreads clients across sockets on one port
+	listenerCount = (std::max)(config.networkListeners, 1u);
+	if (listenerCount > 1 && !ListenerSocket::canShare())
+	{
+		logger.warning("network_listeners=" + std::to_string(listenerCount) + " needs SO_REUSEPORT, using a single listener");
+		listenerCount = 1;
+	}
 
-	server = enet_host_create(&address,
-	        config.maxPlayers,
-	        4, // Number of channels
-	        0, // Unlimited incoming bandwidth
-	        0  // Unlimited outgoing bandwidth
-	);
+	logger.info("Creating " + std::to_string(listenerCount) + (listenerCount == 1 ? " server host" : " server hosts") + " on port " + std::to_string(config.port));
 
-	if (server == nullptr)
+	// Each host gets an even share of the player limit; the kernel decides which one a client lands on
+	const size_t peersPerListener = (config.maxPlayers + listenerCount - 1) / listenerCount;
+	listeners = std::make_unique<NetworkListener[]>(listenerCount);
+	uint32_t slotBase = 0;
+	for (uint32_t i = 0; i < listenerCount; i++)
 	{
-		logger.error("Failed to create ENet server host");
-		enet_deinitialize();
-		return false;
+		NetworkListener& listener = listeners[i];
+		listener.index = i;
+		listener.slotBase = slotBase;
+		listener.host = ListenerSocket::createHost(address,
+		        peersPerListener,
+		        4, // Number of channels
+		        listenerCount > 1);
+
+		if (listener.host == nullptr)
+		{
+			logger.error("Failed to create ENet server host");
+			for (uint32_t j = 0; j < i; j++)
+			{
+				enet_host_destroy(listeners[j].host);
+			}
+			listeners.reset();
+			listenerCount = 0;
+			enet_deinitialize();
+			return false;
+		}
+
+		slotBase += static_cast<uint32_t>(listener.host->peerCount);
 	}
+	banList.setReaderCount(listenerCount);
+
+	OverloadController::Settings overloadSettings;
+	overloadSettings.tickBudgetMs = config.overloadTickBudgetMs;
+	overloadSettings.queueLimit = config.overloadQueueLimit;
+	overloadSettings.recoverSamples = config.overloadRecoverTicks;
+	overload.configure(overloadSettings);
+
+	// ENet hands out incomingPeerID in [0, peerCount) per host, so slotBase + id indexes the slot table directly
+	connectionSlotCount = slotBase;
+	connectionSlots = std::make_unique<ConnectionSlot[]>(connectionSlotCount);
 
 	logger.info("Server initialized successfully on port " + std::to_string(config.port));
 	return true;
@@ -304,7 +352,7 @@ void GameServer::start()
 		return;
 	}
 
-	if (server == nullptr && !initialize())
+	if (listeners == nullptr && !initialize())
 	{
 		logger.error("Failed to initialize server");
 		return;
@@ -315,10 +363,26 @@ void GameServer::start()
 	logger.info("Server starting...");
 
 	// Schedule all recurring tasks
-	scheduleRecurringTask([this]() { networkTaskFunc(); }, 1, networkTaskFuture, "Network");
+	scheduleRecurringTask([this]() { networkTaskFunc(listeners[0]); }, 1, networkTaskFuture, "Network");
 	scheduleRecurringTask([this]() { updateTaskFunc(); }, config.broadcastRateMs, updateTaskFuture, "Update");
 	scheduleRecurringTask([this]() { saveTaskFunc(); }, config.saveIntervalMs, saveTaskFuture, "Save");
 
+	// Further listeners get their own threads so they never wait behind pool tasks
+	for (uint32_t i = 1; i < listenerCount; i++)
+	{
+		NetworkListener& listener = listeners[i];
+		listener.thread = std::thread(
+		        [this, &listener]()
+		        {
+			        logger.info("Network " + std::to_string(listener.index) + " task started");
+			        while (!stopRequested)
+			        {
+				        networkTaskFunc(listener);
+			        }
+			        logger.info("Network " + std::to_string(listener.index) + " task stopped");
+		        });
+	}
+
 	logger.info("Server started successfully");
 
 	// Broadcast system message
@@ -328,7 +392,8 @@ void GameServer::start()
 // Shutdown server
 void GameServer::shutdown()
 {
-	if (!isRunning)
+	// Both run() and the destructor call this; only the first call shuts down
+	if (!isRunning.exchange(false))
 	{
 		return;
 	}
@@ -336,7 +401,6 @@ void GameServer::shutdown()
 	logger.info("Shutting down server...");
 
 	// Signal threads to stop
-	isRunning = false;
 	stopRequested = true;
 
 	// Unload plugins explicitly before shutting down threads
@@ -385,6 +449,14 @@ void GameServer::shutdown()
 			}
 		}
 
+		for (uint32_t i = 1; i < listenerCount; i++)
+		{
+			if (listeners[i].thread.joinable())
+			{
+				listeners[i].thread.join();
+			}
+		}
+
 		// Wait for all remaining tasks to complete
 		threadManager.waitForTasks();
 	}
@@ -394,10 +466,14 @@ void GameServer::shutdown()
 	}
 
 	// Clean up ENet
-	if (server != nullptr)
+	if (listeners != nullptr)
 	{
-		enet_host_destroy(server);
-		server = nullptr;
+		for (uint32_t i = 0; i < listenerCount; i++)
+		{
+			enet_host_destroy(listeners[i].host);
+		}
+		listeners.reset();
+		listenerCount = 0;
 		enet_deinitialize();
 	}
 
@@ -489,75 +565,165 @@ void GameServer::run()
 			threadManager.scheduleTask(
 			        [this, command]()
 			        {
-				        if (command == "status")
+				        // Dispatch on the whole first word; repeated spaces do not make empty arguments
+				        std::vector<std::string> args;
+				        for (auto& token: Utils::splitString(command, ' '))
+				        {
+					        if (!token.empty())
+						        args.push_back(std::move(token));
+				        }
+				        if (args.empty())
+					        return;
+
+				        const std::string& name = args[0];
+
+				        // Arguments from 'first' on, joined back into one string
+				        auto joinArguments = [&args](size_t first)
+				        {
+					        std::string joined;
+					        for (size_t i = first; i < args.size(); i++)
+					        {
+						        if (!joined.empty())
+							        joined += ' ';
+						        joined += args[i];
+					        }
+					        return joined;
+				        };
+
+				        if (name == "status")
 				        {
 					        printServerStatus();
 				        }
-				        else if (command == "players")
+				        else if (name == "players")
 				        {
 					        printPlayerList();
 				        }
-				        else if (command == "help")
+				        else if (name == "help")
 				        {
 					        printConsoleHelp();
 				        }
-				        else if (command.substr(0, 9) == "broadcast")
+				        else if (name == "broadcast")
+				        {
+					        if (args.size() < 2)
+					        {
+						        logger.error("Usage: broadcast <message>");
+						        return;
+					        }
+					        broadcastSystemMessage(joinArguments(1));
+				        }
+				        else if (name == "banip" || name == "allowip")
 				        {
-					        std::string message = command.substr(10);
-					        broadcastSystemMessage(message);
+					        // banip|allowip <address or CIDR> [reason]
+					        const bool allow = name == "allowip";
+					        if (args.size() < 2)
+					        {
+						        logger.error("Usage: " + name + " <address or CIDR> [reason]");
+						        return;
+					        }
+
+					        const std::string& cidr = args[1];
+					        std::string error;
+					        if (banList.addRule(cidr, allow, joinArguments(2), "Console", error))
+					        {
+						        logger.info(std::string(allow ? "Allowed " : "Banned ") + cidr);
+						        saveBanList();
+					        }
+					        else
+					        {
+						        logger.error(error);
+					        }
 				        }
-				        else if (command.substr(0, 4) == "kick")
+				        else if (name == "unbanip")
 				        {
-					        std::string playerName = command.substr(5);
-					        kickPlayer(playerName);
+					        if (args.size() != 2)
+					        {
+						        logger.error("Usage: unbanip <address or CIDR>");
+						        return;
+					        }
+
+					        const std::string& cidr = args[1];
+					        if (banList.removeRule(cidr))
+					        {
+						        logger.info("Removed ban rule " + cidr);
+						        saveBanList();
+					        }
+					        else
+					        {
+						        logger.error("No ban rule for " + cidr);
+					        }
 				        }
-				        else if (command.substr(0, 3) == "ban")
+				        else if (name == "bans")
 				        {
-					        std::string playerName = command.substr(4);
-					        banPlayer(playerName);
+					        printBanList();
 				        }
-				        else if (command == "save")
+				        else if (name == "overload")
 				        {
-					        saveAuthData();
-					        logger.info("Player data saved manually");
+					        // overload auto|0-4
+					        const std::string argument = args.size() == 2 ? args[1] : "";
+					        if (argument == "auto")
+					        {
+						        overload.forceLevel(OverloadLevel::Normal, true, Utils::getCurrentTimeMs());
+						        logger.info("Service level back under automatic control");
+					        }
+					        else if (argument.size() == 1 && argument[0] >= '0' && argument[0] <= '4')
+					        {
+						        const auto level = static_cast<OverloadLevel>(argument[0] - '0');
+						        overload.forceLevel(level, false, Utils::getCurrentTimeMs());
+						        logger.info(std::string("Service level forced to ") + OverloadController::levelName(level));
+					        }
+					        else
+					        {
+						        logger.error("Usage: overload auto|0-4");
+					        }
 				        }
-				        else if (command.substr(0, 8) == "setadmin")
+				        else if (name == "kick" || name == "ban" || name == "setadmin" || name == "removeadmin")
 				        {
-					        std::string playerName = command.substr(9);
-					        setPlayerAdmin(playerName, true);
+					        if (args.size() != 2)
+					        {
+						        logger.error("Usage: " + name + " <player>");
+						        return;
+					        }
+
+					        const std::string& playerName = args[1];
+					        if (name == "kick")
+						        threadManager.spawn(kickPlayer(playerName));
+					        else if (name == "ban")
+						        threadManager.spawn(banPlayer(playerName));
+					        else
+						        threadManager.spawn(updateAdminStatus(playerName, name == "setadmin"));
 				        }
-				        else if (command.substr(0, 11) == "removeadmin")
+				        else if (name == "save")
 				        {
-					        std::string playerName = command.substr(12);
-					        setPlayerAdmin(playerName, false);
+					        saveAuthData();
+					        logger.info("Player data saved manually");
 				        }
-				        else if (command == "reload")
+				        else if (name == "reload")
 				        {
 					        loadConfig();
 					        logger.info("Configuration reloaded");
 				        }
-				        else if (command.substr(0, 9) == "loglevel ")
+				        else if (name == "loglevel")
 				        {
 					        try
 					        {
-						        int level = std::stoi(command.substr(9));
+						        int level = std::stoi(args.size() == 2 ? args[1] : "");
 						        logger.setLogLevel((LogLevel) level);
 					        }
 					        catch (const std::exception&)
 					        {
-						        logger.error("Invalid log level: " + command.substr(9));
+						        logger.error("Usage: loglevel <level>");
 					        }
 				        }
-				        else if (command.substr(0, 7) == "plugins")
+				        else if (name == "plugins")
 				        {
 					        for (auto& plugin: pluginManager->getLoadedPlugins())
 					        {
 						        logger.info(plugin);
 					        }
 				        }
-				        else if (!command.empty())
+				        else
 				        {
-					        logger.info("Unknown command: " + command);
+					        logger.info("Unknown command: " + name);
 					        logger.info("Type 'help' for available commands");
 				        }
 			        });
@@ -568,23 +734,32 @@ void GameServer::run()
 }
 
 // Network thread function
-void GameServer::networkTaskFunc()
+void GameServer::networkTaskFunc(NetworkListener& listener)
 {
 	ENetEvent event;
 
 	// Process network events
-	while (enet_host_service(server, &event, 10) > 0)
+	while (enet_host_service(listener.host, &event, 10) > 0)
 	{
 		switch (event.type)
 		{
 			case ENET_EVENT_TYPE_CONNECT:
 			{
+				// Banned ranges are refused before a slot or a task is spent on them
+				if (banList.isBanned(event.peer->address, listener.index))
+				{
+					stats.refusedConnections++;
+					enet_peer_disconnect_now(event.peer, 0);
+					break;
+				}
+
 				handleClientConnect(event);
 				break;
 			}
 
 			case ENET_EVENT_TYPE_RECEIVE:
 			{
+				listener.packetsReceived.fetch_add(1, std::memory_order_relaxed);
 				handleClientMessage(event);
 
 				// Clean up packet
@@ -610,8 +785,29 @@ void GameServer::updateTaskFunc()
 	// Get current time
 	uint32_t currentTime = Utils::getCurrentTimeMs();
 
+	// Sample load before scheduling this tick's work
+	if (config.overloadControl)
+	{
+		const OverloadLevel previous = overload.getLevel();
+		if (overload.sample(worldStateLatencyMs.load(), threadManager.getQueuedTaskCount(), currentTime))
+		{
+			const std::string message = std::string("Service level ") + OverloadController::levelName(previous) + " -> " + OverloadController::levelName(overload.getLevel()) + " (load " + std::to_string(overload.getLoad()) + ")";
+			if (overload.getLevel() > previous)
+				logger.warning(message);
+			else
+				logger.info(message);
+		}
+	}
+
+	// Background work waits while the server is shedding load
+	const bool deferBackground = overload.atLeast(OverloadLevel::DeferBackground);
+	if (!deferBackground && saveDeferred.exchange(false))
+	{
+		saveTaskFunc();
+	}
+
 	// Check for plugin updates periodically
-	if (currentTime - lastPluginCheckTime > pluginCheckIntervalMs)
+	if (!deferBackground && currentTime - lastPluginCheckTime > pluginCheckIntervalMs)
 	{
 		threadManager.scheduleReadTask({ GameResources::PluginsId },
 		        [this]()
@@ -621,54 +817,22 @@ void GameServer::updateTaskFunc()
 		        });
 	}
 
-	// Synchronize player stats (needs access to Players and PeerStats)
-	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::PeerStatsId },
-	        [this]()
-	        {
-		        // For each player, copy stats from the lightweight objects
-		        for (auto& playerPair: players)
-		        {
-			        Player& player = playerPair.second;
-			        if (player.peer != nullptr)
-			        {
-				        uintptr_t peerKey = reinterpret_cast<uintptr_t>(player.peer);
-				        auto statsIt = peerStats.find(peerKey);
-				        if (statsIt != peerStats.end())
-				        {
-					        player.totalBytesSent = statsIt->second.totalBytesSent.load();
-					        player.totalBytesReceived = statsIt->second.totalBytesReceived.load();
-				        }
-			        }
-		        }
+	// Copy the per-connection traffic counters into the player records
+	syncPlayerStats();
 
-		        // Clean up stats for disconnected peers (optional)
-		        std::vector<uintptr_t> keysToRemove;
-		        for (auto& statsPair: peerStats)
-		        {
-			        bool found = false;
-			        for (auto& playerPair: players)
-			        {
-				        if (playerPair.second.peer != nullptr && reinterpret_cast<uintptr_t>(playerPair.second.peer) == statsPair.first)
-				        {
-					        found = true;
-					        break;
-				        }
-			        }
-			        if (!found)
-			        {
-				        keysToRemove.push_back(statsPair.first);
-			        }
-		        }
+	// Dispatch server tick to plugins
+	if (!deferBackground)
+	{
+		threadManager.scheduleReadTask({ GameResources::PluginsId }, [this]() { pluginManager->dispatchServerTick(); });
+	}
 
-		        for (uintptr_t key: keysToRemove)
-		        {
-			        peerStats.erase(key);
-		        }
+	// Drain bulk streams within their flow-control budget
+	threadManager.scheduleResourceTask({ GameResources::BulkStreamsId },
+	        [this]()
+	        {
+		        bulkStreamer.pump([this](ENetPeer* peer, const GameProtocol::BulkDataPacket& chunk) { sendPacket(peer, chunk, true, GameProtocol::Channel::Bulk); }, config.bulkBytesPerTick, config.bulkWindowBytes);
 	        });
 
-	// Dispatch server tick to plugins
-	threadManager.scheduleReadTask({ GameResources::PluginsId }, [this]() { pluginManager->dispatchServerTick(); });
-
 	// Broadcast world state (needs access to Players and SpatialGrid)
 	threadManager.scheduleReadTask({ GameResources::PlayersId, GameResources::SpatialGridId }, [this]() { broadcastWorldState(); });
 
@@ -679,6 +843,14 @@ void GameServer::updateTaskFunc()
 // Save thread function
 void GameServer::saveTaskFunc()
 {
+	// The update tick runs the save once the server has recovered
+	if (overload.atLeast(OverloadLevel::DeferBackground))
+	{
+		saveDeferred = true;
+		logger.debug("Auto-save deferred under load");
+		return;
+	}
+
 	// Save player data
 	saveAuthData();
 	logger.debug("Player data auto-saved");
@@ -715,12 +887,42 @@ void GameServer::scheduleRecurringTask(std::function<void()> task, uint32_t inte
 // Handle client connection
 void GameServer::handleClientConnect(const ENetEvent& event)
 {
+	// A reused peer slot must not inherit the previous connection's keys
+	packetManager.removeSecureChannel(event.peer);
+
+	// Counters are reset here, before any receive for this connection can add to them
+	uint32_t generation = 0;
+	if (ConnectionSlot* slot = slotFor(event.peer))
+	{
+		generation = ++slot->latestGeneration;
+		slot->traffic.totalBytesSent = 0;
+		slot->traffic.totalBytesReceived = 0;
+		slot->authenticated = false;
+		slot->preAuthWindowStart = Utils::getCurrentTimeMs();
+		slot->preAuthPackets = 0;
+	}
+
 	// Use resource task with write access to Players and the SpatialGrid
-	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::PeerDataId, GameResources::SpatialGridId },
-	        [this, event]()
+	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::ConnectionSlotsId, GameResources::SpatialGridId },
+	        [this, event, generation]()
 	        {
 		        stats.totalConnections++;
 
+		        ConnectionSlot* slot = slotFor(event.peer);
+		        if (slot == nullptr)
+		        {
+			        logger.error("Peer ID " + std::to_string(event.peer->incomingPeerID) + " is outside the connection slot table");
+			        enet_peer_disconnect(event.peer, 0);
+			        return;
+		        }
+
+		        // This connection already disconnected (and the peer may be serving the next one)
+		        if (slot->latestGeneration != generation)
+		        {
+			        logger.debug("Skipped setup for a connection that already ended on peer ID " + std::to_string(event.peer->incomingPeerID));
+			        return;
+		        }
+
 		        std::string ipAddress = Utils::peerAddressToString(event.peer->address);
 		        logger.info("New client connected from " + ipAddress);
 
@@ -741,15 +943,19 @@ void GameServer::handleClientConnect(const ENetEvent& event)
 		        newPlayer.totalBytesReceived = 0;
 		        newPlayer.totalBytesSent = 0;
 		        newPlayer.pingMs = 0;
+		        newPlayer.packetLossPercent = 0.0f;
 		        newPlayer.isAuthenticated = false;
 		        newPlayer.isAdmin = false;
 		        newPlayer.ipAddress = ipAddress;
 
-		        // Store player pointer in peer data
-		        event.peer->data = reinterpret_cast<void*>(new uint32_t(tempId));
-
-		        // Add to players map (using peer pointer as key for unauthenticated players)
-		        players[reinterpret_cast<uintptr_t>(event.peer)] = newPlayer;
+		        // Guests live in their connection slot until they authenticate
+		        slot->generation = generation;
+		        slot->peer = event.peer;
+		        slot->playerId = tempId;
+		        slot->guest = newPlayer;
+		        slot->player = &slot->guest;
+		        slot->sendState = PeerSendState{};
+		        activeConnections++;
 
 		        // Send plugin event
 		        pluginManager->dispatchPlayerConnect(newPlayer);
@@ -757,9 +963,9 @@ void GameServer::handleClientConnect(const ENetEvent& event)
 		        logger.info("Temporary player created: " + defaultName);
 
 		        // Update concurrent player count
-		        if (players.size() > stats.maxConcurrentPlayers)
+		        if (activeConnections > stats.maxConcurrentPlayers)
 		        {
-			        stats.maxConcurrentPlayers = players.size();
+			        stats.maxConcurrentPlayers = activeConnections;
 		        }
 	        });
 }
@@ -767,12 +973,40 @@ void GameServer::handleClientConnect(const ENetEvent& event)
 // Handle client message
 void GameServer::handleClientMessage(const ENetEvent& event)
 {
+	// Stamp arrival before any parsing so Pong timestamps stay tight
+	const uint64_t receiveTime = GameProtocol::getMonotonicTimeUs();
+
 	// First, update stats and get the basic information that doesn't require locking
 	stats.totalPacketsReceived++;
 	stats.totalBytesReceived += event.packet->dataLength;
+	ConnectionSlot* slot = slotFor(event.peer);
+	uint32_t generation = 0;
+	if (slot != nullptr)
+	{
+		slot->traffic.totalBytesReceived += static_cast<uint32_t>(event.packet->dataLength);
+		generation = slot->latestGeneration.load();
+	}
+
+	// Before login, judge the packet by its raw header so floods are dropped before any parsing or task
+	const bool preAuth = slot != nullptr && !slot->authenticated.load(std::memory_order_acquire);
+	if (preAuth)
+	{
+		GameProtocol::PacketHeader header;
+		if (event.packet->dataLength < sizeof(header))
+		{
+			stats.preAuthDrops++;
+			return;
+		}
+		std::memcpy(&header, event.packet->data, sizeof(header));
+		if (!header.isValid() || !admitPreAuthPacket(*slot, event.peer, header.type))
+		{
+			stats.preAuthDrops++;
+			return;
+		}
+	}
 
 	// Parse the packet using our new packet system
-	auto packet = packetManager.receivePacket(event.packet);
+	auto packet = packetManager.receivePacket(event.packet, event.peer);
 	if (!packet)
 	{
 		// Invalid packet, log with more details for debugging
@@ -787,56 +1021,66 @@ void GameServer::handleClientMessage(const ENetEvent& event)
 		return;
 	}
 
+	// Key exchange is answered straight from the network thread so the channel exists before the next packet
+	if (packet->getType() == GameProtocol::PacketType::KeyExchange)
+	{
+		handleKeyExchange(event.peer, static_cast<const GameProtocol::KeyExchangePacket&>(*packet));
+		return;
+	}
+
+	// Only handshake and keepalive traffic may arrive in plaintext when encryption is required
+	if (config.requireEncryption && !packetManager.getSecureChannel(event.peer))
+	{
+		const auto type = packet->getType();
+		if (type != GameProtocol::PacketType::Ping && type != GameProtocol::PacketType::Heartbeat && type != GameProtocol::PacketType::Disconnect)
+		{
+			logger.warning("Disconnecting " + Utils::peerAddressToString(event.peer->address) + ": unencrypted " + GameProtocol::getPacketTypeName(type) + " packet");
+			enet_peer_disconnect(event.peer, 0);
+			return;
+		}
+	}
+
+	// An encrypted packet only reveals its type once opened
+	if (preAuth && !isPreAuthPacketType(packet->getType()))
+	{
+		stats.preAuthDrops++;
+		return;
+	}
+
+	// Answer time sync pings straight from the network thread, they need no player state
+	if (packet->getType() == GameProtocol::PacketType::Ping)
+	{
+		handlePing(event.peer, static_cast<const GameProtocol::PingPacket&>(*packet), receiveTime);
+		return;
+	}
+
 	// Now handle the message with the appropriate resource access
 	threadManager.scheduleResourceTask(
 	        {
-	                GameResources::PlayersId,   // Need access to players map
-	                GameResources::PeerDataId,  // Need access to peer->data
-	                GameResources::PeerStatsId, // For updating statistics
-	                GameResources::PluginsId    // For plugin event dispatch
+	                GameResources::PlayersId,         // Need access to players map
+	                GameResources::ConnectionSlotsId, // Connection slot of the sender
+	                GameResources::PluginsId          // For plugin event dispatch
 	        },
-	        [this, event, packetPtr = std::move(packet)]() mutable
+	        [this, event, generation, packetPtr = std::move(packet)]() mutable
 	        {
-		        // Get player ID from peer data
-		        uint32_t* ptrPlayerId = reinterpret_cast<uint32_t*>(event.peer->data);
-		        if (ptrPlayerId == nullptr)
+		        // The slot points at the guest record or the players map entry, no lookup needed
+		        ConnectionSlot* slot = slotFor(event.peer);
+		        Player* player = slot != nullptr ? slot->player : nullptr;
+		        if (player == nullptr)
 		        {
-			        logger.error("Received message from peer with no ID data");
+			        logger.error("Received message from peer without a player. Peer ID: " + std::to_string(event.peer->incomingPeerID));
 			        return;
 		        }
 
-		        uint32_t playerId = *ptrPlayerId;
-
-		        // Find player
-		        Player* player = nullptr;
-
-		        if (playerId == 0)
-		        {
-			        // Unauthenticated player, use peer pointer as key
-			        auto it = players.find(reinterpret_cast<uintptr_t>(event.peer));
-			        if (it != players.end())
-			        {
-				        player = &it->second;
-			        }
-		        }
-		        else
-		        {
-			        auto it = players.find(playerId);
-			        if (it != players.end())
-			        {
-				        player = &it->second;
-			        }
-		        }
-
-		        if (player == nullptr)
+		        // Sent by a connection that has since ended; the slot may already serve the next one
+		        if (slot->generation != generation)
 		        {
-			        logger.error("Received message from unknown player. ID: " + std::to_string(playerId));
+			        logger.debug("Dropped a message from an ended connection on peer ID " + std::to_string(event.peer->incomingPeerID));
 			        return;
 		        }
 
 		        // Update player's last activity time
 		        player->lastUpdateTime = Utils::getCurrentTimeMs();
-		        player->totalBytesReceived += event.packet->dataLength;
 
 		        // Log the message type
 		        logger.logNetworkEvent("Message from " + player->name + ": Packet Type " + GameProtocol::getPacketTypeName(packetPtr->getType()));
@@ -845,11 +1089,11 @@ void GameServer::handleClientMessage(const ENetEvent& event)
 		        // For now, we'll skip this or implement a string-based representation
 
 		        // Handle the packet based on its type
-		        handlePacket(*player, std::move(packetPtr));
+		        handlePacket(*player, generation, std::move(packetPtr));
 	        });
 }
 
-void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol::Packet> packetPtr)
+void GameServer::handlePacket(const Player& player, uint32_t generation, std::unique_ptr<GameProtocol::Packet> packetPtr)
 {
 	auto& packet = *packetPtr;
 
@@ -862,7 +1106,7 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 			auto& authPacket = static_cast<GameProtocol::AuthRequestPacket&>(packet);
 
 			// Schedule a new task for auth handling
-			threadManager.scheduleTask([this, username = authPacket.username, password = authPacket.password, playerPeer = player.peer]() { handleAuthMessage(username + "," + password, playerPeer); });
+			threadManager.scheduleTask([this, username = authPacket.username, password = authPacket.password, playerPeer = player.peer, generation]() { handleAuthMessage(username + "," + password, playerPeer, generation); });
 			break;
 		}
 
@@ -872,7 +1116,7 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 			auto& regPacket = static_cast<GameProtocol::RegistrationPacket&>(packet);
 
 			// Schedule registration handling
-			threadManager.scheduleTask([this, playerCopy = player, username = regPacket.username, password = regPacket.password]() { handleRegistration(playerCopy, username, password); });
+			threadManager.scheduleTask([this, playerCopy = player, username = regPacket.username, password = regPacket.password, generation]() { handleRegistration(playerCopy, username, password, generation); });
 			break;
 		}
 
@@ -912,8 +1156,8 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 
 			auto& chatPacket = static_cast<GameProtocol::ChatMessagePacket&>(packet);
 
-			// Schedule chat handling with the right resources
-			threadManager.scheduleResourceTask({ GameResources::ChatId, GameResources::PlayersId }, [this, playerCopy = player, message = chatPacket.message]() { handleChatMessage(playerCopy, message); });
+			// Chat handling takes the resources it needs as it goes
+			threadManager.spawn(handleChatMessage(player, chatPacket.message));
 			break;
 		}
 
@@ -939,7 +1183,7 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 						std::string password = cmdPacket.arguments[1];
 
 						// Schedule auth handling
-						threadManager.scheduleTask([this, username, password, playerPeer = player.peer]() { handleAuthMessage(username + "," + password, playerPeer); });
+						threadManager.scheduleTask([this, username, password, playerPeer = player.peer, generation]() { handleAuthMessage(username + "," + password, playerPeer, generation); });
 					}
 					else
 					{
@@ -954,7 +1198,7 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 						std::string password = cmdPacket.arguments[1];
 
 						// Schedule registration handling
-						threadManager.scheduleTask([this, playerCopy = player, username, password]() { handleRegistration(playerCopy, username, password); });
+						threadManager.scheduleTask([this, playerCopy = player, username, password, generation]() { handleRegistration(playerCopy, username, password, generation); });
 					}
 					else
 					{
@@ -989,6 +1233,12 @@ void GameServer::handlePacket(const Player& player, std::unique_ptr<GameProtocol
 		}
 		
 
+		case GameProtocol::PacketType::Heartbeat:
+		{
+			// Keepalive only, activity time was already updated
+			break;
+		}
+
 		default:
 			logger.error("Received unknown packet type: " + GameProtocol::getPacketTypeName(packet.getType()));
 			break;
@@ -1015,67 +1265,69 @@ void GameServer::handlePositionUpdate(uint32_t playerId, const Position& newPos)
 // Handle client disconnect
 void GameServer::handleClientDisconnect(const ENetEvent& event)
 {
+	packetManager.removeSecureChannel(event.peer);
+
+	// The connection ending is the one stamped at its connect; moving on invalidates its pending connect task
+	uint32_t generation = 0;
+	if (ConnectionSlot* slot = slotFor(event.peer))
+	{
+		generation = slot->latestGeneration++;
+	}
+
 	// Use a resource task that needs access to all relevant resources
 	threadManager.scheduleResourceTask(
 	        {
-	                GameResources::PeerDataId,    // For peer->data access
-	                GameResources::PeerStatsId,   // For peerStats map
-	                GameResources::PlayersId,     // For players map
-	                GameResources::SpatialGridId, // For spatial grid updates
-	                GameResources::PluginsId      // For plugin dispatch
+	                GameResources::ConnectionSlotsId, // Connection slot being released
+	                GameResources::PlayersId,         // For players map
+	                GameResources::SpatialGridId,     // For spatial grid updates
+	                GameResources::PluginsId          // For plugin dispatch
 	        },
-	        [this, event]()
+	        [this, event, generation]()
 	        {
-		        // Get player ID from peer data
-		        uint32_t playerId = 0;
-		        uint32_t* ptrPlayerId = reinterpret_cast<uint32_t*>(event.peer->data);
-		        if (ptrPlayerId != nullptr)
+		        ConnectionSlot* slot = slotFor(event.peer);
+		        if (slot == nullptr || slot->peer != event.peer || slot->generation != generation)
 		        {
-			        playerId = *ptrPlayerId;
+			        // Either the connection never got its slot, or the slot already belongs to the next one
+			        logger.debug("Disconnect for a connection without a live slot: " + Utils::peerAddressToString(event.peer->address));
+			        return;
 		        }
 
-		        // Clean up stats
-		        peerStats.erase(reinterpret_cast<uintptr_t>(event.peer));
+		        // Drop any pending bulk transfers
+		        threadManager.scheduleResourceTask({ GameResources::BulkStreamsId }, [this, peer = event.peer]() { bulkStreamer.removePeer(peer); });
 
-		        // Handle cleanup based on authentication status
+		        uint32_t playerId = slot->playerId;
 		        std::string playerName;
 
-		        if (playerId == 0)
-		        {
-			        // Unauthenticated player, use peer pointer as key
-			        auto it = players.find(reinterpret_cast<uintptr_t>(event.peer));
-			        if (it != players.end())
-			        {
-				        pluginManager->dispatchPlayerDisconnect(it->second);
-				        playerName = it->second.name;
-				        players.erase(it);
-			        }
-		        }
-		        else
+		        // A timed out player has already been removed and its slot cleared
+		        if (slot->player != nullptr)
 		        {
-			        // Authenticated player
-			        auto it = players.find(playerId);
-			        if (it != players.end())
+			        Player& player = *slot->player;
+			        pluginManager->dispatchPlayerDisconnect(player);
+			        playerName = player.name;
+
+			        if (playerId != 0)
 			        {
-				        pluginManager->dispatchPlayerDisconnect(it->second);
-				        playerName = it->second.name;
-				        Position lastPos = it->second.position;
+				        Position lastPos = player.position;
 
 				        // Since savePlayerData accesses Auth resource, schedule it separately
 				        // to avoid resource deadlocks
 				        threadManager.scheduleResourceTask({ GameResources::AuthId, GameResources::DatabaseId }, [this, playerName, lastPos]() { savePlayerData(playerName, lastPos); });
 
 				        // Remove from spatial grid
-				        spatialGrid.removeEntity(playerId, it->second.position);
+				        spatialGrid.removeEntity(playerId, lastPos);
 
 				        // Remove from players map
-				        players.erase(it);
+				        players.erase(playerId);
 			        }
 		        }
 
-		        // Clean up peer data
-		        delete ptrPlayerId;
-		        event.peer->data = nullptr;
+		        // Free the slot for the next connection on this peer
+		        slot->authenticated = false;
+		        slot->peer = nullptr;
+		        slot->playerId = 0;
+		        slot->player = nullptr;
+		        slot->guest = Player{};
+		        activeConnections--;
 
 		        logger.info("Player disconnected: " + playerName + " (ID: " + std::to_string(playerId) + ")");
 
@@ -1089,7 +1341,7 @@ void GameServer::handleClientDisconnect(const ENetEvent& event)
 }
 
 // Handle authentication message
-void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* peer)
+void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* peer, uint32_t generation)
 {
 	// We accept a peer pointer instead of a player reference
 	if (peer == nullptr)
@@ -1098,30 +1350,34 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 		return;
 	}
 
+	// Last overload step: players already in keep playing, nobody new gets in
+	if (overload.atLeast(OverloadLevel::RefuseLogins))
+	{
+		sendAuthResponse(peer, false, "Server is busy, please try again shortly");
+		return;
+	}
+
 	// Find player and authenticate - needs access to Players and Auth resources
 	threadManager.scheduleResourceTask(
 	        {
 	                GameResources::PlayersId,    // For accessing players map
 	                GameResources::AuthId,       // For accessing authentication data
-	                GameResources::PeerDataId,   // For peer->data access
-	                GameResources::SpatialGridId // For spatial grid updates
+	                GameResources::ConnectionSlotsId, // Guest record of the peer
+	                GameResources::SpatialGridId      // For spatial grid updates
 	        },
-	        [this, authDataStr, peer]()
+	        [this, authDataStr, peer, generation]()
 	        {
-		        // Find player by peer pointer
+		        // Only a guest still holding the connection slot it sent the request on can log in
 		        uint32_t playerId = 0;
-		        Player* playerPtr = nullptr;
-		        uintptr_t peerKey = reinterpret_cast<uintptr_t>(peer);
-
-		        auto it = players.find(peerKey);
-		        if (it == players.end())
+		        ConnectionSlot* slot = slotFor(peer);
+		        if (slot == nullptr || slot->peer != peer || slot->generation != generation || slot->player != &slot->guest)
 		        {
 			        logger.error("Auth attempt from unknown peer");
 			        return;
 		        }
 
 		        // Use a local copy of the player
-		        Player player = it->second;
+		        Player player = slot->guest;
 
 		        auto parts = Utils::splitString(authDataStr, ',');
 		        if (parts.size() < 2)
@@ -1184,11 +1440,7 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 				        response = "Invalid password";
 
 				        // Update the failed attempts in the stored player
-				        auto playerIt = players.find(peerKey);
-				        if (playerIt != players.end())
-				        {
-					        playerIt->second.failedAuthAttempts++;
-				        }
+				        slot->guest.failedAuthAttempts++;
 
 				        stats.authFailures++;
 				        logger.error("Authentication failed for " + username + ": Invalid password");
@@ -1201,11 +1453,7 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 			        response = "User not found. Use /register to create an account.";
 
 			        // Update the failed attempts in the stored player
-			        auto playerIt = players.find(peerKey);
-			        if (playerIt != players.end())
-			        {
-				        playerIt->second.failedAuthAttempts++;
-			        }
+			        slot->guest.failedAuthAttempts++;
 
 			        logger.error("Authentication failed: User not found: " + username);
 		        }
@@ -1240,26 +1488,16 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 		        authenticatedPlayer.totalBytesReceived = player.totalBytesReceived;
 		        authenticatedPlayer.totalBytesSent = player.totalBytesSent;
 		        authenticatedPlayer.pingMs = player.pingMs;
+		        authenticatedPlayer.packetLossPercent = player.packetLossPercent;
 		        authenticatedPlayer.isAuthenticated = true;
 		        authenticatedPlayer.isAdmin = authData.isAdmin;
 		        authenticatedPlayer.ipAddress = player.ipAddress;
 
-		        // Add new player entry before removing old one
-		        players[playerId] = authenticatedPlayer;
-
-		        // Now it's safe to remove the old player entry
-		        players.erase(peerKey);
-
-		        // Update peer data
-		        uint32_t* ptrPlayerId = reinterpret_cast<uint32_t*>(peer->data);
-		        if (ptrPlayerId != nullptr)
-		        {
-			        *ptrPlayerId = playerId;
-		        }
-		        else
-		        {
-			        peer->data = reinterpret_cast<void*>(new uint32_t(playerId));
-		        }
+		        // Move the connection from its guest record to the players map; map nodes never move, so the slot can point at it
+		        slot->player = &players.emplace(playerId, authenticatedPlayer).first->second;
+		        slot->playerId = playerId;
+		        slot->guest = Player{};
+		        slot->authenticated = true;
 
 		        // Add to spatial grid
 		        spatialGrid.addEntity(playerId, authenticatedPlayer.position);
@@ -1276,6 +1514,9 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 		        // Send authentication response
 		        sendAuthResponse(peer, true, std::to_string(finalPlayerId));
 
+		        // Stream world sync and chat backfill on the bulk channel
+		        queueJoinStreams(peer, authenticatedPlayer);
+
 		        // Broadcast join message - scheduling as a separate task
 		        threadManager.scheduleTask([this, finalUsername]() { broadcastSystemMessage(finalUsername + " has joined the game"); });
 
@@ -1294,8 +1535,15 @@ void GameServer::handleAuthMessage(const std::string& authDataStr, ENetPeer* pee
 }
 
 // Handle player registration
-void GameServer::handleRegistration(const Player& player, const std::string& username, const std::string& password)
+void GameServer::handleRegistration(const Player& player, const std::string& username, const std::string& password, uint32_t generation)
 {
+	if (overload.atLeast(OverloadLevel::RefuseLogins))
+	{
+		auto packet = PacketManager::createSystemMessage("Server is busy, please try again shortly");
+		sendPacket(player.peer, *packet, true);
+		return;
+	}
+
 	// Validate credentials outside resource locks
 	if (username.length() < 3 || username.length() > 20)
 	{
@@ -1324,11 +1572,19 @@ void GameServer::handleRegistration(const Player& player, const std::string& use
 	        {
 	                GameResources::AuthId,       // Need access to authenticated players map
 	                GameResources::PlayersId,    // Need access to players map
-	                GameResources::PeerDataId,   // Need access to peer->data
-	                GameResources::SpatialGridId // Need access to spatial grid
+	                GameResources::ConnectionSlotsId, // Connection slot of the registering peer
+	                GameResources::SpatialGridId      // Need access to spatial grid
 	        },
-	        [this, player, username, password]()
+	        [this, player, username, password, generation]()
 	        {
+		        // The connection may have closed (and the peer been reused) while the request was queued
+		        ConnectionSlot* slot = slotFor(player.peer);
+		        if (slot == nullptr || slot->peer != player.peer || slot->generation != generation || slot->player == nullptr)
+		        {
+			        logger.error("Registration from disconnected peer: " + username);
+			        return;
+		        }
+
 		        bool success = false;
 		        std::string response;
 		        uint32_t newPlayerId = 0;
@@ -1365,7 +1621,7 @@ void GameServer::handleRegistration(const Player& player, const std::string& use
 
 		        if (success)
 		        {
-			        uint32_t oldKey = player.id == 0 ? reinterpret_cast<uintptr_t>(player.peer) : player.id;
+			        uint32_t previousId = slot->playerId;
 
 			        // Save auth data immediately - schedule separately to avoid deadlocks
 			        threadManager.scheduleResourceTask({ GameResources::AuthId, GameResources::DatabaseId }, [this]() { saveAuthData(); });
@@ -1383,23 +1639,15 @@ void GameServer::handleRegistration(const Player& player, const std::string& use
 			        registeredPlayer.totalBytesReceived = player.totalBytesReceived;
 			        registeredPlayer.totalBytesSent = player.totalBytesSent;
 			        registeredPlayer.pingMs = player.pingMs;
+			        registeredPlayer.packetLossPercent = player.packetLossPercent;
 			        registeredPlayer.isAuthenticated = true;
 			        registeredPlayer.isAdmin = false;
 			        registeredPlayer.ipAddress = player.ipAddress;
 
-			        // Add new player entry
-			        players[newPlayerId] = registeredPlayer;
-
-			        // Update peer data
-			        uint32_t* ptrPlayerId = reinterpret_cast<uint32_t*>(player.peer->data);
-			        if (ptrPlayerId != nullptr)
-			        {
-				        *ptrPlayerId = newPlayerId;
-			        }
-			        else
-			        {
-				        player.peer->data = reinterpret_cast<void*>(new uint32_t(newPlayerId));
-			        }
+			        // Add new player entry and point the connection slot at it
+			        slot->player = &players.emplace(newPlayerId, registeredPlayer).first->second;
+			        slot->playerId = newPlayerId;
+			        slot->authenticated = true;
 
 			        // Add to spatial grid
 			        spatialGrid.addEntity(newPlayerId, registeredPlayer.position);
@@ -1463,7 +1711,14 @@ void GameServer::handleRegistration(const Player& player, const std::string& use
 			                });
 
 			        // Remove old player entry
-			        players.erase(oldKey);
+			        if (previousId != 0)
+			        {
+				        players.erase(previousId);
+			        }
+			        else
+			        {
+				        slot->guest = Player{};
+			        }
 		        }
 		        else
 		        {
@@ -1476,50 +1731,44 @@ void GameServer::handleRegistration(const Player& player, const std::string& use
 
 void GameServer::syncPlayerStats()
 {
-	// Use a resource task that requires access to both the players map and peer stats
-	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::PeerStatsId },
+	// One pass over the slot table; freed slots have no player and are skipped
+	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::ConnectionSlotsId },
 	        [this]()
 	        {
-		        // For each player, copy stats from the lightweight objects
-		        for (auto& playerPair: players)
-		        {
-			        Player& player = playerPair.second;
-			        if (player.peer != nullptr)
-			        {
-				        uintptr_t peerKey = reinterpret_cast<uintptr_t>(player.peer);
-				        auto statsIt = peerStats.find(peerKey);
-				        if (statsIt != peerStats.end())
-				        {
-					        player.totalBytesSent = statsIt->second.totalBytesSent.load();
-					        player.totalBytesReceived = statsIt->second.totalBytesReceived.load();
-				        }
-			        }
-		        }
+		        // Slots never share a player, so ranges of them can be copied on separate threads
+		        threadManager.parallelFor(0, connectionSlotCount, 1024,
+		                [this](size_t first, size_t last)
+		                {
+			                for (size_t i = first; i < last; i++)
+			                {
+				                ConnectionSlot& slot = connectionSlots[i];
+				                if (slot.player != nullptr)
+				                {
+					                slot.player->totalBytesSent = slot.traffic.totalBytesSent.load();
+					                slot.player->totalBytesReceived = slot.traffic.totalBytesReceived.load();
+				                }
+			                }
+		                });
+	        });
+}
 
-		        // Clean up stats for disconnected peers (optional)
-		        std::vector<uintptr_t> keysToRemove;
-		        for (auto& statsPair: peerStats)
-		        {
-			        bool found = false;
-			        for (auto& playerPair: players)
-			        {
-				        if (playerPair.second.peer != nullptr && reinterpret_cast<uintptr_t>(playerPair.second.peer) == statsPair.first)
-				        {
-					        found = true;
-					        break;
-				        }
-			        }
-			        if (!found)
-			        {
-				        keysToRemove.push_back(statsPair.first);
-			        }
-		        }
+ConnectionSlot* GameServer::slotFor(ENetPeer* peer)
+{
+	if (peer == nullptr)
+	{
+		return nullptr;
+	}
 
-		        for (uintptr_t key: keysToRemove)
-		        {
-			        peerStats.erase(key);
-		        }
-	        });
+	// A handful of listeners at most, so a scan beats any lookup structure
+	for (uint32_t i = 0; i < listenerCount; i++)
+	{
+		if (listeners[i].host == peer->host)
+		{
+			const uint32_t index = listeners[i].slotBase + peer->incomingPeerID;
+			return index < connectionSlotCount ? &connectionSlots[index] : nullptr;
+		}
+	}
+	return nullptr;
 }
 
 void GameServer::handleDeltaPositionUpdate(uint32_t playerId, const std::string& deltaData)
@@ -1699,102 +1948,142 @@ void GameServer::handleSendPosition(uint32_t playerId)
 }
 
 // Handle chat message
-void GameServer::handleChatMessage(const Player& player, const std::string& message)
+Task<> GameServer::handleChatMessage(Player player, std::string message)
 {
 	// Ignore empty messages
 	if (message.empty())
-		return;
+		co_return;
 
-	// Check if it's a command
+	// Check if it's a command; command handlers run with Chat and Players held
 	if (message[0] == '/')
 	{
+		co_await threadManager.acquire(GameResources::ChatId, GameResources::PlayersId);
 		handleCommandMessage(player, message.substr(1));
-		return;
+		co_return;
 	}
 
 	logger.debug("Chat from " + player.name + ": " + message);
 
-	// Use resource tasks for chat history and broadcasting
-	threadManager.scheduleResourceTask({ GameResources::ChatId },
-	        [this, playerName = player.name, message]()
-	        {
-		        // Store in chat history
-		        ChatMessage chatMsg;
-		        chatMsg.sender = playerName;
-		        chatMsg.content = message;
-		        chatMsg.timestamp = Utils::getCurrentTimeMs();
-		        chatMsg.isGlobal = true;
-		        chatMsg.isSystem = false;
-		        chatMsg.range = 0;
-
-		        chatHistory.push_back(chatMsg);
-
-		        // Limit chat history size
-		        while (chatHistory.size() > MAX_CHAT_HISTORY)
-		        {
-			        chatHistory.pop_front();
-		        }
+	// Store in chat history
+	co_await threadManager.acquire(GameResources::ChatId);
 
-		        // Update stats - atomic operation, no resource needed
-		        stats.chatMessagesSent++;
-	        });
+	ChatMessage chatMsg;
+	chatMsg.sender = player.name;
+	chatMsg.content = message;
+	chatMsg.timestamp = Utils::getCurrentTimeMs();
+	chatMsg.isGlobal = true;
+	chatMsg.isSystem = false;
+	chatMsg.range = 0;
 
-	// Broadcast to all players - schedule separately to avoid holding Chat resource
-	threadManager.scheduleTask(
-	        [this, playerName = player.name, message]()
-	        {
-		        // Create a properly structured chat message packet
-		        auto chatPacket = PacketManager::createChatMessage(playerName, message, true); // true = global message
+	chatHistory.push_back(chatMsg);
 
-		        // Schedule a resource task to get all players
-		        threadManager.scheduleResourceTask({ GameResources::PlayersId },
-		                [this, packet = std::move(chatPacket)]()
-		                {
-			                // Collect all authenticated players' peers
-			                std::vector<ENetPeer*> authenticatedPeers;
+	// Limit chat history size
+	while (chatHistory.size() > MAX_CHAT_HISTORY)
+	{
+		chatHistory.pop_front();
+	}
 
-			                for (auto& pair: players)
-			                {
-				                if (pair.second.isAuthenticated && pair.second.peer != nullptr)
-				                {
-					                authenticatedPeers.push_back(pair.second.peer);
-				                }
-			                }
+	// Update stats - atomic operation, no resource needed
+	stats.chatMessagesSent++;
 
-			                // Release resources before sending packets
-			                threadManager.scheduleTask(
-			                        [this, authenticatedPeers, packet = std::move(packet)]()
-			                        {
-				                        for (ENetPeer* peer: authenticatedPeers)
-				                        {
-					                        sendPacket(peer, *packet, true); // Use reliable transmission for chat
-				                        }
-			                        });
-		                });
-	        });
+	// Collect all authenticated players' peers (this also lets go of Chat)
+	co_await threadManager.acquireRead(GameResources::PlayersId);
+
+	std::vector<ENetPeer*> authenticatedPeers;
+	for (auto& pair: players)
+	{
+		if (pair.second.isAuthenticated && pair.second.peer != nullptr)
+		{
+			authenticatedPeers.push_back(pair.second.peer);
+		}
+	}
+
+	// Release resources before sending packets
+	co_await threadManager.schedule();
+
+	auto chatPacket = PacketManager::createChatMessage(player.name, message, true); // true = global message
+	for (ENetPeer* peer: authenticatedPeers)
+	{
+		sendPacket(peer, *chatPacket, true); // Use reliable transmission for chat
+	}
 }
 
-// Handle ping message
-void GameServer::handlePingMessage(const Player& player, const std::string& pingData)
+// Handshake, keepalive and login traffic; /login and /register arrive as commands
+bool GameServer::isPreAuthPacketType(GameProtocol::PacketType type)
 {
-	try
+	switch (type)
 	{
-		uint32_t clientTime = std::stoul(pingData);
+		case GameProtocol::PacketType::Heartbeat:
+		case GameProtocol::PacketType::Disconnect:
+		case GameProtocol::PacketType::Ping:
+		case GameProtocol::PacketType::KeyExchange:
+		case GameProtocol::PacketType::Encrypted:
+		case GameProtocol::PacketType::AuthRequest:
+		case GameProtocol::PacketType::Registration:
+		case GameProtocol::PacketType::Command:
+			return true;
+		default:
+			return false;
+	}
+}
 
-		// Create and send a Heartbeat packet with the clientTime
-		// TODO: we should have a dedicated PingResponse/Pong packet
-		// For now, we'll use a Heartbeat packet which should be defined in your PacketTypes.h
+// Rate-limit a connection that has not logged in yet; runs on the network thread for every packet it sends
+bool GameServer::admitPreAuthPacket(ConnectionSlot& slot, ENetPeer* peer, GameProtocol::PacketType type)
+{
+	if (!isPreAuthPacketType(type))
+	{
+		return false;
+	}
 
-		// Create a heartbeat packet (using the existing packet type)
-		auto heartbeatPacket = std::make_unique<GameProtocol::HeartbeatPacket>(clientTime);
+	const uint32_t now = Utils::getCurrentTimeMs();
+	if (now - slot.preAuthWindowStart >= 1000)
+	{
+		slot.preAuthWindowStart = now;
+		slot.preAuthPackets = 0;
+	}
 
-		// Send the response
-		sendPacket(player.peer, *heartbeatPacket, false); // Unreliable is fine for pings
+	if (++slot.preAuthPackets <= config.preAuthPacketsPerSecond)
+	{
+		return true;
 	}
-	catch (const std::exception& e)
+
+	// Log and disconnect once per window, everything after that is just counted
+	if (slot.preAuthPackets == config.preAuthPacketsPerSecond + 1)
 	{
-		logger.error("Error parsing ping from " + player.name + ": " + e.what());
+		logger.warning("Disconnecting " + Utils::peerAddressToString(peer->address) + ": over the pre-auth packet budget");
+		enet_peer_disconnect(peer, 0);
 	}
+	return false;
+}
+
+// Reply to a time sync ping with our receive and send timestamps
+void GameServer::handlePing(ENetPeer* peer, const GameProtocol::PingPacket& ping, uint64_t receiveTime)
+{
+	auto pongPacket = packetManager.createPong(ping, receiveTime, GameProtocol::getMonotonicTimeUs());
+	sendPacket(peer, *pongPacket, false); // Unreliable, a retransmitted pong would skew the RTT
+}
+
+// Accept or decline a client's key exchange; the reply goes out in plaintext before the channel is registered
+void GameServer::handleKeyExchange(ENetPeer* peer, const GameProtocol::KeyExchangePacket& request)
+{
+	if (!config.encryptionEnabled || !request.accepted)
+	{
+		sendPacket(peer, *packetManager.createKeyExchange(false), true);
+		return;
+	}
+
+	auto channel = std::make_shared<GameProtocol::SecureChannel>(GameProtocol::SecureChannel::Role::Server);
+	if (!channel->generateKeyPair() || !channel->establish(request.publicKey))
+	{
+		logger.warning("Key exchange failed for " + Utils::peerAddressToString(peer->address) + ", continuing unencrypted");
+		sendPacket(peer, *packetManager.createKeyExchange(false), true);
+		return;
+	}
+
+	sendPacket(peer, *packetManager.createKeyExchange(true, channel->getPublicKey()), true);
+	packetManager.setSecureChannel(peer, std::move(channel));
+
+	logger.debug("Secure channel established with " + Utils::peerAddressToString(peer->address));
 }
 
 // Handle command message
@@ -1832,24 +2121,38 @@ void GameServer::handleCommandMessage(const Player& player, const std::string& c
 }
 
 // Send packet to player
-void GameServer::sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable)
+void GameServer::sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable, GameProtocol::Channel channel)
 {
 	if (!peer)
 		return;
 
 	// Use the packet manager to send the packet
-	packetManager.sendPacket(peer,
-	        packet,
-	        reliable,
-	        [this, peer](size_t dataSize)
-	        {
-		        // Update global stats - atomic operation
-		        stats.totalPacketsSent++;
-		        stats.totalBytesSent += dataSize;
+	packetManager.sendPacket(peer, packet, reliable, makeSentStatsCallback(peer), channel);
+}
+
+// Send bytes that were already encoded, e.g. world state chunks built during the tick
+void GameServer::sendSerialized(ENetPeer* peer, std::vector<uint8_t> data, GameProtocol::PacketType type, bool reliable, GameProtocol::Channel channel)
+{
+	if (!peer)
+		return;
+
+	packetManager.sendSerialized(peer, std::move(data), type, reliable, makeSentStatsCallback(peer), channel);
+}
 
-		        // Update per-peer stats - needs resource access
-		        threadManager.scheduleResourceTask({ GameResources::PeerStatsId }, [this, peer, dataSize]() { peerStats[reinterpret_cast<uintptr_t>(peer)].totalBytesSent += dataSize; });
-	        });
+std::function<void(size_t)> GameServer::makeSentStatsCallback(ENetPeer* peer)
+{
+	return [this, peer](size_t dataSize)
+	{
+		// Update global stats - atomic operation
+		stats.totalPacketsSent++;
+		stats.totalBytesSent += dataSize;
+
+		// Update per-connection stats in place
+		if (ConnectionSlot* slot = slotFor(peer))
+		{
+			slot->traffic.totalBytesSent += static_cast<uint32_t>(dataSize);
+		}
+	};
 }
 
 // Updated system message method
@@ -1915,94 +2218,263 @@ void GameServer::broadcastChatMessage(const std::string& sender, const std::stri
 // Broadcast world state to all players
 void GameServer::broadcastWorldState()
 {
+	// One snapshot id per broadcast so clients can tell when they have every chunk
+	const uint32_t snapshotId = ++worldSnapshotId;
+	const uint32_t scheduledAt = Utils::getCurrentTimeMs();
+
 	// Use resource task that requires Players and SpatialGrid
-	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::SpatialGridId },
-	        [this]()
+	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::SpatialGridId, GameResources::ConnectionSlotsId },
+	        [this, snapshotId, scheduledAt]()
 	        {
+		        // Recipients are split over the pool; every thread builds its players' packets in its own arena
+		        FrameArena& tickArena = FrameArena::forThisThread();
+
+		        // Only the nearest players are sent while the server sheds load
+		        const bool nearestOnly = overload.atLeast(OverloadLevel::ReduceFarUpdates);
+		        const float radius = currentInterestRadius();
+
+		        std::pmr::vector<Player*> recipients(&tickArena);
+		        recipients.reserve(players.size());
 		        for (auto& pair: players)
 		        {
-			        Player& player = pair.second;
-
 			        // Skip unauthenticated players
-			        if (!player.isAuthenticated)
-				        continue;
+			        if (pair.second.isAuthenticated)
+				        recipients.push_back(&pair.second);
+		        }
 
-			        // Create world state packet for this player
-			        auto worldStatePacket = PacketManager::createWorldState();
+		        // Each recipient only writes its own player and slot; everyone else is only read
+		        struct TickMemory
+		        {
+			        uint64_t arenaBlocks = 0;
+			        size_t arenaBytes = 0;
+		        };
 
-			        // Get nearby entities
-			        std::set<uint32_t> visibleEntities;
-			        if (config.interestRadius > 0)
-			        {
-				        visibleEntities = spatialGrid.getNearbyEntities(player.position, config.interestRadius);
-			        }
-			        else
-			        {
-				        // No interest management, see all players
-				        for (const auto& otherPair: players)
-				        {
-					        if (otherPair.second.isAuthenticated)
-					        {
-						        visibleEntities.insert(otherPair.first);
-					        }
-				        }
-			        }
+		        const size_t grain = config.worldStateGrain > 0 ? config.worldStateGrain : (std::max)(recipients.size(), size_t(1));
+		        TickMemory memory = threadManager.parallelReduce(
+		                0, recipients.size(), grain, TickMemory{},
+		                [&](size_t first, size_t last)
+		                {
+			                FrameArena& arena = FrameArena::forThisThread();
+			                const uint64_t blocksBefore = arena.getUpstreamAllocations();
 
-			        // Add all players within interest radius
-			        for (uint32_t entityId: visibleEntities)
-			        {
-				        // Skip self
-				        if (entityId == player.id)
-					        continue;
+			                for (size_t index = first; index < last; ++index)
+			                {
+				                Player& player = *recipients[index];
+
+				                // A peer without a slot has nowhere to keep send state, so it gets no update
+				                ConnectionSlot* slot = slotFor(player.peer);
+				                if (slot == nullptr)
+					                continue;
+
+				                // Pick this peer's send rate and detail from its connection quality
+				                PeerSendState& sendState = slot->sendState;
+				                SendQuality quality = updatePeerSendQuality(player, sendState);
+
+				                static constexpr uint32_t intervalTicks[] = { 1, 2, 3, 5 };
+				                static constexpr uint8_t positionBits[] = { 20, 20, 16, 14 };
+				                const size_t tier = static_cast<size_t>(quality);
+
+				                if (++sendState.ticksSinceSend < intervalTicks[tier])
+					                continue;
+				                sendState.ticksSinceSend = 0;
+
+				                // Collect all players within interest radius; the next player reuses this player's arena bytes
+				                FrameArena::Scope scope(arena);
+				                std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView> entries(&arena);
+				                collectVisiblePlayers(player, players, spatialGrid, radius, entries);
+
+				                // Update player's visible set for next time (reuses its capacity)
+				                player.visiblePlayers.resize(entries.size());
+				                for (size_t i = 0; i < entries.size(); ++i)
+					                player.visiblePlayers[i] = entries[i].id;
+
+				                // Keep only the nearest players on poor connections
+				                size_t maxEntities = 0;
+				                if (quality == SendQuality::Bad)
+					                maxEntities = config.sendRateBadMaxEntities;
+				                else if (quality == SendQuality::Poor || nearestOnly)
+					                maxEntities = config.sendRatePoorMaxEntities;
+
+				                if (maxEntities > 0 && entries.size() > maxEntities)
+				                {
+					                auto distanceSq = [&player](const GameProtocol::WorldStatePacket::PlayerView& info)
+					                {
+						                const float dx = info.position.x - player.position.x;
+						                const float dy = info.position.y - player.position.y;
+						                const float dz = info.position.z - player.position.z;
+						                return dx * dx + dy * dy + dz * dz;
+					                };
+					                std::nth_element(entries.begin(), entries.begin() + maxEntities, entries.end(), [&](const auto& a, const auto& b) { return distanceSq(a) < distanceSq(b); });
+					                entries.resize(maxEntities);
+				                }
 
-				        auto it = players.find(entityId);
-				        if (it != players.end() && it->second.isAuthenticated)
-				        {
-					        const Player& otherPlayer = it->second;
-
-					        // Add player to world state packet
-					        GameProtocol::WorldStatePacket::PlayerInfo info;
-					        info.id = otherPlayer.id;
-					        info.name = otherPlayer.name;
-					        info.position = otherPlayer.position;
-					        worldStatePacket->players.push_back(info);
-				        }
-			        }
+				                // Encode MTU-sized chunks here, while the names can still be borrowed; losing one only loses the players it carries
+				                auto chunks = GameProtocol::WorldStatePacket::encodeChunks(std::span<const GameProtocol::WorldStatePacket::PlayerView>(entries), config.worldStateChunkBytes, config.compactWorldState, snapshotId,
+				                        positionBits[tier], &arena);
+				                const auto packetType = config.compactWorldState ? GameProtocol::PacketType::CompactWorldState : GameProtocol::PacketType::WorldState;
 
-			        // Update player's visible set for next time
-			        player.visiblePlayers = visibleEntities;
+				                // Get a local reference to the peer for sending
+				                ENetPeer* playerPeer = player.peer;
 
-			        // Get a local reference to the peer for sending
-			        ENetPeer* playerPeer = player.peer;
+				                // Send world state (use unreliable packet for frequent updates)
+				                // Do this in a separate task to avoid holding resources during network operations
+				                threadManager.scheduleTask(
+				                        [this, playerPeer, packetType, chunks = std::move(chunks)]() mutable
+				                        {
+					                        for (auto& chunk: chunks)
+					                        {
+						                        sendSerialized(playerPeer, std::move(chunk), packetType, false);
+					                        }
+				                        });
+			                }
+
+			                // Helpers hand their arena back now; the calling thread's still holds the recipient list
+			                TickMemory chunkMemory{ arena.getUpstreamAllocations() - blocksBefore, arena.getPeakBytes() };
+			                if (&arena != &tickArena)
+				                arena.reset();
+			                return chunkMemory;
+		                },
+		                [](TickMemory total, TickMemory chunk)
+		                {
+			                total.arenaBlocks += chunk.arenaBlocks;
+			                total.arenaBytes = (std::max)(total.arenaBytes, chunk.arenaBytes);
+			                return total;
+		                });
+
+		        worldStateArenaBlocks = memory.arenaBlocks;
+		        worldStateArenaBytes = (std::max)(memory.arenaBytes, tickArena.getPeakBytes());
+		        tickArena.reset();
+
+		        worldStateLatencyMs = Utils::getCurrentTimeMs() - scheduledAt;
+	        });
+}
+
+// Sample ENet stats for a peer and update its send quality (caller holds Players)
+SendQuality GameServer::updatePeerSendQuality(Player& player, PeerSendState& state)
+{
+	ENetPeer* peer = player.peer;
+	player.pingMs = peer->roundTripTime;
+	player.packetLossPercent = 100.0f * static_cast<float>(peer->packetLoss) / static_cast<float>(ENET_PEER_PACKET_LOSS_SCALE);
+
+	if (!config.adaptiveSendRate)
+	{
+		state.quality = SendQuality::Good;
+		return state.quality;
+	}
+
+	// Worst of the RTT, loss and throttle verdicts
+	const float throttle = static_cast<float>(peer->packetThrottle) / static_cast<float>(ENET_PEER_PACKET_THROTTLE_SCALE);
+
+	SendQuality measured = SendQuality::Good;
+	if (player.pingMs >= config.sendRateBadRttMs || player.packetLossPercent >= config.sendRateBadLoss || throttle < 0.25f)
+		measured = SendQuality::Bad;
+	else if (player.pingMs >= config.sendRatePoorRttMs || player.packetLossPercent >= config.sendRatePoorLoss || throttle < 0.5f)
+		measured = SendQuality::Poor;
+	else if (player.pingMs >= config.sendRateFairRttMs || player.packetLossPercent >= config.sendRateFairLoss)
+		measured = SendQuality::Fair;
+
+	// Degrade immediately, recover one tier at a time once the link has stayed better for a while
+	SendQuality previous = state.quality;
+	if (measured > state.quality)
+	{
+		state.quality = measured;
+		state.recoverySamples = 0;
+	}
+	else if (measured < state.quality)
+	{
+		if (++state.recoverySamples >= config.sendRateRecoveryTicks)
+		{
+			state.quality = static_cast<SendQuality>(static_cast<uint8_t>(state.quality) - 1);
+			state.recoverySamples = 0;
+		}
+	}
+	else
+	{
+		state.recoverySamples = 0;
+	}
+
+	if (state.quality != previous)
+	{
+		static const char* qualityNames[] = { "good", "fair", "poor", "bad" };
+		logger.info("Send quality for " + player.name + ": " + qualityNames[static_cast<size_t>(previous)] + " -> " + qualityNames[static_cast<size_t>(state.quality)] + " (rtt " + std::to_string(player.pingMs) + "ms, loss " +
+		            std::to_string(player.packetLossPercent) + "%, throttle " + std::to_string(peer->packetThrottle) + "/" + std::to_string(ENET_PEER_PACKET_THROTTLE_SCALE) + ")");
+	}
+
+	return state.quality;
+}
+
+// Interest radius for this tick, narrowed while shedding load; 0 means everyone is visible
+float GameServer::currentInterestRadius() const
+{
+	if (config.interestRadius > 0 && overload.atLeast(OverloadLevel::ReduceInterest))
+	{
+		return config.interestRadius * config.overloadInterestScale;
+	}
+	return config.interestRadius;
+}
+
+// Queue chat backfill and initial world sync for a newly authenticated player (caller holds Players and SpatialGrid)
+void GameServer::queueJoinStreams(ENetPeer* peer, const Player& player)
+{
+	// Full world state in one reliable stream instead of waiting for unreliable chunks
+	std::pmr::vector<GameProtocol::WorldStatePacket::PlayerView> entries;
+	collectVisiblePlayers(player, players, spatialGrid, currentInterestRadius(), entries);
+
+	std::vector<uint8_t> syncPayload;
+	GameProtocol::WorldStatePacket::encode(syncPayload, std::span<const GameProtocol::WorldStatePacket::PlayerView>(entries), ++worldSnapshotId, 0, 1, config.compactWorldState,
+	        static_cast<uint8_t>(GameProtocol::WorldStatePacket::POSITION_RANGE.bits));
 
-			        // Send world state (use unreliable packet for frequent updates)
-			        // Do this in a separate task to avoid holding resources during network operations
-			        threadManager.scheduleTask([this, playerPeer, packet = std::move(worldStatePacket)]() { sendPacket(playerPeer, *packet, false); });
+	threadManager.scheduleResourceTask({ GameResources::BulkStreamsId }, [this, peer, payload = std::move(syncPayload)]() { bulkStreamer.queueStream(peer, GameProtocol::BulkStreamKind::WorldSync, payload); });
+
+	// Recent chat history
+	threadManager.scheduleResourceTask({ GameResources::ChatId, GameResources::BulkStreamsId },
+	        [this, peer]()
+	        {
+		        if (chatHistory.empty())
+			        return;
+
+		        std::vector<uint8_t> payload;
+		        for (const auto& msg: chatHistory)
+		        {
+			        GameProtocol::appendPacketToStream(payload, GameProtocol::ChatMessagePacket(msg.sender, msg.content, msg.isGlobal));
 		        }
+
+		        bulkStreamer.queueStream(peer, GameProtocol::BulkStreamKind::ChatBackfill, payload);
 	        });
 }
 
 // Check for timed out players
 void GameServer::checkTimeouts()
 {
-	threadManager.scheduleResourceTask({ GameResources::PlayersId },
+	threadManager.scheduleResourceTask({ GameResources::PlayersId, GameResources::ConnectionSlotsId },
 	        [this]()
 	        {
 		        uint32_t currentTime = Utils::getCurrentTimeMs();
-		        std::vector<uint32_t> timeoutPlayers;
-
-		        // First pass: identify timed out players
-		        for (const auto& pair: players)
-		        {
-			        // Skip unauthenticated players
-			        if (!pair.second.isAuthenticated)
-				        continue;
 
-			        if (currentTime - pair.second.lastUpdateTime > config.timeoutMs)
-			        {
-				        timeoutPlayers.push_back(pair.first);
-			        }
-		        }
+		        // First pass: identify timed out players, scanning ranges of hash buckets in parallel
+		        std::vector<uint32_t> timeoutPlayers = threadManager.parallelReduce(
+		                0, players.bucket_count(), 256, std::vector<uint32_t>(),
+		                [this, currentTime](size_t first, size_t last)
+		                {
+			                std::vector<uint32_t> timedOut;
+			                for (size_t bucket = first; bucket < last; bucket++)
+			                {
+				                for (auto it = players.cbegin(bucket); it != players.cend(bucket); ++it)
+				                {
+					                // Skip unauthenticated players
+					                if (it->second.isAuthenticated && currentTime - it->second.lastUpdateTime > config.timeoutMs)
+					                {
+						                timedOut.push_back(it->first);
+					                }
+				                }
+			                }
+			                return timedOut;
+		                },
+		                [](std::vector<uint32_t> all, std::vector<uint32_t> chunk)
+		                {
+			                all.insert(all.end(), chunk.begin(), chunk.end());
+			                return all;
+		                });
 
 		        // Second pass: handle each timed-out player
 		        for (uint32_t id: timeoutPlayers)
@@ -2025,6 +2497,12 @@ void GameServer::checkTimeouts()
 				        // Disconnect the player - do this in a separate task
 				        threadManager.scheduleTask([playerPeer]() { enet_peer_disconnect(playerPeer, 0); });
 
+				        // The slot stays taken until ENet reports the disconnect, but no longer has a player
+				        if (ConnectionSlot* slot = slotFor(playerPeer))
+				        {
+					        slot->player = nullptr;
+				        }
+
 				        // Remove from players map
 				        players.erase(it);
 			        }
@@ -2072,24 +2550,19 @@ void GameServer::broadcastSystemMessage(const std::string& message)
 	        });
 }
 
-std::vector<std::string> GameServer::getOnlinePlayerNames()
+Task<std::vector<std::string>> GameServer::getOnlinePlayerNames()
 {
-	// Schedule a read task and wait for the result
-	return threadManager
-	        .scheduleReadTaskWithResult({ GameResources::PlayersId },
-	                [this]() -> std::vector<std::string>
-	                {
-		                std::vector<std::string> names;
-		                for (const auto& pair: players)
-		                {
-			                if (pair.second.isAuthenticated)
-			                {
-				                names.push_back(pair.second.name);
-			                }
-		                }
-		                return names;
-	                })
-	        .get(); // Wait for the result
+	co_await threadManager.acquireRead(GameResources::PlayersId);
+
+	std::vector<std::string> names;
+	for (const auto& pair: players)
+	{
+		if (pair.second.isAuthenticated)
+		{
+			names.push_back(pair.second.name);
+		}
+	}
+	co_return names;
 }
 
 // Updated function signature
@@ -2531,6 +3004,106 @@ void GameServer::loadConfig()
 			{
 				config.spawnPosition.z = std::stof(value);
 			}
+			else if (key == "compact_world_state")
+			{
+				config.compactWorldState = (value == "true" || value == "1");
+			}
+			else if (key == "world_state_chunk_bytes")
+			{
+				config.worldStateChunkBytes = std::stoul(value);
+			}
+			else if (key == "bulk_bytes_per_tick")
+			{
+				config.bulkBytesPerTick = std::stoul(value);
+			}
+			else if (key == "bulk_window_bytes")
+			{
+				config.bulkWindowBytes = std::stoul(value);
+			}
+			else if (key == "adaptive_send_rate")
+			{
+				config.adaptiveSendRate = (value == "true" || value == "1");
+			}
+			else if (key == "send_rate_fair_rtt_ms")
+			{
+				config.sendRateFairRttMs = std::stoul(value);
+			}
+			else if (key == "send_rate_poor_rtt_ms")
+			{
+				config.sendRatePoorRttMs = std::stoul(value);
+			}
+			else if (key == "send_rate_bad_rtt_ms")
+			{
+				config.sendRateBadRttMs = std::stoul(value);
+			}
+			else if (key == "send_rate_fair_loss")
+			{
+				config.sendRateFairLoss = std::stof(value);
+			}
+			else if (key == "send_rate_poor_loss")
+			{
+				config.sendRatePoorLoss = std::stof(value);
+			}
+			else if (key == "send_rate_bad_loss")
+			{
+				config.sendRateBadLoss = std::stof(value);
+			}
+			else if (key == "send_rate_poor_max_entities")
+			{
+				config.sendRatePoorMaxEntities = std::stoul(value);
+			}
+			else if (key == "send_rate_bad_max_entities")
+			{
+				config.sendRateBadMaxEntities = std::stoul(value);
+			}
+			else if (key == "send_rate_recovery_ticks")
+			{
+				config.sendRateRecoveryTicks = std::stoul(value);
+			}
+			else if (key == "encryption_enabled")
+			{
+				config.encryptionEnabled = (value == "true" || value == "1");
+			}
+			else if (key == "require_encryption")
+			{
+				config.requireEncryption = (value == "true" || value == "1");
+			}
+			else if (key == "pre_auth_packets_per_second")
+			{
+				config.preAuthPacketsPerSecond = std::stoul(value);
+			}
+			else if (key == "enet_pooled_allocator")
+			{
+				config.enetPooledAllocator = (value == "true" || value == "1");
+			}
+			else if (key == "network_listeners")
+			{
+				config.networkListeners = std::stoul(value);
+			}
+			else if (key == "overload_control")
+			{
+				config.overloadControl = (value == "true" || value == "1");
+			}
+			else if (key == "overload_tick_budget_ms")
+			{
+				config.overloadTickBudgetMs = std::stoul(value);
+			}
+			else if (key == "overload_queue_limit")
+			{
+				config.overloadQueueLimit = std::stoul(value);
+			}
+			else if (key == "overload_recover_ticks")
+			{
+				config.overloadRecoverTicks = std::stoul(value);
+			}
+			else if (key == "overload_interest_scale")
+			{
+				config.overloadInterestScale = std::stof(value);
+			}
+			else if (key == "world_state_grain")
+			{
+				config.worldStateGrain = std::stoul(value);
+			}
 
 			// database configuration options
 			else if (key == "use_database")
@@ -2603,6 +3176,31 @@ void GameServer::createDefaultConfig()
 	file << "spawn_position_x=" << DEFAULT_SPAWN_X << "\n";
 	file << "spawn_position_y=" << DEFAULT_SPAWN_Y << "\n";
 	file << "spawn_position_z=" << DEFAULT_SPAWN_Z << "\n";
+	file << "compact_world_state=" << (COMPACT_WORLD_STATE ? "true" : "false") << "\n";
+	file << "world_state_chunk_bytes=" << WORLD_STATE_CHUNK_BYTES << "\n";
+	file << "bulk_bytes_per_tick=" << BULK_BYTES_PER_TICK << "\n";
+	file << "bulk_window_bytes=" << BULK_WINDOW_BYTES << "\n";
+	file << "adaptive_send_rate=" << (ADAPTIVE_SEND_RATE ? "true" : "false") << "\n";
+	file << "send_rate_fair_rtt_ms=" << SEND_RATE_FAIR_RTT_MS << "\n";
+	file << "send_rate_poor_rtt_ms=" << SEND_RATE_POOR_RTT_MS << "\n";
+	file << "send_rate_bad_rtt_ms=" << SEND_RATE_BAD_RTT_MS << "\n";
+	file << "send_rate_fair_loss=" << SEND_RATE_FAIR_LOSS << "\n";
+	file << "send_rate_poor_loss=" << SEND_RATE_POOR_LOSS << "\n";
+	file << "send_rate_bad_loss=" << SEND_RATE_BAD_LOSS << "\n";
+	file << "send_rate_poor_max_entities=" << SEND_RATE_POOR_MAX_ENTITIES << "\n";
+	file << "send_rate_bad_max_entities=" << SEND_RATE_BAD_MAX_ENTITIES << "\n";
+	file << "send_rate_recovery_ticks=" << SEND_RATE_RECOVERY_TICKS << "\n";
+	file << "encryption_enabled=" << (ENCRYPTION_ENABLED ? "true" : "false") << "\n";
+	file << "require_encryption=" << (REQUIRE_ENCRYPTION ? "true" : "false") << "\n";
+	file << "pre_auth_packets_per_second=" << PRE_AUTH_PACKETS_PER_SECOND << "\n";
+	file << "enet_pooled_allocator=" << (ENET_POOLED_ALLOCATOR ? "true" : "false") << "\n";
+	file << "network_listeners=" << NETWORK_LISTENERS << "\n";
+	file << "overload_control=" << (OVERLOAD_CONTROL ? "true" : "false") << "\n";
+	file << "overload_tick_budget_ms=" << OVERLOAD_TICK_BUDGET_MS << "\n";
+	file << "overload_queue_limit=" << OVERLOAD_QUEUE_LIMIT << "\n";
+	file << "overload_recover_ticks=" << OVERLOAD_RECOVER_TICKS << "\n";
+	file << "overload_interest_scale=" << OVERLOAD_INTEREST_SCALE << "\n";
+	file << "world_state_grain=" << WORLD_STATE_GRAIN << "\n";
 
 	// Database configuration
 	file << "\n# Database Configuration\n";
@@ -2892,13 +3490,8 @@ void GameServer::initializeCommandHandlers()
 
 		std::string targetName = args[1];
 
-		// Schedule the kick operation
-		threadManager.scheduleTask(
-		        [this, targetName, adminName = player.name]()
-		        {
-			        kickPlayer(targetName, adminName);
-			        // Note: kickPlayer has been refactored to use resource tasks internally
-		        });
+		// Runs once this handler has released Players
+		threadManager.spawn(kickPlayer(targetName, player.name));
 
 		auto packet = PacketManager::createSystemMessage("Attempting to kick player: " + targetName);
 		sendPacket(player.peer, *packet, true);
@@ -2923,13 +3516,8 @@ void GameServer::initializeCommandHandlers()
 
 		std::string targetName = args[1];
 
-		// Schedule the ban operation
-		threadManager.scheduleTask(
-		        [this, targetName, adminName = player.name]()
-		        {
-			        banPlayer(targetName, adminName);
-			        // Note: banPlayer has been refactored to use resource tasks internally
-		        });
+		// Runs once this handler has released Players
+		threadManager.spawn(banPlayer(targetName, player.name));
 
 		auto packet = PacketManager::createSystemMessage("Attempting to ban player: " + targetName);
 		sendPacket(player.peer, *packet, true);
@@ -3017,26 +3605,8 @@ void GameServer::initializeCommandHandlers()
 
 		std::string targetName = args[1];
 
-		// Schedule the operation and get the result
-		bool success = threadManager
-		                       .scheduleResourceTaskWithResult<bool>({ GameResources::AuthId, GameResources::PlayersId },
-		                               [this, targetName]() -> bool
-		                               {
-			                               return setPlayerAdmin(targetName, true);
-			                               // Note: setPlayerAdmin has been refactored to work directly with resources
-		                               })
-		                       .get(); // Wait for the result
-
-		if (success)
-		{
-			auto packet = PacketManager::createSystemMessage("Admin status granted to " + targetName);
-			sendPacket(player.peer, *packet, true);
-		}
-		else
-		{
-			auto packet = PacketManager::createSystemMessage("Failed to set admin status for " + targetName);
-			sendPacket(player.peer, *packet, true);
-		}
+		// Needs Auth as well, so it runs once this handler has released Players
+		threadManager.spawn(updateAdminStatus(targetName, true, player.peer));
 	};
 
 	// Teleport to player command - Needs access to players and spatial grid
@@ -3110,53 +3680,145 @@ void GameServer::initializeCommandHandlers()
 }
 
 // Kick a player by name
-bool GameServer::kickPlayer(const std::string& playerName, const std::string& adminName)
+Task<bool> GameServer::kickPlayer(std::string playerName, std::string adminName)
 {
-	// We need to be more explicit with the types to avoid template deduction issues
-	// Use a regular resource task and track the result manually
-	std::promise<bool> resultPromise;
-	std::future<bool> resultFuture = resultPromise.get_future();
+	co_await threadManager.acquire(GameResources::PlayersId);
 
-	// Schedule the task without using scheduleResourceTaskWithResult
-	threadManager.scheduleResourceTask({ GameResources::PlayersId },
-	        [this, playerName, adminName, &resultPromise]()
-	        {
-		        bool playerFound = false;
+	for (auto& pair: players)
+	{
+		if (pair.second.isAuthenticated && pair.second.name == playerName)
+		{
+			// Log the kick
+			logger.info("Player " + playerName + " kicked by " + adminName);
 
-		        for (auto& pair: players)
+			// Schedule disconnecting the player
+			enet_peer_disconnect(pair.second.peer, 0);
+			co_return true;
+		}
+	}
+
+	co_return false;
+}
+
+// Ban a player's address by name, then kick them
+Task<bool> GameServer::banPlayer(std::string playerName, std::string adminName)
+{
+	co_await threadManager.acquireRead(GameResources::PlayersId);
+
+	std::string cidr;
+	for (const auto& pair: players)
+	{
+		if (pair.second.isAuthenticated && pair.second.name == playerName && pair.second.peer != nullptr)
+		{
+			cidr = BanList::formatCidr(BanAddress::fromEnet(pair.second.peer->address), 128);
+			break;
+		}
+	}
+
+	if (cidr.empty())
+	{
+		logger.error("Cannot ban " + playerName + ": player not online");
+		co_return false;
+	}
+
+	std::string error;
+	if (!banList.addRule(cidr, false, "Player " + playerName, adminName, error))
+	{
+		logger.error(error);
+		co_return false;
+	}
+	saveBanList();
+
+	logger.info("Player " + playerName + " (" + cidr + ") banned by " + adminName);
+	co_return co_await kickPlayer(playerName, adminName);
+}
+
+void GameServer::loadBanList()
+{
+	threadManager.scheduleResourceTask({ GameResources::DatabaseId },
+	        [this]()
+	        {
+		        std::vector<BanRule> rules;
+		        if (config.useDatabase)
 		        {
-			        if (pair.second.isAuthenticated && pair.second.name == playerName)
+			        if (dbManager.loadBans(rules))
 			        {
-				        // Cache player data needed for follow-up tasks
-				        Player playerCopy = pair.second;
-				        ENetPeer* playerPeer = pair.second.peer;
-
-				        // Log the kick
-				        logger.info("Player " + playerName + " kicked by " + adminName);
+				        banList.setRules(std::move(rules));
+				        return;
+			        }
+			        logger.error("Failed to load ban list from database. Falling back to file.");
+		        }
 
-				        // Schedule disconnecting the player
-				        enet_peer_disconnect(playerPeer, 0);
+		        std::ifstream file(BAN_LIST_FILE);
+		        if (!file.is_open())
+		        {
+			        return;
+		        }
 
-				        playerFound = true;
-				        break;
+		        // One rule per line: cidr, ban|allow, created at, created by, reason (tab separated)
+		        std::string line;
+		        while (std::getline(file, line))
+		        {
+			        std::istringstream fields(line);
+			        std::string cidr;
+			        std::string kind;
+			        std::string createdAt;
+			        BanRule rule;
+			        if (!std::getline(fields, cidr, '\t') || !std::getline(fields, kind, '\t') || !std::getline(fields, createdAt, '\t') || !BanList::parseCidr(cidr, rule.network, rule.prefixLength))
+			        {
+				        logger.warning("Skipping invalid ban entry: " + line);
+				        continue;
 			        }
+			        rule.allow = kind == "allow";
+			        rule.createdAt = std::strtoll(createdAt.c_str(), nullptr, 10);
+			        std::getline(fields, rule.createdBy, '\t');
+			        std::getline(fields, rule.reason);
+			        rules.push_back(std::move(rule));
 		        }
 
-		        // Set the result in the promise
-		        resultPromise.set_value(playerFound);
+		        logger.info("Loaded " + std::to_string(rules.size()) + " ban rules from file");
+		        banList.setRules(std::move(rules));
 	        });
-
-	// Wait for and return the result
-	return resultFuture.get();
 }
 
-// Ban a player by name
-bool GameServer::banPlayer(const std::string& playerName, const std::string& adminName)
+void GameServer::saveBanList()
 {
-	// TODO: Implement a proper ban system with IP tracking and ban list
+	threadManager.scheduleResourceTask({ GameResources::DatabaseId },
+	        [this]()
+	        {
+		        const std::vector<BanRule> rules = banList.getRules();
+		        if (config.useDatabase)
+		        {
+			        if (dbManager.saveBans(rules))
+			        {
+				        return;
+			        }
+			        logger.error("Failed to save ban list to database. Falling back to file.");
+		        }
+
+		        std::ofstream file(BAN_LIST_FILE, std::ios::trunc);
+		        if (!file.is_open())
+		        {
+			        logger.error("Could not open ban list file for writing");
+			        return;
+		        }
+
+		        for (const auto& rule: rules)
+		        {
+			        file << BanList::formatCidr(rule.network, rule.prefixLength) << '\t' << (rule.allow ? "allow" : "ban") << '\t' << rule.createdAt << '\t' << rule.createdBy << '\t' << rule.reason << '\n';
+		        }
+	        });
+}
 
-	// For now, just kick the player
-	return kickPlayer(playerName, adminName);
+void GameServer::printBanList()
+{
+	const std::vector<BanRule> rules = banList.getRules();
+	logger.info("===== Ban List (" + std::to_string(rules.size()) + " rules) =====");
+	for (const auto& rule: rules)
+	{
+		logger.info(std::string(rule.allow ? "allow " : "ban   ") + BanList::formatCidr(rule.network, rule.prefixLength) + " by " + rule.createdBy + (rule.reason.empty() ? "" : " - " + rule.reason));
+	}
+	logger.info("=========================");
 }
 
 // Set a player's admin status
@@ -3200,11 +3862,27 @@ bool GameServer::setPlayerAdmin(const std::string& playerName, bool isAdmin)
 	return true;
 }
 
+// Change a player's admin status with Auth and Players held, and tell the requesting player how it went
+Task<bool> GameServer::updateAdminStatus(std::string playerName, bool isAdmin, ENetPeer* requester)
+{
+	co_await threadManager.acquire(GameResources::AuthId, GameResources::PlayersId);
+	const bool success = setPlayerAdmin(playerName, isAdmin);
+
+	if (requester != nullptr)
+	{
+		const std::string result = success ? "Admin status " + std::string(isAdmin ? "granted to " : "revoked from ") + playerName : "Failed to set admin status for " + playerName;
+		auto packet = PacketManager::createSystemMessage(result);
+		sendPacket(requester, *packet, true);
+	}
+
+	co_return success;
+}
+
 // Print server status to console
 void GameServer::printServerStatus()
 {
 	// Use scheduleReadTask instead of scheduleReadTaskWithResult since we don't need the return value
-	threadManager.scheduleReadTask({ GameResources::PlayersId, GameResources::AuthId },
+	threadManager.scheduleReadTask({ GameResources::PlayersId, GameResources::AuthId, GameResources::BulkStreamsId, GameResources::ConnectionSlotsId },
 	        [this]()
 	        {
 		        // Count authenticated players
@@ -3227,11 +3905,40 @@ void GameServer::printServerStatus()
 		        logger.info("Port: " + std::to_string(config.port));
 		        logger.info("Players: " + std::to_string(authenticatedCount) + " online, " + std::to_string(registeredCount) + " registered");
 		        logger.info("Max concurrent players: " + std::to_string(stats.maxConcurrentPlayers));
+		        logger.info("Connection slots: " + std::to_string(activeConnections) + " of " + std::to_string(connectionSlotCount) + " in use");
+		        const auto allocator = PooledAllocator::getCounters();
+		        if (allocator.allocations > 0)
+		        {
+			        logger.info("ENet allocator: " + std::to_string(allocator.allocations) + " allocations, " + std::to_string(allocator.frees) + " frees, " + std::to_string(allocator.cacheMisses) + " pool refills, " +
+			                    std::to_string(allocator.largeAllocations) + " large, " + Utils::formatBytes(static_cast<uint32_t>(allocator.bytesReserved)) + " reserved");
+		        }
+		        if (listenerCount > 1)
+		        {
+			        std::string perListener;
+			        for (uint32_t i = 0; i < listenerCount; i++)
+			        {
+				        perListener += (i ? ", " : "") + std::to_string(listeners[i].host->connectedPeers) + " peers/" + std::to_string(listeners[i].packetsReceived.load()) + " packets";
+			        }
+			        logger.info("Listeners: " + std::to_string(listenerCount) + " on port " + std::to_string(config.port) + " (" + perListener + ")");
+		        }
 		        logger.info("Total connections: " + std::to_string(stats.totalConnections));
 		        logger.info("Failed auth attempts: " + std::to_string(stats.authFailures));
+		        logger.info("Pre-auth packets dropped: " + std::to_string(stats.preAuthDrops));
+		        logger.info("Banned connections refused: " + std::to_string(stats.refusedConnections));
+		        logger.info("Service level: " + std::string(OverloadController::levelName(overload.getLevel())) + (overload.isForced() ? " (forced)" : "") + ", load " + std::to_string(overload.getLoad()) + ", world state tick " +
+		                    std::to_string(worldStateLatencyMs.load()) + " ms, " + std::to_string(threadManager.getQueuedTaskCount()) + " queued tasks");
+		        const uint32_t now = Utils::getCurrentTimeMs();
+		        for (const auto& transition: overload.getRecentTransitions())
+		        {
+			        logger.info("  " + std::to_string((now - transition.timeMs) / 1000) + "s ago: " + OverloadController::levelName(transition.from) + " -> " + OverloadController::levelName(transition.to) + " (load " +
+			                    std::to_string(transition.load) + ")");
+		        }
+		        logger.info("World state tick memory: " + Utils::formatBytes(static_cast<uint32_t>(worldStateArenaBytes.load())) + " from the frame arena, " + std::to_string(worldStateArenaBlocks.load()) + " new arena blocks");
 		        logger.info("Network stats:");
 		        logger.info("  Packets: " + std::to_string(stats.totalPacketsSent) + " sent, " + std::to_string(stats.totalPacketsReceived) + " received");
 		        logger.info("  Data: " + Utils::formatBytes(stats.totalBytesSent) + " sent, " + Utils::formatBytes(stats.totalBytesReceived) + " received");
+		        logger.info("  Secure channels: " + std::to_string(packetManager.getSecureChannelCount()) + (config.requireEncryption ? " (required)" : ""));
+		        logger.info("  Bulk: " + std::to_string(bulkStreamer.getChunksSent()) + " chunks sent, " + std::to_string(bulkStreamer.getPendingChunkCount()) + " pending, " + std::to_string(bulkStreamer.getDeferredTicks()) + " window stalls");
 		        logger.info("Thread Pool: " + std::to_string(threadManager.getThreadCount()) + " threads");
 		        logger.info("=========================");
 	        });
@@ -3257,7 +3964,7 @@ void GameServer::printPlayerList()
 				        if (pair.second.isAuthenticated)
 				        {
 					        std::string playerInfo =
-					                "- " + pair.second.name + " (ID: " + std::to_string(pair.second.id) + ")" + (pair.second.isAdmin ? " [ADMIN]" : "") + " @ X=" + std::to_string(pair.second.position.x) + " Y=" + std::to_string(pair.second.position.y) + " Z=" + std::to_string(pair.second.position.z) + " | IP: " + pair.second.ipAddress;
+					                "- " + pair.second.name + " (ID: " + std::to_string(pair.second.id) + ")" + (pair.second.isAdmin ? " [ADMIN]" : "") + " @ X=" + std::to_string(pair.second.position.x) + " Y=" + std::to_string(pair.second.position.y) + " Z=" + std::to_string(pair.second.position.z) + " | IP: " + pair.second.ipAddress + " | Ping: " + std::to_string(pair.second.pingMs) + "ms, Loss: " + std::to_string(pair.second.packetLossPercent) + "%";
 					        logger.info(playerInfo);
 				        }
 			        }
@@ -3276,7 +3983,12 @@ void GameServer::printConsoleHelp()
 	logger.info("players - List online players");
 	logger.info("broadcast <message> - Send message to all players");
 	logger.info("kick <username> - Kick a player");
-	logger.info("ban <username> - Ban a player");
+	logger.info("ban <username> - Ban a player's address and kick them");
+	logger.info("banip <address/cidr> [reason] - Refuse connections from an address range");
+	logger.info("allowip <address/cidr> [reason] - Exempt a range inside a wider ban");
+	logger.info("unbanip <address/cidr> - Remove a ban or allow rule");
+	logger.info("bans - List ban and allow rules");
+	logger.info("overload auto|0-4 - Pin the service level or return it to automatic control");
 	logger.info("save - Save player data manually");
 	logger.info("setadmin <username> - Grant admin status");
 	logger.info("removeadmin <username> - Remove admin status");
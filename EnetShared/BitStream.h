@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GameProtocol
+{
+
+	// Map signed values onto unsigned so small negative deltas stay small as varints
+	inline constexpr uint32_t zigzagEncode(int32_t value)
+	{
+		return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	}
+
+	inline constexpr int32_t zigzagDecode(uint32_t value)
+	{
+		return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+	}
+
+	// Encoded size of a LEB128 varint in bytes
+	inline constexpr size_t varUintSize(uint32_t value)
+	{
+		size_t size = 1;
+		while (value >= 0x80)
+		{
+			value >>= 7;
+			size++;
+		}
+		return size;
+	}
+
+	// Range and precision of a quantized float
+	struct FixedPointRange
+	{
+		float min;
+		float max;
+		uint32_t bits; // 1-32
+
+		constexpr uint32_t maxValue() const
+		{
+			return bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+		}
+
+		// Quantize a float into [0, maxValue], clamping values outside the range
+		uint32_t quantize(float value) const
+		{
+			return quantize(value, static_cast<float>(maxValue()) / (max - min));
+		}
+
+		// Same with the scale (maxValue / (max - min)) computed once by the caller; NaN maps to 0
+		uint32_t quantize(float value, float scale) const
+		{
+			if (std::isnan(value))
+				return 0;
+
+			// At 32 bits the top of the range rounds up to 2^32 as a float, which does not fit the result
+			const float scaled = (std::clamp(value, min, max) - min) * scale + 0.5f;
+			return scaled >= static_cast<float>(maxValue()) ? maxValue() : static_cast<uint32_t>(scaled);
+		}
+
+		float dequantize(uint32_t value) const
+		{
+			const float scale = (max - min) / static_cast<float>(maxValue());
+			return min + static_cast<float>(value) * scale;
+		}
+	};
+
+	// Bit-granular writer appending to a byte buffer (LSB-first within each byte)
+	class BitWriter
+	{
+	public:
+		explicit BitWriter(std::vector<uint8_t>& buffer)
+		      : buffer(buffer)
+		{
+		}
+
+		// Write the low 'count' bits of value (count <= 32)
+		void writeBits(uint32_t value, uint32_t count)
+		{
+			if (count == 0)
+				return;
+
+			const uint64_t mask = count >= 32 ? 0xFFFFFFFFull : ((1ull << count) - 1ull);
+			scratch |= (static_cast<uint64_t>(value) & mask) << scratchBits;
+			scratchBits += count;
+			totalBits += count;
+
+			while (scratchBits >= 8)
+			{
+				buffer.push_back(static_cast<uint8_t>(scratch));
+				scratch >>= 8;
+				scratchBits -= 8;
+			}
+		}
+
+		void writeBool(bool value)
+		{
+			writeBits(value ? 1u : 0u, 1);
+		}
+
+		// LEB128: 7 payload bits per group, high bit marks continuation
+		void writeVarUint(uint32_t value)
+		{
+			while (value >= 0x80)
+			{
+				writeBits((value & 0x7F) | 0x80, 8);
+				value >>= 7;
+			}
+			writeBits(value, 8);
+		}
+
+		void writeVarInt(int32_t value)
+		{
+			writeVarUint(zigzagEncode(value));
+		}
+
+		void writeFixed(float value, const FixedPointRange& range)
+		{
+			writeBits(range.quantize(value), range.bits);
+		}
+
+		// Quantize a whole array first so the arithmetic loop stays branch-free and vectorizable
+		// (in fixed-size batches on the stack, so writing never allocates beyond the output buffer)
+		void writeFixedArray(std::span<const float> values, const FixedPointRange& range)
+		{
+			const float scale = static_cast<float>(range.maxValue()) / (range.max - range.min);
+			for (size_t first = 0; first < values.size(); first += quantized.size())
+			{
+				const size_t count = (std::min)(quantized.size(), values.size() - first);
+				for (size_t i = 0; i < count; ++i)
+				{
+					quantized[i] = range.quantize(values[first + i], scale);
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					writeBits(quantized[i], range.bits);
+				}
+			}
+		}
+
+		// Varint length prefix followed by raw bytes
+		void writeString(std::string_view str)
+		{
+			writeVarUint(static_cast<uint32_t>(str.size()));
+			writeBytes(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+		}
+
+		void writeBytes(const uint8_t* data, size_t size)
+		{
+			if (scratchBits == 0)
+			{
+				// Aligned fast path
+				buffer.insert(buffer.end(), data, data + size);
+				totalBits += size * 8;
+				return;
+			}
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				writeBits(data[i], 8);
+			}
+		}
+
+		// Pad with zero bits up to the next byte boundary
+		void alignToByte()
+		{
+			if (scratchBits > 0)
+			{
+				writeBits(0, 8 - scratchBits);
+			}
+		}
+
+		// Must be called once writing is complete
+		void flush()
+		{
+			alignToByte();
+		}
+
+		size_t getBitsWritten() const
+		{
+			return totalBits;
+		}
+
+	private:
+		std::vector<uint8_t>& buffer;
+		std::array<uint32_t, 64> quantized;
+		uint64_t scratch = 0;
+		uint32_t scratchBits = 0;
+		size_t totalBits = 0;
+	};
+
+	// Bit-granular reader over a byte span; reads past the end return zero and set the overflow flag
+	class BitReader
+	{
+	public:
+		explicit BitReader(std::span<const uint8_t> data)
+		      : data(data)
+		{
+		}
+
+		uint32_t readBits(uint32_t count)
+		{
+			if (count == 0)
+				return 0;
+
+			if (bitPosition + count > data.size() * 8)
+			{
+				overflowed = true;
+				bitPosition = data.size() * 8;
+				return 0;
+			}
+
+			uint64_t value = 0;
+			uint32_t gathered = 0;
+			size_t bytePos = bitPosition / 8;
+			uint32_t bitOffset = static_cast<uint32_t>(bitPosition % 8);
+
+			while (gathered < count)
+			{
+				const uint32_t available = 8 - bitOffset;
+				const uint32_t take = (std::min)(available, count - gathered);
+				const uint64_t bits = (static_cast<uint64_t>(data[bytePos]) >> bitOffset) & ((1ull << take) - 1ull);
+				value |= bits << gathered;
+				gathered += take;
+				bitOffset = 0;
+				++bytePos;
+			}
+
+			bitPosition += count;
+			return static_cast<uint32_t>(value);
+		}
+
+		bool readBool()
+		{
+			return readBits(1) != 0;
+		}
+
+		uint32_t readVarUint()
+		{
+			uint32_t result = 0;
+			for (uint32_t shift = 0; shift < 35; shift += 7)
+			{
+				const uint32_t byte = readBits(8);
+				result |= (byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0 || overflowed)
+				{
+					return result;
+				}
+			}
+
+			// More than five groups cannot be a 32-bit value
+			overflowed = true;
+			return result;
+		}
+
+		int32_t readVarInt()
+		{
+			return zigzagDecode(readVarUint());
+		}
+
+		float readFixed(const FixedPointRange& range)
+		{
+			return range.dequantize(readBits(range.bits));
+		}
+
+		void readFixedArray(std::span<float> values, const FixedPointRange& range)
+		{
+			quantized.resize(values.size());
+			for (uint32_t& q: quantized)
+			{
+				q = readBits(range.bits);
+			}
+
+			const float scale = (range.max - range.min) / static_cast<float>(range.maxValue());
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				values[i] = range.min + static_cast<float>(quantized[i]) * scale;
+			}
+		}
+
+		std::string readString()
+		{
+			const uint32_t length = readVarUint();
+			if (overflowed || length > getBitsRemaining() / 8)
+			{
+				overflowed = true;
+				return {};
+			}
+
+			std::string str(length, '\0');
+			if (bitPosition % 8 == 0)
+			{
+				// Aligned fast path
+				std::memcpy(str.data(), data.data() + bitPosition / 8, length);
+				bitPosition += static_cast<size_t>(length) * 8;
+			}
+			else
+			{
+				for (uint32_t i = 0; i < length; ++i)
+				{
+					str[i] = static_cast<char>(readBits(8));
+				}
+			}
+			return str;
+		}
+
+		void alignToByte()
+		{
+			bitPosition = (std::min)((bitPosition + 7) & ~static_cast<size_t>(7), data.size() * 8);
+		}
+
+		size_t getBitsRemaining() const
+		{
+			return data.size() * 8 - bitPosition;
+		}
+
+		bool hasOverflowed() const
+		{
+			return overflowed;
+		}
+
+	private:
+		std::span<const uint8_t> data;
+		std::vector<uint32_t> quantized;
+		size_t bitPosition = 0;
+		bool overflowed = false;
+	};
+
+} // namespace GameProtocol
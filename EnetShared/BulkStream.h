@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "PacketTypes.h"
+
+namespace GameProtocol
+{
+
+	// Default payload bytes per bulk chunk, leaves room for ENet and packet headers under a 1400 byte MTU
+	inline constexpr size_t BULK_CHUNK_BYTES = 1200;
+
+	// Append a serialized packet to a bulk stream payload
+	inline void appendPacketToStream(std::vector<uint8_t>& payload, const Packet& packet)
+	{
+		std::vector<uint8_t> data = packet.serialize();
+		payload.insert(payload.end(), data.begin(), data.end());
+	}
+
+	// Split a stream payload into bulk chunks; empty if it needs more chunks than the uint16_t count can number
+	inline std::vector<BulkDataPacket> splitBulkStream(uint32_t streamId, BulkStreamKind kind, std::span<const uint8_t> payload, size_t chunkBytes = BULK_CHUNK_BYTES)
+	{
+		std::vector<BulkDataPacket> chunks;
+		chunkBytes = std::clamp<size_t>(chunkBytes, 1, BulkDataPacket::MAX_PAYLOAD_BYTES);
+		const size_t chunkCount = std::max<size_t>(1, (payload.size() + chunkBytes - 1) / chunkBytes);
+		if (chunkCount > UINT16_MAX)
+		{
+			return chunks;
+		}
+		chunks.reserve(chunkCount);
+
+		for (size_t i = 0; i < chunkCount; ++i)
+		{
+			BulkDataPacket chunk;
+			chunk.streamId = streamId;
+			chunk.kind = kind;
+			chunk.chunkIndex = static_cast<uint16_t>(i);
+			chunk.chunkCount = static_cast<uint16_t>(chunkCount);
+
+			const size_t offset = i * chunkBytes;
+			const size_t size = (std::min)(chunkBytes, payload.size() - (std::min)(offset, payload.size()));
+			chunk.payload.assign(payload.begin() + offset, payload.begin() + offset + size);
+
+			chunks.push_back(std::move(chunk));
+		}
+
+		return chunks;
+	}
+
+	// Decode the packets contained in a reassembled stream payload
+	inline std::vector<std::unique_ptr<Packet>> unpackBulkStream(std::span<const uint8_t> payload)
+	{
+		std::vector<std::unique_ptr<Packet>> packets;
+
+		while (payload.size() >= sizeof(PacketHeader))
+		{
+			PacketHeader header;
+			std::memcpy(&header, payload.data(), sizeof(header));
+
+			const size_t packetSize = sizeof(PacketHeader) + header.length;
+			if (!header.isValid() || packetSize > payload.size())
+			{
+				break;
+			}
+
+			if (auto packet = deserializePacket(payload.first(packetSize)))
+			{
+				packets.push_back(std::move(packet));
+			}
+
+			payload = payload.subspan(packetSize);
+		}
+
+		return packets;
+	}
+
+	// Reassembles bulk streams from their chunks on the receiving side
+	class BulkStreamAssembler
+	{
+	public:
+		// Add a chunk; returns true and fills 'completed' when its stream is complete
+		bool addChunk(const BulkDataPacket& chunk, std::vector<uint8_t>& completed)
+		{
+			if (chunk.chunkCount == 0 || chunk.chunkIndex >= chunk.chunkCount)
+			{
+				return false;
+			}
+
+			PendingStream& stream = streams[chunk.streamId];
+			if (stream.chunks.empty())
+			{
+				stream.chunks.resize(chunk.chunkCount);
+				stream.received.resize(chunk.chunkCount, false);
+			}
+			else if (stream.chunks.size() != chunk.chunkCount)
+			{
+				// Inconsistent chunk count, drop the stream
+				streams.erase(chunk.streamId);
+				return false;
+			}
+
+			if (!stream.received[chunk.chunkIndex])
+			{
+				stream.received[chunk.chunkIndex] = true;
+				stream.chunks[chunk.chunkIndex] = chunk.payload;
+				stream.receivedCount++;
+			}
+
+			if (stream.receivedCount < stream.chunks.size())
+			{
+				return false;
+			}
+
+			completed.clear();
+			for (const auto& part: stream.chunks)
+			{
+				completed.insert(completed.end(), part.begin(), part.end());
+			}
+
+			streams.erase(chunk.streamId);
+			return true;
+		}
+
+		void clear()
+		{
+			streams.clear();
+		}
+
+		size_t getPendingStreamCount() const
+		{
+			return streams.size();
+		}
+
+	private:
+		struct PendingStream
+		{
+			std::vector<std::vector<uint8_t>> chunks;
+			std::vector<bool> received;
+			size_t receivedCount = 0;
+		};
+
+		std::unordered_map<uint32_t, PendingStream> streams;
+	};
+
+} // namespace GameProtocol
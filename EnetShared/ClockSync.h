@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+namespace GameProtocol
+{
+
+	// Monotonic clock used for Ping/Pong timestamps, microseconds
+	inline uint64_t getMonotonicTimeUs()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// NTP-style clock offset and round trip estimator
+	// Each Ping/Pong exchange gives four timestamps: t0 client send, t1 server receive, t2 server send, t3 client receive.
+	// The offset of the sample with the lowest RTT in a sliding window is used, since its error is bounded by RTT / 2.
+	class ClockSyncEstimator
+	{
+	public:
+		static constexpr size_t WINDOW_SIZE = 8;
+		static constexpr size_t MIN_SAMPLES = 3;
+
+		// Add one exchange; returns false if the timestamps are inconsistent
+		bool addSample(uint64_t clientSendTime, uint64_t serverReceiveTime, uint64_t serverSendTime, uint64_t clientReceiveTime)
+		{
+			if (clientReceiveTime < clientSendTime || serverSendTime < serverReceiveTime)
+			{
+				rejectedSamples++;
+				return false;
+			}
+
+			const uint64_t total = clientReceiveTime - clientSendTime;
+			const uint64_t serverTime = serverSendTime - serverReceiveTime;
+			if (serverTime > total)
+			{
+				rejectedSamples++;
+				return false;
+			}
+
+			Sample sample;
+			sample.rttUs = total - serverTime;
+			sample.offsetUs = (static_cast<int64_t>(serverReceiveTime - clientSendTime) + static_cast<int64_t>(serverSendTime - clientReceiveTime)) / 2;
+
+			samples[nextSample] = sample;
+			nextSample = (nextSample + 1) % WINDOW_SIZE;
+			sampleCount = (std::min)(sampleCount + 1, WINDOW_SIZE);
+			totalSamples++;
+
+			// Clock filter: trust the least delayed sample in the window
+			const Sample* best = &samples[0];
+			for (size_t i = 1; i < sampleCount; ++i)
+			{
+				if (samples[i].rttUs < best->rttUs)
+					best = &samples[i];
+			}
+			offsetUs = best->offsetUs;
+
+			// Smoothed RTT and jitter (RFC 6298 / RFC 3550 gains)
+			if (totalSamples == 1)
+			{
+				smoothedRttUs = static_cast<int64_t>(sample.rttUs);
+				jitterUs = 0;
+			}
+			else
+			{
+				const int64_t delta = static_cast<int64_t>(sample.rttUs) - lastRttUs;
+				jitterUs += (std::llabs(delta) - jitterUs) / 16;
+				smoothedRttUs += (static_cast<int64_t>(sample.rttUs) - smoothedRttUs) / 8;
+			}
+			lastRttUs = static_cast<int64_t>(sample.rttUs);
+
+			return true;
+		}
+
+		void reset()
+		{
+			*this = ClockSyncEstimator();
+		}
+
+		bool isSynchronized() const
+		{
+			return totalSamples >= MIN_SAMPLES;
+		}
+
+		// Server clock minus client clock
+		int64_t getOffsetUs() const
+		{
+			return offsetUs;
+		}
+
+		uint64_t getRttUs() const
+		{
+			return static_cast<uint64_t>(smoothedRttUs);
+		}
+
+		uint64_t getJitterUs() const
+		{
+			return static_cast<uint64_t>(jitterUs);
+		}
+
+		uint64_t toServerTime(uint64_t clientTimeUs) const
+		{
+			return static_cast<uint64_t>(static_cast<int64_t>(clientTimeUs) + offsetUs);
+		}
+
+		uint64_t toClientTime(uint64_t serverTimeUs) const
+		{
+			return static_cast<uint64_t>(static_cast<int64_t>(serverTimeUs) - offsetUs);
+		}
+
+		size_t getSampleCount() const
+		{
+			return totalSamples;
+		}
+
+		size_t getRejectedSampleCount() const
+		{
+			return rejectedSamples;
+		}
+
+	private:
+		struct Sample
+		{
+			int64_t offsetUs = 0;
+			uint64_t rttUs = 0;
+		};
+
+		std::array<Sample, WINDOW_SIZE> samples{};
+		size_t nextSample = 0;
+		size_t sampleCount = 0;
+		size_t totalSamples = 0;
+		size_t rejectedSamples = 0;
+
+		int64_t offsetUs = 0;
+		int64_t smoothedRttUs = 0;
+		int64_t lastRttUs = 0;
+		int64_t jitterUs = 0;
+	};
+
+} // namespace GameProtocol
@@ -19,7 +19,14 @@ namespace GameProtocol
 	inline constexpr uint32_t PACKET_MAGIC = 0x47535256;
 
 	// Current protocol version
-	inline constexpr uint16_t PACKET_PROTOCOL_VERSION = 1;
+	inline constexpr uint16_t PACKET_PROTOCOL_VERSION = 3;
+
+	// ENet channels (hosts are created with 4 channels)
+	enum class Channel : uint8_t
+	{
+		Realtime = 0, // Gameplay, chat and world state
+		Bulk = 1      // Large reliable streams, sequenced independently of realtime traffic
+	};
 
 	// Packet types
 	enum class PacketType : uint8_t
@@ -27,6 +34,10 @@ namespace GameProtocol
 		// System packets
 		Heartbeat = 0x00,
 		Disconnect = 0x01,
+		Ping = 0x02,        // Time sync request
+		Pong = 0x03,        // Time sync reply with server timestamps
+		KeyExchange = 0x04, // Secure channel handshake (X25519 public key)
+		Encrypted = 0x05,   // AEAD-sealed packet, unwrapped by PacketManager
 
 		// Authentication packets
 		AuthRequest = 0x10,
@@ -48,6 +59,10 @@ namespace GameProtocol
 
 		// World state
 		WorldState = 0x50,
+		CompactWorldState = 0x51, // Bit-packed WorldState encoding
+
+		// Bulk streaming
+		BulkData = 0x60,
 
 		// Maximum value (for validation)
 		MaxValue = 0xFF
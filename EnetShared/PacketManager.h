@@ -1,14 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <enet/enet.h>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Logger.h"
 #include "PacketHeader.h"
 #include "PacketTypes.h"
+#include "SecureChannel.h"
 
 class PacketManager
 {
@@ -16,23 +21,57 @@ public:
 	PacketManager() = default;
 
 	// Send a packet to a peer
-	void sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable, std::function<void(size_t)> statsCallback = nullptr)
+	void sendPacket(ENetPeer* peer, const GameProtocol::Packet& packet, bool reliable, std::function<void(size_t)> statsCallback = nullptr, GameProtocol::Channel channel = GameProtocol::Channel::Realtime)
 	{
 		if (!peer)
 			return;
 
 		logger.trace("Sending packet of type: " + GameProtocol::getPacketTypeName(packet.getType()));
 
-		// Serialize the packet
-		std::vector<uint8_t> data = packet.serialize();
+		sendSerialized(peer, packet.serialize(), packet.getType(), reliable, std::move(statsCallback), channel);
+	}
+
+	// Send an already serialized packet, e.g. one that was queued while disconnected
+	void sendSerialized(ENetPeer* peer, std::vector<uint8_t> data, GameProtocol::PacketType type, bool reliable, std::function<void(size_t)> statsCallback = nullptr, GameProtocol::Channel channel = GameProtocol::Channel::Realtime)
+	{
+		if (!peer)
+			return;
+
+		// Seal it if this peer has completed a key exchange
+		if (auto secure = getSecureChannel(peer))
+		{
+			std::vector<uint8_t> sealed;
+			if (!secure->seal(data, sealed, channel, reliable))
+			{
+				logger.warning("Failed to encrypt packet of type: " + GameProtocol::getPacketTypeName(type));
+				return;
+			}
+			data.swap(sealed);
+		}
+
+		// Another thread owns the host, leave the ENet calls to it
+		if (deferredSends)
+		{
+			const size_t size = data.size();
+			{
+				std::lock_guard<std::mutex> lock(outboxMutex);
+				outbox.push_back({ peer, std::move(data), reliable ? static_cast<enet_uint32>(ENET_PACKET_FLAG_RELIABLE) : 0u, channel, type });
+			}
+
+			if (statsCallback)
+			{
+				statsCallback(size);
+			}
+			return;
+		}
 
 		// Create and send ENet packet
-		ENetPacket* enetPacket = enet_packet_create(data.data(), data.size(), reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+		ENetPacket* enetPacket = enet_packet_create(data.data(), data.size(), reliable ? static_cast<enet_uint32>(ENET_PACKET_FLAG_RELIABLE) : 0u);
 
-		if (enet_peer_send(peer, 0, enetPacket) < 0)
+		if (enet_peer_send(peer, static_cast<enet_uint8>(channel), enetPacket) < 0)
 		{
 			// Send failed, clean up
-			logger.warning("Failed to send packet of type: " + GameProtocol::getPacketTypeName(packet.getType()));
+			logger.warning("Failed to send packet of type: " + GameProtocol::getPacketTypeName(type));
 			enet_packet_destroy(enetPacket);
 			return;
 		}
@@ -41,10 +80,11 @@ public:
 		if (statsCallback)
 		{
 			statsCallback(data.size());
-		}}
+		}
+	}
 
-	// Receive and process a packet
-	std::unique_ptr<GameProtocol::Packet> receivePacket(const ENetPacket* packet)
+	// Receive and process a packet, unwrapping it if it came from a peer with a secure channel
+	std::unique_ptr<GameProtocol::Packet> receivePacket(const ENetPacket* packet, ENetPeer* peer = nullptr)
 	{
 		if (!packet || packet->dataLength < sizeof(GameProtocol::PacketHeader))
 		{
@@ -54,6 +94,38 @@ public:
 		// Create a span from the packet data
 		std::span<const uint8_t> data(static_cast<const uint8_t*>(packet->data), packet->dataLength);
 
+		auto secure = peer ? getSecureChannel(peer) : nullptr;
+		const auto type = reinterpret_cast<const GameProtocol::PacketHeader*>(data.data())->type;
+
+		std::vector<uint8_t> opened;
+		if (type == GameProtocol::PacketType::Encrypted)
+		{
+			if (!secure || !secure->open(data, opened))
+			{
+				logger.warning("Dropped encrypted packet that failed to authenticate");
+				return nullptr;
+			}
+
+			// Handshakes and nested envelopes are never valid inside the channel
+			data = opened;
+			if (data.size() < sizeof(GameProtocol::PacketHeader))
+			{
+				return nullptr;
+			}
+
+			const auto innerType = reinterpret_cast<const GameProtocol::PacketHeader*>(data.data())->type;
+			if (innerType == GameProtocol::PacketType::Encrypted || innerType == GameProtocol::PacketType::KeyExchange)
+			{
+				return nullptr;
+			}
+		}
+		else if (secure)
+		{
+			// Once a channel is up, plaintext could only be injected or downgraded traffic
+			logger.warning("Dropped plaintext " + GameProtocol::getPacketTypeName(type) + " packet on a secure channel");
+			return nullptr;
+		}
+
 		// Deserialize the packet
 		auto result = GameProtocol::deserializePacket(data);
 
@@ -133,6 +205,105 @@ public:
 		return std::make_shared<GameProtocol::HeartbeatPacket>(clientTime);
 	}
 
+	static std::shared_ptr<GameProtocol::PingPacket> createPing(uint32_t sequence, uint64_t clientSendTime)
+	{
+		return std::make_shared<GameProtocol::PingPacket>(sequence, clientSendTime);
+	}
+
+	static std::shared_ptr<GameProtocol::PongPacket> createPong(const GameProtocol::PingPacket& ping, uint64_t serverReceiveTime, uint64_t serverSendTime)
+	{
+		return std::make_shared<GameProtocol::PongPacket>(ping, serverReceiveTime, serverSendTime);
+	}
+
+	static std::shared_ptr<GameProtocol::KeyExchangePacket> createKeyExchange(bool accepted, const std::array<uint8_t, 32>& publicKey = {})
+	{
+		return std::make_shared<GameProtocol::KeyExchangePacket>(accepted, publicKey);
+	}
+
+	// Secure channels, keyed by peer; register only once the key exchange has completed
+	void setSecureChannel(ENetPeer* peer, std::shared_ptr<GameProtocol::SecureChannel> channel)
+	{
+		std::unique_lock lock(secureChannelsMutex);
+		secureChannels[peer] = std::move(channel);
+	}
+
+	void removeSecureChannel(ENetPeer* peer)
+	{
+		std::unique_lock lock(secureChannelsMutex);
+		secureChannels.erase(peer);
+	}
+
+	std::shared_ptr<GameProtocol::SecureChannel> getSecureChannel(ENetPeer* peer) const
+	{
+		std::shared_lock lock(secureChannelsMutex);
+		auto it = secureChannels.find(peer);
+		return it != secureChannels.end() ? it->second : nullptr;
+	}
+
+	size_t getSecureChannelCount() const
+	{
+		std::shared_lock lock(secureChannelsMutex);
+		return secureChannels.size();
+	}
+
+	// Deferred sends: packets are serialized (and sealed) on the calling thread and queued,
+	// the thread that owns the ENet host hands them to ENet with flushDeferredSends()
+	void setDeferredSends(bool enabled)
+	{
+		deferredSends = enabled;
+	}
+
+	bool isDeferringSends() const
+	{
+		return deferredSends;
+	}
+
+	// Must be called by the thread that owns the ENet host; returns the number of packets sent
+	size_t flushDeferredSends()
+	{
+		{
+			std::lock_guard<std::mutex> lock(outboxMutex);
+			if (outbox.empty())
+			{
+				return 0;
+			}
+			outbox.swap(flushing);
+		}
+
+		size_t sent = 0;
+		for (auto& pending: flushing)
+		{
+			ENetPacket* enetPacket = enet_packet_create(pending.data.data(), pending.data.size(), pending.flags);
+			if (enet_peer_send(pending.peer, static_cast<enet_uint8>(pending.channel), enetPacket) < 0)
+			{
+				logger.warning("Failed to send packet of type: " + GameProtocol::getPacketTypeName(pending.type));
+				enet_packet_destroy(enetPacket);
+				continue;
+			}
+			sent++;
+		}
+
+		flushing.clear();
+		return sent;
+	}
+
 private:
+	struct PendingSend
+	{
+		ENetPeer* peer;
+		std::vector<uint8_t> data;
+		enet_uint32 flags;
+		GameProtocol::Channel channel;
+		GameProtocol::PacketType type;
+	};
+
 	Logger& logger = Logger::getInstance();
+
+	std::atomic<bool> deferredSends{ false };
+	std::mutex outboxMutex;
+	std::vector<PendingSend> outbox;
+	std::vector<PendingSend> flushing; // Only touched by the host owner
+
+	mutable std::shared_mutex secureChannelsMutex;
+	std::unordered_map<ENetPeer*, std::shared_ptr<GameProtocol::SecureChannel>> secureChannels;
 };
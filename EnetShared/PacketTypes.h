@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <memory_resource>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "BitStream.h"
 #include "PacketHeader.h"
 
 namespace GameProtocol
@@ -494,22 +499,88 @@ namespace GameProtocol
 			SerializablePosition position;
 		};
 
+		// Borrowed view of a player, for encoding straight from server state without copying names
+		struct PlayerView
+		{
+			uint32_t id;
+			std::string_view name;
+			SerializablePosition position;
+		};
+
+		// Quantization used by the compact encoding (~8mm precision over +-4096 units)
+		static constexpr FixedPointRange POSITION_RANGE{ -4096.0f, 4096.0f, 20 };
+
+		// Position precision the compact encoding accepts; the writer and reader both clamp to it
+		static constexpr uint8_t MIN_POSITION_BITS = 8;
+		static constexpr uint8_t MAX_POSITION_BITS = 24;
+
+		// Fixed per-packet overhead used when sizing chunks (header + snapshot fields + count)
+		static constexpr size_t CHUNK_OVERHEAD_BYTES = sizeof(PacketHeader) + 16;
+
 		std::vector<PlayerInfo> players;
 
+		// Snapshot this packet belongs to; large snapshots are split into independently decodable chunks
+		uint32_t snapshotId = 0;
+		uint16_t chunkIndex = 0;
+		uint16_t chunkCount = 1;
+
+		// Opt into the bit-packed encoding (sent as PacketType::CompactWorldState)
+		bool compact = false;
+
+		// Bits per position axis in the compact encoding; fewer bits trade precision for size
+		uint8_t positionBits = static_cast<uint8_t>(POSITION_RANGE.bits);
+
 		WorldStatePacket() = default;
 
+		static uint8_t clampPositionBits(uint32_t bits)
+		{
+			return static_cast<uint8_t>(std::clamp<uint32_t>(bits, MIN_POSITION_BITS, MAX_POSITION_BITS));
+		}
+
+		FixedPointRange getPositionRange() const
+		{
+			return FixedPointRange{ POSITION_RANGE.min, POSITION_RANGE.max, positionBits };
+		}
+
 		PacketType getType() const override
 		{
-			return PacketType::WorldState;
+			return compact ? PacketType::CompactWorldState : PacketType::WorldState;
 		}
 
 		std::vector<uint8_t> serialize() const override
 		{
 			std::vector<uint8_t> buffer;
+			encode(buffer, std::span<const PlayerInfo>(players), snapshotId, chunkIndex, chunkCount, compact, positionBits);
+			return buffer;
+		}
+
+		// Write one chunk of PlayerInfo or PlayerView entries into buffer; scratch backs the temporary position arrays
+		template <typename Entry>
+		static void encode(std::vector<uint8_t>& buffer, std::span<const Entry> players, uint32_t snapshotId, uint16_t chunkIndex, uint16_t chunkCount, bool compact, uint8_t positionBits,
+		        std::pmr::memory_resource* scratch = std::pmr::get_default_resource())
+		{
+			if (compact)
+			{
+				encodeCompact(buffer, players, snapshotId, chunkIndex, chunkCount, positionBits, scratch);
+				return;
+			}
+
+			buffer.clear();
+
+			// Size the buffer once up front
+			size_t totalBytes = CHUNK_OVERHEAD_BYTES;
+			for (const auto& player: players)
+				totalBytes += estimatePlayerSize(player, false, 0);
+			buffer.reserve(totalBytes);
 
 			// Reserve space for header
 			buffer.resize(sizeof(PacketHeader));
 
+			// Write snapshot info
+			writeToBuffer(buffer, snapshotId);
+			writeToBuffer(buffer, chunkIndex);
+			writeToBuffer(buffer, chunkCount);
+
 			// Write number of players
 			uint16_t playerCount = static_cast<uint16_t>(players.size());
 			writeToBuffer(buffer, playerCount);
@@ -523,10 +594,8 @@ namespace GameProtocol
 			}
 
 			// Fill header
-			PacketHeader header(getType(), buffer.size() - sizeof(PacketHeader));
+			PacketHeader header(PacketType::WorldState, buffer.size() - sizeof(PacketHeader));
 			std::memcpy(buffer.data(), &header, sizeof(header));
-
-			return buffer;
 		}
 
 		static WorldStatePacket deserialize(std::span<const uint8_t> data)
@@ -537,6 +606,11 @@ namespace GameProtocol
 			// Read payload
 			WorldStatePacket packet;
 
+			// Read snapshot info
+			packet.snapshotId = readFromBuffer<uint32_t>(data);
+			packet.chunkIndex = readFromBuffer<uint16_t>(data);
+			packet.chunkCount = readFromBuffer<uint16_t>(data);
+
 			// Read player count
 			uint16_t playerCount = readFromBuffer<uint16_t>(data);
 
@@ -553,6 +627,282 @@ namespace GameProtocol
 
 			return packet;
 		}
+
+		std::vector<uint8_t> serializeCompact() const
+		{
+			std::vector<uint8_t> buffer;
+			encodeCompact(buffer, std::span<const PlayerInfo>(players), snapshotId, chunkIndex, chunkCount, positionBits);
+			return buffer;
+		}
+
+		// Compact layout: varint count, zigzag id deltas, names, then x/y/z as quantized arrays
+		template <typename Entry>
+		static void encodeCompact(std::vector<uint8_t>& buffer, std::span<const Entry> players, uint32_t snapshotId, uint16_t chunkIndex, uint16_t chunkCount, uint8_t positionBits,
+		        std::pmr::memory_resource* scratch = std::pmr::get_default_resource())
+		{
+			// Anything else would not survive the 5-bit field and the reader's clamp
+			positionBits = clampPositionBits(positionBits);
+
+			buffer.clear();
+
+			// Size the buffer once up front
+			size_t totalBytes = CHUNK_OVERHEAD_BYTES;
+			for (const auto& player: players)
+				totalBytes += estimatePlayerSize(player, true, 0, positionBits);
+			buffer.reserve(totalBytes);
+
+			// Reserve space for header
+			buffer.resize(sizeof(PacketHeader));
+
+			BitWriter writer(buffer);
+			writer.writeVarUint(snapshotId);
+			writer.writeVarUint(chunkIndex);
+			writer.writeVarUint(chunkCount);
+			writer.writeBits(positionBits, 5);
+			writer.writeVarUint(static_cast<uint32_t>(players.size()));
+
+			// Ids are usually ascending, so deltas fit in a byte
+			uint32_t previousId = 0;
+			for (const auto& player: players)
+			{
+				writer.writeVarInt(static_cast<int32_t>(player.id - previousId));
+				previousId = player.id;
+			}
+
+			for (const auto& player: players)
+			{
+				writer.writeString(player.name);
+			}
+
+			// Structure-of-arrays positions for bulk quantization
+			const FixedPointRange range{ POSITION_RANGE.min, POSITION_RANGE.max, positionBits };
+			std::pmr::vector<float> axis(players.size(), scratch);
+			for (size_t i = 0; i < players.size(); ++i)
+				axis[i] = players[i].position.x;
+			writer.writeFixedArray(axis, range);
+			for (size_t i = 0; i < players.size(); ++i)
+				axis[i] = players[i].position.y;
+			writer.writeFixedArray(axis, range);
+			for (size_t i = 0; i < players.size(); ++i)
+				axis[i] = players[i].position.z;
+			writer.writeFixedArray(axis, range);
+
+			writer.flush();
+
+			// Fill header
+			PacketHeader header(PacketType::CompactWorldState, buffer.size() - sizeof(PacketHeader));
+			std::memcpy(buffer.data(), &header, sizeof(header));
+		}
+
+		static WorldStatePacket deserializeCompact(std::span<const uint8_t> data)
+		{
+			// Skip header
+			data = data.subspan(sizeof(PacketHeader));
+
+			WorldStatePacket packet;
+			packet.compact = true;
+
+			BitReader reader(data);
+			packet.snapshotId = reader.readVarUint();
+			packet.chunkIndex = static_cast<uint16_t>(reader.readVarUint());
+			packet.chunkCount = static_cast<uint16_t>(reader.readVarUint());
+			packet.positionBits = clampPositionBits(reader.readBits(5));
+			uint32_t playerCount = reader.readVarUint();
+
+			// Every player needs at least a delta byte, a length byte and three positions
+			const FixedPointRange range = packet.getPositionRange();
+			const size_t minBitsPerPlayer = 16 + 3 * range.bits;
+			if (reader.hasOverflowed() || playerCount > reader.getBitsRemaining() / minBitsPerPlayer)
+			{
+				return packet;
+			}
+
+			packet.players.resize(playerCount);
+
+			uint32_t previousId = 0;
+			for (auto& player: packet.players)
+			{
+				player.id = previousId + static_cast<uint32_t>(reader.readVarInt());
+				previousId = player.id;
+			}
+
+			for (auto& player: packet.players)
+			{
+				player.name = reader.readString();
+			}
+
+			std::vector<float> axis(playerCount);
+			reader.readFixedArray(axis, range);
+			for (uint32_t i = 0; i < playerCount; ++i)
+				packet.players[i].position.x = axis[i];
+			reader.readFixedArray(axis, range);
+			for (uint32_t i = 0; i < playerCount; ++i)
+				packet.players[i].position.y = axis[i];
+			reader.readFixedArray(axis, range);
+			for (uint32_t i = 0; i < playerCount; ++i)
+				packet.players[i].position.z = axis[i];
+
+			if (reader.hasOverflowed())
+			{
+				packet.players.clear();
+			}
+
+			return packet;
+		}
+
+		// Upper bound on the bytes one player adds to a chunk
+		template <typename Entry>
+		static size_t estimatePlayerSize(const Entry& player, bool compact, uint32_t previousId, uint8_t positionBits = static_cast<uint8_t>(POSITION_RANGE.bits))
+		{
+			if (compact)
+			{
+				// Id delta and length varints, plus three quantized axes rounded up to whole bytes
+				return varUintSize(zigzagEncode(static_cast<int32_t>(player.id - previousId))) + varUintSize(static_cast<uint32_t>(player.name.size())) + player.name.size() + (3 * clampPositionBits(positionBits) + 7) / 8;
+			}
+
+			return sizeof(uint32_t) + sizeof(uint16_t) + player.name.size() + sizeof(SerializablePosition);
+		}
+
+		// Append the index of the first player of every chunk that fits in maxPacketBytes; always at least one
+		template <typename Entry>
+		static void findChunkStarts(std::span<const Entry> players, size_t maxPacketBytes, bool compact, uint8_t positionBits, std::pmr::vector<size_t>& starts)
+		{
+			starts.push_back(0);
+
+			size_t chunkBytes = CHUNK_OVERHEAD_BYTES;
+			uint32_t previousId = 0;
+			for (size_t i = 0; i < players.size(); ++i)
+			{
+				size_t playerBytes = estimatePlayerSize(players[i], compact, previousId, positionBits);
+				if (i > starts.back() && (chunkBytes + playerBytes > maxPacketBytes || i - starts.back() >= UINT16_MAX))
+				{
+					// Id deltas restart at zero in every chunk
+					starts.push_back(i);
+					chunkBytes = CHUNK_OVERHEAD_BYTES;
+					playerBytes = estimatePlayerSize(players[i], compact, 0, positionBits);
+				}
+
+				previousId = players[i].id;
+				chunkBytes += playerBytes;
+			}
+		}
+
+		// Split a snapshot into chunks that each fit in maxPacketBytes; always returns at least one chunk
+		static std::vector<WorldStatePacket> splitIntoChunks(std::vector<PlayerInfo> players, size_t maxPacketBytes, bool compact, uint32_t snapshotId, uint8_t positionBits = static_cast<uint8_t>(POSITION_RANGE.bits))
+		{
+			std::pmr::vector<size_t> starts;
+			findChunkStarts(std::span<const PlayerInfo>(players), maxPacketBytes, compact, positionBits, starts);
+
+			std::vector<WorldStatePacket> chunks(starts.size());
+			const uint16_t count = static_cast<uint16_t>(std::min<size_t>(chunks.size(), UINT16_MAX));
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				const size_t end = i + 1 < starts.size() ? starts[i + 1] : players.size();
+				chunks[i].players.assign(std::make_move_iterator(players.begin() + starts[i]), std::make_move_iterator(players.begin() + end));
+				chunks[i].snapshotId = snapshotId;
+				chunks[i].chunkIndex = static_cast<uint16_t>(i);
+				chunks[i].chunkCount = count;
+				chunks[i].compact = compact;
+				chunks[i].positionBits = positionBits;
+			}
+
+			return chunks;
+		}
+
+		// Encode a snapshot straight to wire chunks without building packet objects; only the returned buffers touch the heap
+		// when scratch is an arena
+		template <typename Entry>
+		static std::vector<std::vector<uint8_t>> encodeChunks(std::span<const Entry> players, size_t maxPacketBytes, bool compact, uint32_t snapshotId, uint8_t positionBits,
+		        std::pmr::memory_resource* scratch = std::pmr::get_default_resource())
+		{
+			std::pmr::vector<size_t> starts(scratch);
+			findChunkStarts(players, maxPacketBytes, compact, positionBits, starts);
+
+			std::vector<std::vector<uint8_t>> chunks(starts.size());
+			const uint16_t count = static_cast<uint16_t>(std::min<size_t>(chunks.size(), UINT16_MAX));
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				const size_t end = i + 1 < starts.size() ? starts[i + 1] : players.size();
+				encode(chunks[i], players.subspan(starts[i], end - starts[i]), snapshotId, static_cast<uint16_t>(i), count, compact, positionBits, scratch);
+			}
+
+			return chunks;
+		}
+	};
+
+	// Kind of payload carried by a bulk stream
+	enum class BulkStreamKind : uint8_t
+	{
+		ChatBackfill = 0, // Recent chat history for a newly joined player
+		WorldSync = 1     // Full world state for initial synchronization
+	};
+
+	// One chunk of a bulk stream; the reassembled payload is a sequence of serialized packets
+	class BulkDataPacket : public Packet
+	{
+	public:
+		uint32_t streamId = 0;
+		BulkStreamKind kind = BulkStreamKind::ChatBackfill;
+		uint16_t chunkIndex = 0;
+		uint16_t chunkCount = 1;
+		std::vector<uint8_t> payload;
+
+		// The payload length goes on the wire as a uint16_t
+		static constexpr size_t MAX_PAYLOAD_BYTES = UINT16_MAX;
+
+		BulkDataPacket() = default;
+
+		PacketType getType() const override
+		{
+			return PacketType::BulkData;
+		}
+
+		std::vector<uint8_t> serialize() const override
+		{
+			// A truncated length would make the receiver misread everything after it
+			if (payload.size() > MAX_PAYLOAD_BYTES)
+			{
+				throw std::length_error("Bulk chunk payload of " + std::to_string(payload.size()) + " bytes exceeds " + std::to_string(MAX_PAYLOAD_BYTES));
+			}
+
+			std::vector<uint8_t> buffer;
+
+			// Reserve space for header
+			buffer.resize(sizeof(PacketHeader));
+
+			// Write payload
+			writeToBuffer(buffer, streamId);
+			writeToBuffer(buffer, kind);
+			writeToBuffer(buffer, chunkIndex);
+			writeToBuffer(buffer, chunkCount);
+			uint16_t payloadSize = static_cast<uint16_t>(payload.size());
+			writeToBuffer(buffer, payloadSize);
+			buffer.insert(buffer.end(), payload.begin(), payload.end());
+
+			// Fill header
+			PacketHeader header(getType(), buffer.size() - sizeof(PacketHeader));
+			std::memcpy(buffer.data(), &header, sizeof(header));
+
+			return buffer;
+		}
+
+		static BulkDataPacket deserialize(std::span<const uint8_t> data)
+		{
+			// Skip header
+			data = data.subspan(sizeof(PacketHeader));
+
+			// Read payload
+			BulkDataPacket packet;
+			packet.streamId = readFromBuffer<uint32_t>(data);
+			packet.kind = readFromBuffer<BulkStreamKind>(data);
+			packet.chunkIndex = readFromBuffer<uint16_t>(data);
+			packet.chunkCount = readFromBuffer<uint16_t>(data);
+			uint16_t payloadSize = readFromBuffer<uint16_t>(data);
+			payloadSize = static_cast<uint16_t>(std::min<size_t>(payloadSize, data.size()));
+			packet.payload.assign(data.begin(), data.begin() + payloadSize);
+
+			return packet;
+		}
 	};
 
 	class HeartbeatPacket : public GameProtocol::Packet
@@ -602,6 +952,182 @@ namespace GameProtocol
 		}
 	};
 
+	// Time sync request; the server echoes sequence and clientSendTime back in a Pong
+	class PingPacket : public GameProtocol::Packet
+	{
+	public:
+		uint32_t sequence = 0;
+		uint64_t clientSendTime = 0; // Client clock, microseconds
+
+		PingPacket() = default;
+
+		PingPacket(uint32_t sequence, uint64_t clientSendTime)
+		      : sequence(sequence), clientSendTime(clientSendTime)
+		{
+		}
+
+		GameProtocol::PacketType getType() const override
+		{
+			return GameProtocol::PacketType::Ping;
+		}
+
+		std::vector<uint8_t> serialize() const override
+		{
+			std::vector<uint8_t> buffer;
+
+			// Reserve space for header
+			buffer.resize(sizeof(GameProtocol::PacketHeader));
+
+			// Write payload
+			GameProtocol::writeToBuffer(buffer, sequence);
+			GameProtocol::writeToBuffer(buffer, clientSendTime);
+
+			// Fill header
+			GameProtocol::PacketHeader header(getType(), buffer.size() - sizeof(GameProtocol::PacketHeader));
+			std::memcpy(buffer.data(), &header, sizeof(header));
+
+			return buffer;
+		}
+
+		static PingPacket deserialize(std::span<const uint8_t> data)
+		{
+			// Truncated pings come back empty
+			PingPacket packet;
+			if (data.size() < sizeof(GameProtocol::PacketHeader) + 12)
+			{
+				return packet;
+			}
+
+			// Skip header
+			data = data.subspan(sizeof(GameProtocol::PacketHeader));
+
+			// Read payload
+			packet.sequence = GameProtocol::readFromBuffer<uint32_t>(data);
+			packet.clientSendTime = GameProtocol::readFromBuffer<uint64_t>(data);
+
+			return packet;
+		}
+	};
+
+	// Time sync reply carrying the four NTP timestamps (client send, server receive, server send; client receive is local)
+	class PongPacket : public GameProtocol::Packet
+	{
+	public:
+		uint32_t sequence = 0;
+		uint64_t clientSendTime = 0;    // Echoed from the Ping, client clock
+		uint64_t serverReceiveTime = 0; // Server clock, microseconds
+		uint64_t serverSendTime = 0;    // Server clock, microseconds
+
+		PongPacket() = default;
+
+		PongPacket(const PingPacket& ping, uint64_t serverReceiveTime, uint64_t serverSendTime)
+		      : sequence(ping.sequence), clientSendTime(ping.clientSendTime), serverReceiveTime(serverReceiveTime), serverSendTime(serverSendTime)
+		{
+		}
+
+		GameProtocol::PacketType getType() const override
+		{
+			return GameProtocol::PacketType::Pong;
+		}
+
+		std::vector<uint8_t> serialize() const override
+		{
+			std::vector<uint8_t> buffer;
+
+			// Reserve space for header
+			buffer.resize(sizeof(GameProtocol::PacketHeader));
+
+			// Write payload
+			GameProtocol::writeToBuffer(buffer, sequence);
+			GameProtocol::writeToBuffer(buffer, clientSendTime);
+			GameProtocol::writeToBuffer(buffer, serverReceiveTime);
+			GameProtocol::writeToBuffer(buffer, serverSendTime);
+
+			// Fill header
+			GameProtocol::PacketHeader header(getType(), buffer.size() - sizeof(GameProtocol::PacketHeader));
+			std::memcpy(buffer.data(), &header, sizeof(header));
+
+			return buffer;
+		}
+
+		static PongPacket deserialize(std::span<const uint8_t> data)
+		{
+			// Truncated pongs come back empty, which the client discards
+			PongPacket packet;
+			if (data.size() < sizeof(GameProtocol::PacketHeader) + 28)
+			{
+				return packet;
+			}
+
+			// Skip header
+			data = data.subspan(sizeof(GameProtocol::PacketHeader));
+
+			// Read payload
+			packet.sequence = GameProtocol::readFromBuffer<uint32_t>(data);
+			packet.clientSendTime = GameProtocol::readFromBuffer<uint64_t>(data);
+			packet.serverReceiveTime = GameProtocol::readFromBuffer<uint64_t>(data);
+			packet.serverSendTime = GameProtocol::readFromBuffer<uint64_t>(data);
+
+			return packet;
+		}
+	};
+
+	// Secure channel handshake; the client sends its ephemeral public key, the server replies with its own or declines
+	class KeyExchangePacket : public GameProtocol::Packet
+	{
+	public:
+		bool accepted = true;
+		std::array<uint8_t, 32> publicKey{};
+
+		KeyExchangePacket() = default;
+
+		KeyExchangePacket(bool accepted, const std::array<uint8_t, 32>& publicKey)
+		      : accepted(accepted), publicKey(publicKey)
+		{
+		}
+
+		GameProtocol::PacketType getType() const override
+		{
+			return GameProtocol::PacketType::KeyExchange;
+		}
+
+		std::vector<uint8_t> serialize() const override
+		{
+			std::vector<uint8_t> buffer;
+
+			// Reserve space for header
+			buffer.resize(sizeof(GameProtocol::PacketHeader));
+
+			// Write payload
+			GameProtocol::writeToBuffer(buffer, accepted);
+			GameProtocol::writeToBuffer(buffer, publicKey);
+
+			// Fill header
+			GameProtocol::PacketHeader header(getType(), buffer.size() - sizeof(GameProtocol::PacketHeader));
+			std::memcpy(buffer.data(), &header, sizeof(header));
+
+			return buffer;
+		}
+
+		static KeyExchangePacket deserialize(std::span<const uint8_t> data)
+		{
+			// Skip header
+			data = data.subspan(sizeof(GameProtocol::PacketHeader));
+
+			// Read payload
+			KeyExchangePacket packet;
+			if (data.size() < sizeof(bool) + packet.publicKey.size())
+			{
+				packet.accepted = false;
+				return packet;
+			}
+			packet.accepted = GameProtocol::readFromBuffer<bool>(data);
+			packet.publicKey = GameProtocol::readFromBuffer<std::array<uint8_t, 32>>(data);
+
+			return packet;
+		}
+	};
+
 	// Function to deserialize a packet based on its type
 	inline std::unique_ptr<Packet> deserializePacket(std::span<const uint8_t> data)
 	{
@@ -648,9 +1174,24 @@ namespace GameProtocol
 			case PacketType::WorldState:
 				return std::make_unique<WorldStatePacket>(WorldStatePacket::deserialize(data));
 
+			case PacketType::CompactWorldState:
+				return std::make_unique<WorldStatePacket>(WorldStatePacket::deserializeCompact(data));
+
 			case PacketType::Heartbeat:
 				return std::make_unique<HeartbeatPacket>(HeartbeatPacket::deserialize(data));
 
+			case PacketType::Ping:
+				return std::make_unique<PingPacket>(PingPacket::deserialize(data));
+
+			case PacketType::Pong:
+				return std::make_unique<PongPacket>(PongPacket::deserialize(data));
+
+			case PacketType::KeyExchange:
+				return std::make_unique<KeyExchangePacket>(KeyExchangePacket::deserialize(data));
+
+			case PacketType::BulkData:
+				return std::make_unique<BulkDataPacket>(BulkDataPacket::deserialize(data));
+
 			default:
 				return nullptr;
 		}
@@ -664,6 +1205,14 @@ namespace GameProtocol
 				return "Heartbeat";
 			case PacketType::Disconnect:
 				return "Disconnect";
+			case PacketType::Ping:
+				return "Ping";
+			case PacketType::Pong:
+				return "Pong";
+			case PacketType::KeyExchange:
+				return "KeyExchange";
+			case PacketType::Encrypted:
+				return "Encrypted";
 			case PacketType::AuthRequest:
 				return "AuthRequest";
 			case PacketType::AuthResponse:
@@ -686,6 +1235,10 @@ namespace GameProtocol
 				return "Command";
 			case PacketType::WorldState:
 				return "WorldState";
+			case PacketType::CompactWorldState:
+				return "CompactWorldState";
+			case PacketType::BulkData:
+				return "BulkData";
 			default:
 				return "Unknown";
 		}
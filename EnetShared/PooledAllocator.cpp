@@ -0,0 +1,310 @@
+#include "PooledAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace
+{
+	constexpr size_t HEADER_SIZE = 16; // Keeps payloads 16-byte aligned
+	constexpr size_t CLASS_COUNT = 9;  // 32 bytes to 8 KB, doubling
+	constexpr uint32_t LARGE_CLASS = 0xFFFFFFFF;
+	constexpr size_t CACHE_LIMIT = 128;   // Blocks a thread keeps per class before handing some back
+	constexpr size_t TRANSFER_BATCH = 32; // Blocks moved between a thread and the shared pool at once
+	constexpr size_t SLAB_BYTES = 64 * 1024;
+
+	constexpr size_t classSize(size_t sizeClass)
+	{
+		return size_t(32) << sizeClass;
+	}
+
+	size_t classFor(size_t size)
+	{
+		size_t sizeClass = 0;
+		while (sizeClass < CLASS_COUNT && size > classSize(sizeClass))
+		{
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	uint32_t& classOf(void* payload)
+	{
+		return *reinterpret_cast<uint32_t*>(static_cast<char*>(payload) - HEADER_SIZE);
+	}
+
+	struct ThreadCache;
+
+	struct SharedPool
+	{
+		struct SizeClass
+		{
+			std::mutex mutex;
+			FreeBlock* head = nullptr;
+		};
+
+		SizeClass classes[CLASS_COUNT];
+		std::atomic<uint64_t> bytesReserved{ 0 };
+		std::atomic<uint64_t> cacheMisses{ 0 };
+		std::atomic<uint64_t> largeAllocations{ 0 };
+
+		// Per-thread counters are summed on demand; exited threads leave theirs here
+		std::mutex cachesMutex;
+		std::vector<ThreadCache*> caches;
+		uint64_t retiredAllocations = 0;
+		uint64_t retiredFrees = 0;
+	};
+
+	// Never destroyed, ENet may free after static destructors have started
+	SharedPool& sharedPool()
+	{
+		static SharedPool* pool = new SharedPool;
+		return *pool;
+	}
+
+	// Take up to TRANSFER_BATCH blocks, carving a new slab when the shared list is empty
+	FreeBlock* takeBatch(size_t sizeClass, size_t& taken)
+	{
+		SharedPool& pool = sharedPool();
+		pool.cacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+		FreeBlock* batch = nullptr;
+		taken = 0;
+		{
+			std::lock_guard<std::mutex> lock(pool.classes[sizeClass].mutex);
+			FreeBlock*& head = pool.classes[sizeClass].head;
+			while (head != nullptr && taken < TRANSFER_BATCH)
+			{
+				FreeBlock* block = head;
+				head = block->next;
+				block->next = batch;
+				batch = block;
+				taken++;
+			}
+		}
+		if (taken > 0)
+		{
+			return batch;
+		}
+
+		const size_t blockBytes = HEADER_SIZE + classSize(sizeClass);
+		const size_t blockCount = (std::max)(SLAB_BYTES / blockBytes, size_t(4));
+		char* slab = static_cast<char*>(::operator new(blockBytes * blockCount, std::nothrow));
+		if (slab == nullptr)
+		{
+			return nullptr;
+		}
+		pool.bytesReserved.fetch_add(blockBytes * blockCount, std::memory_order_relaxed);
+
+		for (size_t i = 0; i < blockCount; i++)
+		{
+			void* payload = slab + i * blockBytes + HEADER_SIZE;
+			classOf(payload) = static_cast<uint32_t>(sizeClass);
+			auto* block = static_cast<FreeBlock*>(payload);
+			block->next = batch;
+			batch = block;
+		}
+		taken = blockCount;
+		return batch;
+	}
+
+	void giveBatch(size_t sizeClass, FreeBlock* first, FreeBlock* last)
+	{
+		SharedPool& pool = sharedPool();
+		std::lock_guard<std::mutex> lock(pool.classes[sizeClass].mutex);
+		last->next = pool.classes[sizeClass].head;
+		pool.classes[sizeClass].head = first;
+	}
+
+	struct ThreadCache
+	{
+		FreeBlock* heads[CLASS_COUNT] = {};
+		size_t counts[CLASS_COUNT] = {};
+
+		// Written only by the owning thread, read by getCounters
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> frees{ 0 };
+
+		ThreadCache()
+		{
+			SharedPool& pool = sharedPool();
+			std::lock_guard<std::mutex> lock(pool.cachesMutex);
+			pool.caches.push_back(this);
+		}
+
+		~ThreadCache();
+
+		void* pop(size_t sizeClass)
+		{
+			if (heads[sizeClass] == nullptr)
+			{
+				size_t taken = 0;
+				heads[sizeClass] = takeBatch(sizeClass, taken);
+				counts[sizeClass] = taken;
+				if (heads[sizeClass] == nullptr)
+				{
+					return nullptr;
+				}
+			}
+
+			FreeBlock* block = heads[sizeClass];
+			heads[sizeClass] = block->next;
+			counts[sizeClass]--;
+			return block;
+		}
+
+		void push(size_t sizeClass, void* payload)
+		{
+			auto* block = static_cast<FreeBlock*>(payload);
+			block->next = heads[sizeClass];
+			heads[sizeClass] = block;
+
+			// Packets are freed on the network thread, so its cache keeps filling; pass the surplus on
+			if (++counts[sizeClass] > CACHE_LIMIT)
+			{
+				FreeBlock* first = heads[sizeClass];
+				FreeBlock* last = first;
+				for (size_t i = 1; i < TRANSFER_BATCH; i++)
+				{
+					last = last->next;
+				}
+				heads[sizeClass] = last->next;
+				counts[sizeClass] -= TRANSFER_BATCH;
+				giveBatch(sizeClass, first, last);
+			}
+		}
+
+		static void bump(std::atomic<uint64_t>& counter)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+	};
+
+	thread_local ThreadCache threadCache;
+	thread_local bool threadCacheGone = false; // Set once the cache is destroyed at thread exit
+
+	ThreadCache::~ThreadCache()
+	{
+		for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; sizeClass++)
+		{
+			while (FreeBlock* block = heads[sizeClass])
+			{
+				heads[sizeClass] = block->next;
+				giveBatch(sizeClass, block, block);
+			}
+		}
+
+		SharedPool& pool = sharedPool();
+		std::lock_guard<std::mutex> lock(pool.cachesMutex);
+		pool.retiredAllocations += allocations.load(std::memory_order_relaxed);
+		pool.retiredFrees += frees.load(std::memory_order_relaxed);
+		pool.caches.erase(std::find(pool.caches.begin(), pool.caches.end(), this));
+		threadCacheGone = true;
+	}
+} // namespace
+
+void* PooledAllocator::allocate(size_t size)
+{
+	const size_t sizeClass = classFor(size);
+	if (sizeClass == CLASS_COUNT)
+	{
+		char* block = static_cast<char*>(std::malloc(HEADER_SIZE + size));
+		if (block == nullptr)
+		{
+			return nullptr;
+		}
+		sharedPool().largeAllocations.fetch_add(1, std::memory_order_relaxed);
+		if (!threadCacheGone)
+		{
+			ThreadCache::bump(threadCache.allocations);
+		}
+		void* payload = block + HEADER_SIZE;
+		classOf(payload) = LARGE_CLASS;
+		return payload;
+	}
+
+	if (threadCacheGone)
+	{
+		size_t taken = 0;
+		FreeBlock* batch = takeBatch(sizeClass, taken);
+		if (batch != nullptr && batch->next != nullptr)
+		{
+			FreeBlock* last = batch->next;
+			while (last->next != nullptr)
+			{
+				last = last->next;
+			}
+			giveBatch(sizeClass, batch->next, last);
+		}
+		return batch;
+	}
+
+	ThreadCache::bump(threadCache.allocations);
+	return threadCache.pop(sizeClass);
+}
+
+void PooledAllocator::release(void* memory)
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+
+	const uint32_t sizeClass = classOf(memory);
+	if (sizeClass == LARGE_CLASS)
+	{
+		if (!threadCacheGone)
+		{
+			ThreadCache::bump(threadCache.frees);
+		}
+		std::free(static_cast<char*>(memory) - HEADER_SIZE);
+		return;
+	}
+
+	if (threadCacheGone)
+	{
+		auto* block = static_cast<FreeBlock*>(memory);
+		giveBatch(sizeClass, block, block);
+		return;
+	}
+
+	ThreadCache::bump(threadCache.frees);
+	threadCache.push(sizeClass, memory);
+}
+
+ENetCallbacks PooledAllocator::callbacks()
+{
+	ENetCallbacks callbacks = {};
+	callbacks.malloc = &PooledAllocator::allocate;
+	callbacks.free = &PooledAllocator::release;
+	return callbacks;
+}
+
+PooledAllocator::Counters PooledAllocator::getCounters()
+{
+	SharedPool& pool = sharedPool();
+	Counters counters;
+	{
+		std::lock_guard<std::mutex> lock(pool.cachesMutex);
+		counters.allocations = pool.retiredAllocations;
+		counters.frees = pool.retiredFrees;
+		for (const auto* cache: pool.caches)
+		{
+			counters.allocations += cache->allocations.load(std::memory_order_relaxed);
+			counters.frees += cache->frees.load(std::memory_order_relaxed);
+		}
+	}
+
+	counters.largeAllocations = pool.largeAllocations.load(std::memory_order_relaxed);
+	counters.cacheMisses = pool.cacheMisses.load(std::memory_order_relaxed);
+	counters.bytesReserved = pool.bytesReserved.load(std::memory_order_relaxed);
+	return counters;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <enet/enet.h>
+
+// Size-class pool for ENet's allocations, plugged in through enet_initialize_with_callbacks.
+// Packets are created on worker threads and freed on the network thread, so each thread keeps
+// a small cache per size class and trades whole batches with a shared pool; the system
+// allocator is only asked for new slabs. Blocks over the largest class go straight to malloc.
+class PooledAllocator
+{
+public:
+	struct Counters
+	{
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t cacheMisses = 0;       // Allocations that had to refill from the shared pool
+		uint64_t largeAllocations = 0;  // Over the largest size class
+		uint64_t bytesReserved = 0;     // Slab memory taken from the system
+	};
+
+	static void* allocate(size_t size);
+	static void release(void* memory);
+
+	// malloc/free for enet_initialize_with_callbacks; no_memory keeps ENet's default
+	static ENetCallbacks callbacks();
+
+	static Counters getCounters();
+};
@@ -0,0 +1,431 @@
+#include "SecureChannel.h"
+
+#include <cstring>
+#include <initializer_list>
+
+#include "PacketHeader.h"
+
+// Windows implementation on top of CNG (X25519 ECDH, HMAC-SHA256, AES-256-GCM)
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <bcrypt.h>
+#pragma comment(lib, "bcrypt.lib")
+
+#ifndef NT_SUCCESS
+#define NT_SUCCESS(status) (((NTSTATUS) (status)) >= 0)
+#endif
+
+namespace
+{
+	// Algorithm providers are expensive to open and safe to share between threads
+	struct CryptoProviders
+	{
+		BCRYPT_ALG_HANDLE ecdh = nullptr;
+		BCRYPT_ALG_HANDLE aesGcm = nullptr;
+		BCRYPT_ALG_HANDLE hmacSha256 = nullptr;
+		bool valid = false;
+
+		CryptoProviders()
+		{
+			valid = NT_SUCCESS(BCryptOpenAlgorithmProvider(&ecdh, BCRYPT_ECDH_ALGORITHM, nullptr, 0)) &&
+			        NT_SUCCESS(BCryptSetProperty(ecdh, BCRYPT_ECC_CURVE_NAME, (PUCHAR) BCRYPT_ECC_CURVE_25519, sizeof(BCRYPT_ECC_CURVE_25519), 0)) &&
+			        NT_SUCCESS(BCryptOpenAlgorithmProvider(&aesGcm, BCRYPT_AES_ALGORITHM, nullptr, 0)) &&
+			        NT_SUCCESS(BCryptSetProperty(aesGcm, BCRYPT_CHAINING_MODE, (PUCHAR) BCRYPT_CHAIN_MODE_GCM, sizeof(BCRYPT_CHAIN_MODE_GCM), 0)) &&
+			        NT_SUCCESS(BCryptOpenAlgorithmProvider(&hmacSha256, BCRYPT_SHA256_ALGORITHM, nullptr, BCRYPT_ALG_HANDLE_HMAC_FLAG));
+		}
+
+		~CryptoProviders()
+		{
+			if (ecdh)
+				BCryptCloseAlgorithmProvider(ecdh, 0);
+			if (aesGcm)
+				BCryptCloseAlgorithmProvider(aesGcm, 0);
+			if (hmacSha256)
+				BCryptCloseAlgorithmProvider(hmacSha256, 0);
+		}
+	};
+
+	CryptoProviders& getProviders()
+	{
+		static CryptoProviders providers;
+		return providers;
+	}
+
+	void wipe(void* data, size_t size)
+	{
+		SecureZeroMemory(data, size);
+	}
+
+	bool generateX25519(void*& keyPair, uint8_t* publicKey)
+	{
+		BCRYPT_KEY_HANDLE key = nullptr;
+		if (!NT_SUCCESS(BCryptGenerateKeyPair(getProviders().ecdh, &key, 255, 0)) || !NT_SUCCESS(BCryptFinalizeKeyPair(key, 0)))
+		{
+			if (key)
+				BCryptDestroyKey(key);
+			return false;
+		}
+
+		// Public blob is the header followed by X and an unused Y coordinate
+		uint8_t blob[sizeof(BCRYPT_ECCKEY_BLOB) + 2 * GameProtocol::SECURE_KEY_BYTES];
+		ULONG size = 0;
+		if (!NT_SUCCESS(BCryptExportKey(key, nullptr, BCRYPT_ECCPUBLIC_BLOB, blob, sizeof(blob), &size, 0)) || reinterpret_cast<BCRYPT_ECCKEY_BLOB*>(blob)->cbKey != GameProtocol::SECURE_KEY_BYTES)
+		{
+			BCryptDestroyKey(key);
+			return false;
+		}
+
+		std::memcpy(publicKey, blob + sizeof(BCRYPT_ECCKEY_BLOB), GameProtocol::SECURE_KEY_BYTES);
+		keyPair = key;
+		return true;
+	}
+
+	// Both ends use the same provider, so the raw secret's byte order only has to agree with itself
+	bool agreeX25519(void* keyPair, const uint8_t* peerPublicKey, uint8_t* secret)
+	{
+		uint8_t blob[sizeof(BCRYPT_ECCKEY_BLOB) + 2 * GameProtocol::SECURE_KEY_BYTES] = {};
+		auto* header = reinterpret_cast<BCRYPT_ECCKEY_BLOB*>(blob);
+		header->dwMagic = BCRYPT_ECDH_PUBLIC_GENERIC_MAGIC;
+		header->cbKey = GameProtocol::SECURE_KEY_BYTES;
+		std::memcpy(blob + sizeof(BCRYPT_ECCKEY_BLOB), peerPublicKey, GameProtocol::SECURE_KEY_BYTES);
+
+		BCRYPT_KEY_HANDLE peerKey = nullptr;
+		if (!NT_SUCCESS(BCryptImportKeyPair(getProviders().ecdh, nullptr, BCRYPT_ECCPUBLIC_BLOB, &peerKey, blob, sizeof(blob), 0)))
+		{
+			return false;
+		}
+
+		BCRYPT_SECRET_HANDLE agreed = nullptr;
+		bool success = NT_SUCCESS(BCryptSecretAgreement(static_cast<BCRYPT_KEY_HANDLE>(keyPair), peerKey, &agreed, 0));
+
+		ULONG size = 0;
+		success = success && NT_SUCCESS(BCryptDeriveKey(agreed, BCRYPT_KDF_RAW_SECRET, nullptr, secret, GameProtocol::SECURE_KEY_BYTES, &size, 0)) && size == GameProtocol::SECURE_KEY_BYTES;
+
+		if (agreed)
+			BCryptDestroySecret(agreed);
+		BCryptDestroyKey(peerKey);
+		return success;
+	}
+
+	bool hmacSha256(std::span<const uint8_t> key, std::initializer_list<std::span<const uint8_t>> parts, uint8_t* out)
+	{
+		BCRYPT_HASH_HANDLE hash = nullptr;
+		if (!NT_SUCCESS(BCryptCreateHash(getProviders().hmacSha256, &hash, nullptr, 0, const_cast<PUCHAR>(key.data()), static_cast<ULONG>(key.size()), 0)))
+		{
+			return false;
+		}
+
+		bool success = true;
+		for (const auto& part: parts)
+		{
+			success = success && NT_SUCCESS(BCryptHashData(hash, const_cast<PUCHAR>(part.data()), static_cast<ULONG>(part.size()), 0));
+		}
+		success = success && NT_SUCCESS(BCryptFinishHash(hash, out, 32, 0));
+
+		BCryptDestroyHash(hash);
+		return success;
+	}
+
+	bool createAeadKey(const uint8_t* keyBytes, void*& key)
+	{
+		BCRYPT_KEY_HANDLE handle = nullptr;
+		if (!NT_SUCCESS(BCryptGenerateSymmetricKey(getProviders().aesGcm, &handle, nullptr, 0, const_cast<PUCHAR>(keyBytes), GameProtocol::SECURE_KEY_BYTES, 0)))
+		{
+			return false;
+		}
+		key = handle;
+		return true;
+	}
+
+	void destroyKey(void*& key)
+	{
+		if (key)
+		{
+			BCryptDestroyKey(static_cast<BCRYPT_KEY_HANDLE>(key));
+			key = nullptr;
+		}
+	}
+
+	bool aeadSeal(void* key, uint8_t* nonce, std::span<const uint8_t> associatedData, std::span<const uint8_t> plaintext, uint8_t* ciphertext, uint8_t* tag)
+	{
+		BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO info;
+		BCRYPT_INIT_AUTH_MODE_INFO(info);
+		info.pbNonce = nonce;
+		info.cbNonce = 12;
+		info.pbAuthData = const_cast<PUCHAR>(associatedData.data());
+		info.cbAuthData = static_cast<ULONG>(associatedData.size());
+		info.pbTag = tag;
+		info.cbTag = GameProtocol::SECURE_TAG_BYTES;
+
+		ULONG written = 0;
+		return NT_SUCCESS(BCryptEncrypt(static_cast<BCRYPT_KEY_HANDLE>(key), const_cast<PUCHAR>(plaintext.data()), static_cast<ULONG>(plaintext.size()), &info, nullptr, 0, ciphertext, static_cast<ULONG>(plaintext.size()), &written, 0));
+	}
+
+	bool aeadOpen(void* key, uint8_t* nonce, std::span<const uint8_t> associatedData, std::span<const uint8_t> ciphertext, const uint8_t* tag, uint8_t* plaintext)
+	{
+		BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO info;
+		BCRYPT_INIT_AUTH_MODE_INFO(info);
+		info.pbNonce = nonce;
+		info.cbNonce = 12;
+		info.pbAuthData = const_cast<PUCHAR>(associatedData.data());
+		info.cbAuthData = static_cast<ULONG>(associatedData.size());
+		info.pbTag = const_cast<PUCHAR>(tag);
+		info.cbTag = GameProtocol::SECURE_TAG_BYTES;
+
+		ULONG written = 0;
+		return NT_SUCCESS(BCryptDecrypt(static_cast<BCRYPT_KEY_HANDLE>(key), const_cast<PUCHAR>(ciphertext.data()), static_cast<ULONG>(ciphertext.size()), &info, nullptr, 0, plaintext, static_cast<ULONG>(ciphertext.size()), &written, 0));
+	}
+
+	bool providersAvailable()
+	{
+		return getProviders().valid;
+	}
+} // namespace
+
+#else
+
+// No crypto provider on other platforms, channels are never established and traffic stays plaintext
+namespace
+{
+	void wipe(void* data, size_t size)
+	{
+		volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+		while (size--)
+			*bytes++ = 0;
+	}
+
+	bool generateX25519(void*&, uint8_t*)
+	{
+		return false;
+	}
+
+	bool agreeX25519(void*, const uint8_t*, uint8_t*)
+	{
+		return false;
+	}
+
+	bool hmacSha256(std::span<const uint8_t>, std::initializer_list<std::span<const uint8_t>>, uint8_t*)
+	{
+		return false;
+	}
+
+	bool createAeadKey(const uint8_t*, void*&)
+	{
+		return false;
+	}
+
+	void destroyKey(void*& key)
+	{
+		key = nullptr;
+	}
+
+	bool aeadSeal(void*, uint8_t*, std::span<const uint8_t>, std::span<const uint8_t>, uint8_t*, uint8_t*)
+	{
+		return false;
+	}
+
+	bool aeadOpen(void*, uint8_t*, std::span<const uint8_t>, std::span<const uint8_t>, const uint8_t*, uint8_t*)
+	{
+		return false;
+	}
+
+	bool providersAvailable()
+	{
+		return false;
+	}
+} // namespace
+
+#endif
+
+namespace
+{
+	std::span<const uint8_t> asBytes(const char* text)
+	{
+		return { reinterpret_cast<const uint8_t*>(text), std::strlen(text) };
+	}
+
+	// 96-bit GCM nonce: 4-byte per-direction salt followed by the 64-bit little-endian sequence (lane bits included)
+	void buildNonce(const std::array<uint8_t, 4>& salt, uint32_t sequence, uint8_t* nonce)
+	{
+		const uint64_t counter = sequence;
+		std::memcpy(nonce, salt.data(), salt.size());
+		std::memcpy(nonce + salt.size(), &counter, sizeof(counter));
+	}
+} // namespace
+
+namespace GameProtocol
+{
+
+	SecureChannel::SecureChannel(Role role)
+	      : role(role)
+	{
+	}
+
+	SecureChannel::~SecureChannel()
+	{
+		destroyKey(keyPair);
+		destroyKey(sendKey);
+		destroyKey(receiveKey);
+	}
+
+	bool SecureChannel::isAvailable()
+	{
+		return providersAvailable();
+	}
+
+	bool SecureChannel::generateKeyPair()
+	{
+		if (!providersAvailable() || keyPair || established)
+		{
+			return false;
+		}
+
+		return generateX25519(keyPair, publicKey.data());
+	}
+
+	bool SecureChannel::establish(std::span<const uint8_t> peerPublicKey)
+	{
+		if (!keyPair || established || peerPublicKey.size() != SECURE_KEY_BYTES)
+		{
+			return false;
+		}
+
+		uint8_t secret[SECURE_KEY_BYTES];
+		bool success = agreeX25519(keyPair, peerPublicKey.data(), secret);
+		destroyKey(keyPair);
+
+		// A low-order peer key yields an all-zero secret
+		uint8_t nonZero = 0;
+		for (uint8_t byte: secret)
+			nonZero |= byte;
+		success = success && nonZero != 0;
+
+		// Bind the keys to both public keys, client first
+		std::span<const uint8_t> clientKey = role == Role::Client ? std::span<const uint8_t>(publicKey) : peerPublicKey;
+		std::span<const uint8_t> serverKey = role == Role::Client ? peerPublicKey : std::span<const uint8_t>(publicKey);
+
+		uint8_t prk[32];
+		uint8_t clientToServer[32], serverToClient[32], clientToServerSalt[32], serverToClientSalt[32];
+		success = success && hmacSha256(asBytes("EnetPlayGround secure channel v1"), { std::span<const uint8_t>(secret), clientKey, serverKey }, prk);
+		success = success && hmacSha256(prk, { asBytes("c2s key") }, clientToServer);
+		success = success && hmacSha256(prk, { asBytes("s2c key") }, serverToClient);
+		success = success && hmacSha256(prk, { asBytes("c2s nonce") }, clientToServerSalt);
+		success = success && hmacSha256(prk, { asBytes("s2c nonce") }, serverToClientSalt);
+
+		const bool isClient = role == Role::Client;
+		success = success && createAeadKey(isClient ? clientToServer : serverToClient, sendKey);
+		success = success && createAeadKey(isClient ? serverToClient : clientToServer, receiveKey);
+		std::memcpy(sendSalt.data(), isClient ? clientToServerSalt : serverToClientSalt, sendSalt.size());
+		std::memcpy(receiveSalt.data(), isClient ? serverToClientSalt : clientToServerSalt, receiveSalt.size());
+
+		wipe(secret, sizeof(secret));
+		wipe(prk, sizeof(prk));
+		wipe(clientToServer, sizeof(clientToServer));
+		wipe(serverToClient, sizeof(serverToClient));
+
+		if (!success)
+		{
+			destroyKey(sendKey);
+			destroyKey(receiveKey);
+			return false;
+		}
+
+		established = true;
+		return true;
+	}
+
+	bool SecureChannel::seal(std::span<const uint8_t> plaintext, std::vector<uint8_t>& sealed, Channel channel, bool reliable)
+	{
+		const uint32_t lane = (static_cast<uint32_t>(channel) << 1) | (reliable ? 1u : 0u);
+		if (lane >= LANE_COUNT)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(sendMutex);
+
+		// Never reuse a nonce; the connection has to be re-established after 2^30 packets on a lane
+		uint32_t& sendSequence = sendSequences[lane];
+		if (!established || sendSequence == LANE_SEQUENCE_MASK)
+		{
+			return false;
+		}
+
+		const uint32_t sequence = (lane << (32 - LANE_BITS)) | ++sendSequence;
+		PacketHeader header(PacketType::Encrypted, plaintext.size() + SECURE_TAG_BYTES, sequence);
+
+		sealed.resize(sizeof(PacketHeader) + plaintext.size() + SECURE_TAG_BYTES);
+		std::memcpy(sealed.data(), &header, sizeof(header));
+
+		uint8_t nonce[12];
+		buildNonce(sendSalt, sequence, nonce);
+
+		uint8_t* ciphertext = sealed.data() + sizeof(PacketHeader);
+		if (!aeadSeal(sendKey, nonce, std::span<const uint8_t>(sealed.data(), sizeof(PacketHeader)), plaintext, ciphertext, ciphertext + plaintext.size()))
+		{
+			return false;
+		}
+
+		sealedCount++;
+		return true;
+	}
+
+	bool SecureChannel::open(std::span<const uint8_t> sealed, std::vector<uint8_t>& plaintext)
+	{
+		if (sealed.size() < sizeof(PacketHeader) + SECURE_TAG_BYTES)
+		{
+			rejectedCount++;
+			return false;
+		}
+
+		PacketHeader header;
+		std::memcpy(&header, sealed.data(), sizeof(header));
+		if (!header.isValid() || header.type != PacketType::Encrypted || header.length != sealed.size() - sizeof(PacketHeader) || (header.sequence & LANE_SEQUENCE_MASK) == 0)
+		{
+			rejectedCount++;
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(receiveMutex);
+
+		// Replay check before spending time on decryption; the lane is covered by the tag, so it cannot be moved
+		ReceiveLane& lane = receiveLanes[header.sequence >> (32 - LANE_BITS)];
+		const uint32_t sequence = header.sequence & LANE_SEQUENCE_MASK;
+		if (!established || (sequence <= lane.highestReceived && (lane.highestReceived - sequence >= REPLAY_WINDOW || (lane.receivedWindow >> (lane.highestReceived - sequence)) & 1)))
+		{
+			rejectedCount++;
+			return false;
+		}
+
+		uint8_t nonce[12];
+		buildNonce(receiveSalt, header.sequence, nonce);
+
+		const size_t ciphertextSize = header.length - SECURE_TAG_BYTES;
+		std::span<const uint8_t> ciphertext = sealed.subspan(sizeof(PacketHeader), ciphertextSize);
+		plaintext.resize(ciphertextSize);
+		if (!aeadOpen(receiveKey, nonce, sealed.first(sizeof(PacketHeader)), ciphertext, sealed.data() + sizeof(PacketHeader) + ciphertextSize, plaintext.data()))
+		{
+			plaintext.clear();
+			rejectedCount++;
+			return false;
+		}
+
+		// Only authenticated packets move the window
+		if (sequence > lane.highestReceived)
+		{
+			const uint32_t shift = sequence - lane.highestReceived;
+			lane.receivedWindow = shift >= REPLAY_WINDOW ? 0 : lane.receivedWindow << shift;
+			lane.receivedWindow |= 1;
+			lane.highestReceived = sequence;
+		}
+		else
+		{
+			lane.receivedWindow |= 1ull << (lane.highestReceived - sequence);
+		}
+
+		openedCount++;
+		return true;
+	}
+
+} // namespace GameProtocol
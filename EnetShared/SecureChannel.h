@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "PacketHeader.h"
+
+namespace GameProtocol
+{
+
+	inline constexpr size_t SECURE_KEY_BYTES = 32;
+	inline constexpr size_t SECURE_TAG_BYTES = 16;
+
+	// Per-connection encrypted channel: X25519 key exchange, then AES-256-GCM per packet.
+	// Sealed packets are an Encrypted PacketHeader (used as associated data) whose sequence is the nonce counter,
+	// followed by the encrypted inner packet and the tag. Each direction has its own key and nonce salt.
+	// Every (channel, reliable) lane numbers its packets on its own, with the lane in the top bits of the
+	// sequence, so a retransmitted reliable packet is never pushed out of the replay window by unreliable traffic.
+	class SecureChannel
+	{
+	public:
+		enum class Role : uint8_t
+		{
+			Client,
+			Server
+		};
+
+		explicit SecureChannel(Role role);
+		~SecureChannel();
+
+		SecureChannel(const SecureChannel&) = delete;
+		SecureChannel& operator=(const SecureChannel&) = delete;
+
+		// Generate our ephemeral key pair; false if the platform crypto provider is unavailable
+		bool generateKeyPair();
+
+		const std::array<uint8_t, SECURE_KEY_BYTES>& getPublicKey() const
+		{
+			return publicKey;
+		}
+
+		// Derive the session keys from the peer's public key and discard our private key
+		bool establish(std::span<const uint8_t> peerPublicKey);
+
+		bool isEstablished() const
+		{
+			return established;
+		}
+
+		// Wrap a serialized packet into an Encrypted packet for the ENet channel and reliability it will be sent with
+		bool seal(std::span<const uint8_t> plaintext, std::vector<uint8_t>& sealed, Channel channel, bool reliable);
+
+		// Unwrap an Encrypted packet, rejecting forged, replayed or too old packets
+		bool open(std::span<const uint8_t> sealed, std::vector<uint8_t>& plaintext);
+
+		uint64_t getSealedCount() const
+		{
+			return sealedCount;
+		}
+
+		uint64_t getOpenedCount() const
+		{
+			return openedCount;
+		}
+
+		uint64_t getRejectedCount() const
+		{
+			return rejectedCount;
+		}
+
+		// Whether this build and OS can provide secure channels at all
+		static bool isAvailable();
+
+	private:
+		// Sliding window of recently accepted sequences for replay protection, per lane
+		static constexpr uint32_t REPLAY_WINDOW = 64;
+
+		// Top bits of the sequence carry the lane, the rest count packets within it
+		static constexpr uint32_t LANE_BITS = 2;
+		static constexpr size_t LANE_COUNT = size_t(1) << LANE_BITS;
+		static constexpr uint32_t LANE_SEQUENCE_MASK = UINT32_MAX >> LANE_BITS;
+
+		struct ReceiveLane
+		{
+			uint32_t highestReceived = 0;
+			uint64_t receivedWindow = 0;
+		};
+
+		Role role;
+		bool established = false;
+		std::array<uint8_t, SECURE_KEY_BYTES> publicKey{};
+
+		// Platform key handles (kept opaque so callers don't pull in the crypto headers)
+		void* keyPair = nullptr;
+		void* sendKey = nullptr;
+		void* receiveKey = nullptr;
+
+		std::mutex sendMutex;
+		std::array<uint8_t, 4> sendSalt{};
+		std::array<uint32_t, LANE_COUNT> sendSequences{};
+
+		std::mutex receiveMutex;
+		std::array<uint8_t, 4> receiveSalt{};
+		std::array<ReceiveLane, LANE_COUNT> receiveLanes{};
+
+		std::atomic<uint64_t> sealedCount{ 0 };
+		std::atomic<uint64_t> openedCount{ 0 };
+		std::atomic<uint64_t> rejectedCount{ 0 };
+	};
+
+} // namespace GameProtocol
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+/**
+ * Bounded lock-free FIFO for exactly one producer thread and one consumer thread.
+ * Capacity is rounded up to a power of two; each side caches the other's index so
+ * the shared atomics are only re-read when the queue looks full or empty.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue(size_t capacity)
+	      : mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), slots(std::make_unique<T[]>(mask + 1))
+	{
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer only; returns false and leaves value untouched if the queue is full
+	bool tryPush(T&& value)
+	{
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (tail - cachedHead > mask)
+		{
+			cachedHead = headIndex.load(std::memory_order_acquire);
+			if (tail - cachedHead > mask)
+			{
+				return false;
+			}
+		}
+
+		slots[tail & mask] = std::move(value);
+		tailIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only; returns false if the queue is empty
+	bool tryPop(T& value)
+	{
+		const size_t head = headIndex.load(std::memory_order_relaxed);
+		if (head == cachedTail)
+		{
+			cachedTail = tailIndex.load(std::memory_order_acquire);
+			if (head == cachedTail)
+			{
+				return false;
+			}
+		}
+
+		value = std::move(slots[head & mask]);
+		headIndex.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Producer only; lets the producer apply backpressure instead of dropping
+	bool isFull()
+	{
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (tail - cachedHead > mask)
+		{
+			cachedHead = headIndex.load(std::memory_order_acquire);
+		}
+		return tail - cachedHead > mask;
+	}
+
+	// Approximate when called while the other side is active
+	size_t size() const
+	{
+		return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const
+	{
+		return mask + 1;
+	}
+
+private:
+	// Consumer-owned line
+	alignas(64) std::atomic<size_t> headIndex{ 0 };
+	size_t cachedTail = 0;
+
+	// Producer-owned line
+	alignas(64) std::atomic<size_t> tailIndex{ 0 };
+	size_t cachedHead = 0;
+
+	alignas(64) const size_t mask;
+	std::unique_ptr<T[]> slots;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <cmath>
 #include <set>
+#include <vector>
 
 struct Position
 {
@@ -58,11 +59,12 @@ struct Player
 	uint32_t totalBytesReceived;
 	uint32_t totalBytesSent;
 	uint32_t pingMs;
+	float packetLossPercent;
 	bool isAuthenticated;
 	bool isAdmin;
 	std::string ipAddress;
-	std::set<uint32_t> visiblePlayers; // IDs of players currently visible to this player
-	uint32_t lastPositionUpdateTime;   // Time of the last position update received
+	std::vector<uint32_t> visiblePlayers; // Ascending IDs of players currently visible to this player
+	uint32_t lastPositionUpdateTime;      // Time of the last position update received
 };
 
 // Chat message
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+/**
+ * Coroutine for work on the ThreadManager pool. A task is lazy: it starts when another task
+ * co_awaits it or when it is handed to ThreadManager::spawn, and when it finishes it resumes
+ * whoever awaited it on the same thread. Exceptions are rethrown in the awaiting coroutine.
+ * Coroutine parameters outlive the caller, so take them by value, never by reference.
+ */
+template<typename T = void>
+class Task;
+
+namespace TaskDetail
+{
+	// Hands the thread straight to the awaiting coroutine, if any, when a task finishes
+	struct FinalAwaiter
+	{
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		template<typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+		{
+			if (auto continuation = handle.promise().continuation)
+				return continuation;
+			return std::noop_coroutine();
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	struct PromiseBase
+	{
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		FinalAwaiter final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		void unhandled_exception() noexcept
+		{
+			exception = std::current_exception();
+		}
+
+		void rethrowIfFailed()
+		{
+			if (exception)
+				std::rethrow_exception(exception);
+		}
+	};
+
+	template<typename T>
+	struct Promise : PromiseBase
+	{
+		std::optional<T> value;
+
+		template<typename U>
+		void return_value(U&& result)
+		{
+			value.emplace(std::forward<U>(result));
+		}
+
+		T takeResult()
+		{
+			rethrowIfFailed();
+			return std::move(*value);
+		}
+	};
+
+	template<>
+	struct Promise<void> : PromiseBase
+	{
+		void return_void() noexcept
+		{
+		}
+
+		void takeResult()
+		{
+			rethrowIfFailed();
+		}
+	};
+
+	// Fire-and-forget wrapper used by ThreadManager::spawn; frees itself when done
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object()
+			{
+				return DetachedTask{ std::coroutine_handle<promise_type>::from_promise(*this) };
+			}
+
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void return_void() noexcept
+			{
+			}
+
+			void unhandled_exception() noexcept
+			{
+				// Nobody is left to report to; same as a detached pool task
+			}
+		};
+
+		std::coroutine_handle<promise_type> handle;
+	};
+} // namespace TaskDetail
+
+template<typename T>
+class Task
+{
+public:
+	struct promise_type : TaskDetail::Promise<T>
+	{
+		Task get_return_object()
+		{
+			return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+	};
+
+	Task(Task&& other) noexcept
+	      : handle(std::exchange(other.handle, {}))
+	{
+	}
+
+	Task& operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle)
+				handle.destroy();
+			handle = std::exchange(other.handle, {});
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task()
+	{
+		if (handle)
+			handle.destroy();
+	}
+
+	// Start the task and suspend until it finishes
+	auto operator co_await() noexcept
+	{
+		struct Awaiter
+		{
+			std::coroutine_handle<promise_type> handle;
+
+			bool await_ready() const noexcept
+			{
+				return handle.done();
+			}
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+			{
+				handle.promise().continuation = awaiting;
+				return handle;
+			}
+
+			T await_resume()
+			{
+				return handle.promise().takeResult();
+			}
+		};
+
+		return Awaiter{ handle };
+	}
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> handle)
+	      : handle(handle)
+	{
+	}
+
+	std::coroutine_handle<promise_type> handle;
+};
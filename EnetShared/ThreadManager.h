@@ -6,6 +6,7 @@
 #include <any>
 #include <atomic>
 #include <chrono>
+#include <coroutine>
 #include <functional>
 #include <future>
 #include <memory>
@@ -19,6 +20,7 @@
 #include <vector>
 #include <Windows.h>
 
+#include "Task.h"
 #include "ThreadPool/thread_pool.h"
 
 /**
@@ -86,6 +88,19 @@ public:
 		return numThreads;
 	}
 
+	/**
+     * Get the number of tasks waiting for a worker thread
+     * @return Queued task count (always 0 in debug mode)
+     */
+	size_t getQueuedTaskCount() const
+	{
+#ifndef THREAD_MANAGER_DEBUG
+		return pool.queued_tasks();
+#else
+		return 0;
+#endif
+	}
+
 	/**
      * Schedule a task without caring about the result
      * @param func The function to execute
@@ -727,6 +742,192 @@ public:
 		return future;
 	}
 
+	/**
+     * Run body(first, last) over [begin, end) in chunks of about grain items spread over the pool
+     * The calling thread works through chunks as well and then only waits for chunks already running
+     * elsewhere, so this is safe to call from a worker even when every other worker is busy
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Items per chunk; a range that fits in one chunk runs inline
+     * @param body Called once per chunk, possibly on several threads at once
+     */
+	template<typename Func>
+	void parallelFor(size_t begin, size_t end, size_t grain, Func&& body)
+	{
+		if (end <= begin)
+			return;
+
+		grain = (std::max)(grain, size_t(1));
+		const size_t chunkCount = (end - begin + grain - 1) / grain;
+
+#ifndef THREAD_MANAGER_DEBUG
+		if (chunkCount > 1 && numThreads > 0)
+		{
+			auto state = std::make_shared<ForkJoinState>(chunkCount);
+
+			// Helpers that start after the last chunk is claimed touch nothing but the shared state
+			auto runChunks = [state, begin, end, grain, &body]()
+			{
+				size_t chunk;
+				while ((chunk = state->next.fetch_add(1)) < state->chunkCount)
+				{
+					const size_t first = begin + chunk * grain;
+					try
+					{
+						body(first, (std::min)(first + grain, end));
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(state->errorMutex);
+						if (!state->error)
+							state->error = std::current_exception();
+					}
+
+					if (state->remaining.fetch_sub(1) == 1)
+						state->remaining.notify_all();
+				}
+			};
+
+			const size_t helpers = (std::min)(chunkCount - 1, numThreads);
+			for (size_t i = 0; i < helpers; i++)
+			{
+				pool.enqueue_detach(runChunks);
+			}
+
+			runChunks();
+
+			size_t left;
+			while ((left = state->remaining.load()) != 0)
+			{
+				state->remaining.wait(left);
+			}
+
+			// Update stats
+			{
+				std::lock_guard<std::mutex> lock(statsMutex);
+				tasksSubmitted += helpers;
+			}
+
+			std::exception_ptr error;
+			{
+				std::lock_guard<std::mutex> lock(state->errorMutex);
+				error = std::move(state->error);
+			}
+			if (error)
+				std::rethrow_exception(error);
+			return;
+		}
+#endif
+
+		// One chunk, or debug mode: run every chunk here
+		for (size_t first = begin; first < end; first += grain)
+		{
+			body(first, (std::min)(first + grain, end));
+		}
+	}
+
+	/**
+     * Map each chunk of [begin, end) to a value in parallel, then fold the values in index order
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Items per chunk
+     * @param identity Starting value, also the value of an empty range
+     * @param map Called as map(first, last) for each chunk, returns its partial result
+     * @param combine Called as combine(accumulated, partial) on the calling thread
+     * @return The combined result
+     */
+	template<typename T, typename Map, typename Combine>
+	T parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map&& map, Combine&& combine)
+	{
+		if (end <= begin)
+			return identity;
+
+		grain = (std::max)(grain, size_t(1));
+		std::vector<T> partials((end - begin + grain - 1) / grain, identity);
+		parallelFor(begin, end, grain, [&](size_t first, size_t last) { partials[(first - begin) / grain] = map(first, last); });
+
+		T result = std::move(identity);
+		for (auto& partial: partials)
+		{
+			result = combine(std::move(result), std::move(partial));
+		}
+		return result;
+	}
+
+	/**
+     * Start a coroutine on a worker thread and let it run to completion on its own
+     * Exceptions it throws are dropped, as with scheduleTask
+     * @param task The coroutine to run
+     */
+	template<typename T>
+	void spawn(Task<T> task)
+	{
+		auto detached = runDetached(std::move(task));
+		scheduleTask([handle = detached.handle]() { handle.resume(); });
+	}
+
+	/**
+     * Awaitable that continues the coroutine on a worker thread, e.g. to let go of resources
+     * acquired earlier before sending packets
+     */
+	auto schedule()
+	{
+		struct Awaiter
+		{
+			ThreadManager& manager;
+
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				manager.scheduleTask([handle]() { handle.resume(); });
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		return Awaiter{ *this };
+	}
+
+	/**
+     * Awaitable that continues the coroutine on a worker holding exclusive locks on the resources,
+     * without tying up a thread while it waits in the queue. The locks are released the next time the
+     * coroutine suspends (any co_await), or if it finishes first, when the coroutine awaiting it does,
+     * so acquire again after every co_await that needs them
+     * @param resources List of resource identifiers this coroutine will access
+     */
+	auto acquire(std::vector<ResourceId> resources)
+	{
+		return ResourceAwaiter<false>{ *this, std::move(resources) };
+	}
+
+	// Resources as separate arguments; GCC 12 rejects a braced list inside a co_await expression
+	template<typename... Rest>
+	auto acquire(const ResourceId& first, const Rest&... rest)
+	{
+		return acquire(std::vector<ResourceId>{ first, rest... });
+	}
+
+	/**
+     * Same as acquire, with shared locks for reading
+     * @param resources List of resource identifiers this coroutine will read
+     */
+	auto acquireRead(std::vector<ResourceId> resources)
+	{
+		return ResourceAwaiter<true>{ *this, std::move(resources) };
+	}
+
+	template<typename... Rest>
+	auto acquireRead(const ResourceId& first, const Rest&... rest)
+	{
+		return acquireRead(std::vector<ResourceId>{ first, rest... });
+	}
+
 	/**
      * Wait for all currently submitted tasks to complete
      */
@@ -777,6 +978,53 @@ public:
 	}
 
 private:
+	// Chunks of one parallelFor call; shared with helper tasks that may outlive the call
+	struct ForkJoinState
+	{
+		explicit ForkJoinState(size_t chunkCount)
+		      : chunkCount(chunkCount), remaining(chunkCount)
+		{
+		}
+
+		const size_t chunkCount;
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> remaining; // Chunks not yet finished
+		std::mutex errorMutex;
+		std::exception_ptr error;
+	};
+
+	// Resumes the coroutine from inside a resource or read task, which holds the locks until it suspends again
+	template<bool Shared>
+	struct ResourceAwaiter
+	{
+		ThreadManager& manager;
+		std::vector<ResourceId> resources;
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			// The coroutine may resume on another worker before this returns, don't touch members afterwards
+			if constexpr (Shared)
+				manager.scheduleReadTask(resources, [handle]() { handle.resume(); });
+			else
+				manager.scheduleResourceTask(resources, [handle]() { handle.resume(); });
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	template<typename T>
+	static TaskDetail::DetachedTask runDetached(Task<T> task)
+	{
+		co_await task;
+	}
+
 #ifndef THREAD_MANAGER_DEBUG
 	dp::thread_pool<> pool;
 #endif
@@ -236,6 +236,14 @@ namespace dp {
          */
         [[nodiscard]] auto size() const { return threads_.size(); }
 
+        /**
+         * @brief Returns the number of tasks waiting for a thread (approximate under contention).
+         */
+        [[nodiscard]] std::size_t queued_tasks() const {
+            const auto queued = unassigned_tasks_.load(std::memory_order_relaxed);
+            return queued > 0 ? static_cast<std::size_t>(queued) : 0;
+        }
+
         /**
          * @brief Wait for all tasks to finish.
          * @details This function will block until all tasks have been completed.
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free handoff of the latest value from one writer to one reader.
+ * The writer fills back() and calls publish(); the reader calls acquire() and may use the
+ * returned buffer until its next acquire(). Neither side ever waits or copies; intermediate
+ * values the reader never picked up are simply overwritten.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+	// Writer only; contents are whatever this buffer held two publishes ago, so refill it completely
+	T& back()
+	{
+		return buffers[backIndex];
+	}
+
+	// Writer only; make the back buffer the newest value
+	void publish()
+	{
+		const uint8_t previous = middle.exchange(static_cast<uint8_t>(backIndex | FRESH), std::memory_order_acq_rel);
+		backIndex = previous & INDEX_MASK;
+	}
+
+	// Reader only; newest published value, stays valid until the next call
+	const T& acquire()
+	{
+		if (middle.load(std::memory_order_relaxed) & FRESH)
+		{
+			const uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+			frontIndex = previous & INDEX_MASK;
+		}
+		return buffers[frontIndex];
+	}
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	static constexpr uint8_t FRESH = 0x4;
+
+	std::array<T, 3> buffers{};
+	std::atomic<uint8_t> middle{ 1 };
+	uint8_t backIndex = 0;  // Writer side
+	uint8_t frontIndex = 2; // Reader side
+};